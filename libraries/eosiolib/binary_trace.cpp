@@ -0,0 +1,39 @@
+#include <eosio/binary_trace.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/system.hpp>
+#include <eosio/varint.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// Backing store of the binary smart contract trace format. This object is only linked into
+// contracts built with `--smart-contract-trace-format=binary`, through the reference to
+// binary_trace_state that every recorded checkpoint makes; the dispatcher reaches the flush
+// through a weak reference.
+namespace eosio { namespace internal_use_do_not_use {
+
+   binary_trace_buffer binary_trace_state;
+
+}} // namespace eosio::internal_use_do_not_use
+
+extern "C" void eosio_binary_trace_flush() {
+   using namespace eosio::internal_use_do_not_use;
+   auto& state = binary_trace_state;
+   if (!state.total)
+      return;
+
+   const uint32_t count = std::min(state.total, binary_trace_buffer::capacity);
+   const uint32_t first = state.total - count;
+   std::vector<char> data(4 + 5 + count * (5 + 8));
+   eosio::datastream<char*> ds(data.data(), data.size());
+   ds << first << eosio::unsigned_int{count};
+   for (uint32_t i = first; i < state.total; ++i) {
+      const auto& rec = state.records[i % binary_trace_buffer::capacity];
+      ds << eosio::unsigned_int{rec.tag};
+      if (rec.tag & 7)
+         ds << rec.value;
+   }
+   data.resize(ds.tellp());
+   state.total = 0;
+   eosio::push_event("cdt.trace", data);
+}
@@ -0,0 +1,984 @@
+#include <eosio/chaindb.hpp>
+#include <eosio/check.hpp>
+#include <eosio/intrinsic_stats.hpp>
+#include <eosio/kv_base.hpp>
+#include <eosio/multi_index.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+extern "C" void eosio_set_contract_name(uint64_t n);
+
+namespace eosio { namespace chaindb {
+
+namespace {
+
+   using key256 = std::array<uint128_t, 2>;
+
+   struct table_info {
+      uint64_t                                 id;
+      std::tuple<uint64_t, uint64_t, uint64_t> key; // code, scope, table
+      uint64_t                                 payer;
+      uint32_t                                 count = 0;
+   };
+
+   struct row {
+      uint64_t          payer;
+      std::vector<char> value;
+   };
+
+   using rows_t = std::map<std::pair<uint64_t, uint64_t>, row>; // (table id, primary key)
+
+   // Iterator handles of one index for the current action. As on chain, handles of rows are
+   // small non-negative integers, -1 means "no such table" and the end iterator of the n-th table
+   // seen by the action is -(n + 2).
+   template <typename Iter>
+   struct iterator_cache {
+      std::vector<uint64_t>            tables;
+      std::map<uint64_t, int32_t>      table_to_end;
+      std::vector<std::optional<Iter>> objects;
+      std::map<const void*, int32_t>   object_to_iterator;
+
+      int32_t cache_table( uint64_t table_id ) {
+         auto [it, inserted] = table_to_end.try_emplace( table_id, -int32_t(tables.size()) - 2 );
+         if ( inserted )
+            tables.push_back( table_id );
+         return it->second;
+      }
+
+      uint64_t end_table( int32_t end ) const {
+         int64_t index = -int64_t(end) - 2;
+         check( index >= 0 && index < int64_t(tables.size()), "not a valid end iterator" );
+         return tables[index];
+      }
+
+      int32_t add( Iter obj ) {
+         auto [it, inserted] = object_to_iterator.try_emplace( &*obj, int32_t(objects.size()) );
+         if ( inserted )
+            objects.push_back( obj );
+         return it->second;
+      }
+
+      Iter get( int32_t itr ) const {
+         check( itr != -1, "invalid iterator" );
+         check( itr >= 0, "dereference of end iterator" );
+         check( size_t(itr) < objects.size(), "iterator out of range" );
+         check( objects[itr].has_value(), "dereference of deleted object" );
+         return *objects[itr];
+      }
+
+      void remove( int32_t itr ) {
+         object_to_iterator.erase( &*get( itr ) );
+         objects[itr].reset();
+      }
+
+      // points `itr` at `obj`, which replaced the object it referred to
+      void replace( int32_t itr, Iter obj ) {
+         object_to_iterator.erase( &*get( itr ) );
+         object_to_iterator[&*obj] = itr;
+         objects[itr] = obj;
+      }
+
+      void clear() {
+         tables.clear();
+         table_to_end.clear();
+         objects.clear();
+         object_to_iterator.clear();
+      }
+   };
+
+   // orders secondary entries by (table id, secondary key, primary key) and allows searching by
+   // table id alone to find the boundaries of a table
+   template <typename Key>
+   struct secondary_less {
+      using is_transparent = void;
+      using entry          = std::tuple<uint64_t, Key, uint64_t>;
+
+      bool operator()( const entry& a, const entry& b ) const { return a < b; }
+      bool operator()( const entry& a, uint64_t table ) const { return std::get<0>( a ) < table; }
+      bool operator()( uint64_t table, const entry& b ) const { return table < std::get<0>( b ); }
+   };
+
+   template <typename Key>
+   struct secondary_index {
+      using entries_t = std::map<std::tuple<uint64_t, Key, uint64_t>, uint64_t, secondary_less<Key>>; // -> payer
+
+      entries_t                                      entries;
+      std::map<std::pair<uint64_t, uint64_t>, Key>   by_primary;
+      iterator_cache<typename entries_t::iterator>   cache;
+   };
+
+   struct kv_row {
+      std::string value;
+      uint64_t    payer;
+      uint64_t    id; // distinguishes a re-created key from the row an iterator pointed to
+   };
+
+   using kv_rows_t = std::map<std::pair<uint64_t, std::string>, kv_row>; // (contract, key)
+
+   enum kv_it_stat : int32_t { iterator_ok = 0, iterator_erased = -1, iterator_end = -2 };
+
+   struct kv_iterator {
+      uint64_t    contract;
+      std::string prefix;
+      bool        at_end = true;
+      std::string key;
+      uint64_t    id = 0;
+   };
+
+   struct database {
+      uint64_t receiver = 0;
+
+      std::map<std::tuple<uint64_t, uint64_t, uint64_t>, uint64_t> table_ids;
+      std::map<uint64_t, table_info>                               tables;
+      uint64_t                                                     next_table_id = 0;
+
+      rows_t                                 rows;
+      iterator_cache<rows_t::iterator>       primary;
+      secondary_index<uint64_t>              idx64;
+      secondary_index<uint128_t>             idx128;
+      secondary_index<key256>                idx256;
+      secondary_index<double>                idx_double;
+      secondary_index<long double>           idx_long_double;
+
+      kv_rows_t                              kv_rows;
+      uint64_t                               next_kv_id = 0;
+      std::string                            kv_temp;
+      std::vector<std::optional<kv_iterator>> kv_iterators;
+
+      // inverse operations of the writes made since the outermost open session, newest last
+      std::vector<std::function<void()>> undo;
+      std::vector<size_t>                sessions;
+
+      void clear_iterators() {
+         primary.clear();
+         idx64.cache.clear();
+         idx128.cache.clear();
+         idx256.cache.clear();
+         idx_double.cache.clear();
+         idx_long_double.cache.clear();
+         kv_iterators.clear();
+         kv_temp.clear();
+      }
+   };
+
+   database& get_db() {
+      static database db;
+      return db;
+   }
+
+   // records how to restore the entry `k` of `m` to its current state; call before changing it
+   template <typename Map>
+   void save( Map& m, const typename Map::key_type& k ) {
+      auto& db = get_db();
+      if ( db.sessions.empty() )
+         return;
+      auto it = m.find( k );
+      if ( it == m.end() )
+         db.undo.emplace_back( [&m, k] { m.erase( k ); } );
+      else
+         db.undo.emplace_back( [&m, k, v = it->second] { m.insert_or_assign( k, v ); } );
+   }
+
+   const table_info* find_table( uint64_t code, uint64_t scope, uint64_t table ) {
+      auto& db = get_db();
+      auto  it = db.table_ids.find( { code, scope, table } );
+      return it == db.table_ids.end() ? nullptr : &db.tables.at( it->second );
+   }
+
+   const table_info& find_or_create_table( uint64_t scope, uint64_t table, uint64_t payer ) {
+      auto& db = get_db();
+      if ( auto* tab = find_table( db.receiver, scope, table ) )
+         return *tab;
+      std::tuple key{ db.receiver, scope, table };
+      uint64_t   id = db.next_table_id++;
+      save( db.table_ids, key );
+      save( db.tables, id );
+      db.table_ids.emplace( key, id );
+      return db.tables.emplace( id, table_info{ id, key, payer } ).first->second;
+   }
+
+   // adjusts the row count of a table, removing the table with its last row
+   void change_count( uint64_t table_id, int32_t delta ) {
+      auto& db = get_db();
+      save( db.tables, table_id );
+      auto& tab = db.tables.at( table_id );
+      tab.count += delta;
+      if ( tab.count == 0 ) {
+         save( db.table_ids, tab.key );
+         db.table_ids.erase( tab.key );
+         db.tables.erase( table_id );
+      }
+   }
+
+   void check_write_access( uint64_t table_id ) {
+      auto& db = get_db();
+      check( std::get<0>( db.tables.at( table_id ).key ) == db.receiver, "db access violation" );
+   }
+
+   void check_payer( uint64_t payer ) {
+      check( payer != 0, "must specify a valid account to pay for new record" );
+   }
+
+   // primary index
+
+   int32_t store_i64( uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len ) {
+      check_payer( payer );
+      auto&       db  = get_db();
+      const auto& tab = find_or_create_table( scope, table, payer );
+      std::pair   key{ tab.id, id };
+      check( !db.rows.count( key ), "could not insert object, most likely a uniqueness constraint was violated" );
+      save( db.rows, key );
+      auto it = db.rows.emplace( key, row{ payer, { (const char*)data, (const char*)data + len } } ).first;
+      change_count( tab.id, 1 );
+      db.primary.cache_table( tab.id );
+      return db.primary.add( it );
+   }
+
+   void update_i64( int32_t itr, uint64_t payer, const void* data, uint32_t len ) {
+      auto& db = get_db();
+      auto  it = db.primary.get( itr );
+      check_write_access( it->first.first );
+      save( db.rows, it->first );
+      if ( payer )
+         it->second.payer = payer;
+      it->second.value.assign( (const char*)data, (const char*)data + len );
+   }
+
+   void remove_i64( int32_t itr ) {
+      auto&    db       = get_db();
+      auto     it       = db.primary.get( itr );
+      uint64_t table_id = it->first.first;
+      check_write_access( table_id );
+      save( db.rows, it->first );
+      db.primary.remove( itr );
+      db.rows.erase( it );
+      change_count( table_id, -1 );
+   }
+
+   int32_t get_i64( int32_t itr, void* data, uint32_t len ) {
+      const auto& value = get_db().primary.get( itr )->second.value;
+      if ( len == 0 )
+         return value.size();
+      uint32_t copy_size = std::min<size_t>( len, value.size() );
+      memcpy( data, value.data(), copy_size );
+      return copy_size;
+   }
+
+   int32_t next_i64( int32_t itr, uint64_t* primary ) {
+      if ( itr < -1 )
+         return -1; // cannot increment past the end iterator
+      auto&    db       = get_db();
+      auto     it       = db.primary.get( itr );
+      uint64_t table_id = it->first.first;
+      if ( ++it == db.rows.end() || it->first.first != table_id )
+         return db.primary.cache_table( table_id );
+      *primary = it->first.second;
+      return db.primary.add( it );
+   }
+
+   int32_t previous_i64( int32_t itr, uint64_t* primary ) {
+      auto&            db = get_db();
+      rows_t::iterator it;
+      uint64_t         table_id;
+      if ( itr < -1 ) {
+         table_id = db.primary.end_table( itr );
+         it       = db.rows.upper_bound( { table_id, std::numeric_limits<uint64_t>::max() } );
+      } else {
+         it       = db.primary.get( itr );
+         table_id = it->first.first;
+      }
+      if ( it == db.rows.begin() || (--it)->first.first != table_id )
+         return -1;
+      *primary = it->first.second;
+      return db.primary.add( it );
+   }
+
+   template <typename Search>
+   int32_t search_i64( uint64_t code, uint64_t scope, uint64_t table, Search&& search ) {
+      auto& db  = get_db();
+      auto* tab = find_table( code, scope, table );
+      if ( !tab )
+         return -1;
+      int32_t end = db.primary.cache_table( tab->id );
+      auto    it  = search( tab->id );
+      if ( it == db.rows.end() || it->first.first != tab->id )
+         return end;
+      return db.primary.add( it );
+   }
+
+   // secondary indices
+
+   template <typename Key>
+   void check_secondary( const Key& ) {}
+
+   void check_secondary( double key ) {
+      check( !std::isnan( key ), "NaN is not an allowed value for a secondary key" );
+   }
+
+   void check_secondary( long double key ) {
+      check( !std::isnan( key ), "NaN is not an allowed value for a secondary key" );
+   }
+
+   template <typename Key>
+   int32_t idx_store( secondary_index<Key>& idx, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const Key& secondary ) {
+      check_payer( payer );
+      check_secondary( secondary );
+      const auto& tab = find_or_create_table( scope, table, payer );
+      std::pair   primary_key{ tab.id, id };
+      std::tuple  entry_key{ tab.id, secondary, id };
+      check( !idx.by_primary.count( primary_key ), "could not insert object, most likely a uniqueness constraint was violated" );
+      save( idx.by_primary, primary_key );
+      save( idx.entries, entry_key );
+      idx.by_primary.emplace( primary_key, secondary );
+      auto it = idx.entries.emplace( entry_key, payer ).first;
+      change_count( tab.id, 1 );
+      idx.cache.cache_table( tab.id );
+      return idx.cache.add( it );
+   }
+
+   template <typename Key>
+   void idx_update( secondary_index<Key>& idx, int32_t itr, uint64_t payer, const Key& secondary ) {
+      check_secondary( secondary );
+      auto     it       = idx.cache.get( itr );
+      auto     table_id = std::get<0>( it->first );
+      auto     id       = std::get<2>( it->first );
+      check_write_access( table_id );
+      if ( !payer )
+         payer = it->second;
+      std::tuple entry_key{ table_id, secondary, id };
+      save( idx.entries, it->first );
+      if ( entry_key == it->first ) {
+         it->second = payer;
+         return;
+      }
+      save( idx.entries, entry_key );
+      save( idx.by_primary, { table_id, id } );
+      auto updated = idx.entries.emplace( entry_key, payer ).first;
+      idx.cache.replace( itr, updated );
+      idx.entries.erase( it );
+      idx.by_primary[{ table_id, id }] = secondary;
+   }
+
+   template <typename Key>
+   void idx_remove( secondary_index<Key>& idx, int32_t itr ) {
+      auto     it       = idx.cache.get( itr );
+      uint64_t table_id = std::get<0>( it->first );
+      check_write_access( table_id );
+      std::pair primary_key{ table_id, std::get<2>( it->first ) };
+      save( idx.entries, it->first );
+      save( idx.by_primary, primary_key );
+      idx.cache.remove( itr );
+      idx.entries.erase( it );
+      idx.by_primary.erase( primary_key );
+      change_count( table_id, -1 );
+   }
+
+   template <typename Key>
+   int32_t idx_next( secondary_index<Key>& idx, int32_t itr, uint64_t* primary ) {
+      if ( itr < -1 )
+         return -1; // cannot increment past the end iterator
+      auto     it       = idx.cache.get( itr );
+      uint64_t table_id = std::get<0>( it->first );
+      if ( ++it == idx.entries.end() || std::get<0>( it->first ) != table_id )
+         return idx.cache.cache_table( table_id );
+      *primary = std::get<2>( it->first );
+      return idx.cache.add( it );
+   }
+
+   template <typename Key>
+   int32_t idx_previous( secondary_index<Key>& idx, int32_t itr, uint64_t* primary ) {
+      typename secondary_index<Key>::entries_t::iterator it;
+      uint64_t                                           table_id;
+      if ( itr < -1 ) {
+         table_id = idx.cache.end_table( itr );
+         it       = idx.entries.upper_bound( table_id );
+      } else {
+         it       = idx.cache.get( itr );
+         table_id = std::get<0>( it->first );
+      }
+      if ( it == idx.entries.begin() || std::get<0>( (--it)->first ) != table_id )
+         return -1;
+      *primary = std::get<2>( it->first );
+      return idx.cache.add( it );
+   }
+
+   template <typename Key>
+   int32_t idx_find_primary( secondary_index<Key>& idx, uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t primary ) {
+      auto* tab = find_table( code, scope, table );
+      if ( !tab )
+         return -1;
+      int32_t end = idx.cache.cache_table( tab->id );
+      auto    it  = idx.by_primary.find( { tab->id, primary } );
+      if ( it == idx.by_primary.end() )
+         return end;
+      secondary = it->second;
+      return idx.cache.add( idx.entries.find( { tab->id, it->second, primary } ) );
+   }
+
+   // positions on the first entry of the table not ordered before (`secondary`, `primary_bound`)
+   // by `search`; `exact` additionally requires the secondary key to match
+   template <typename Key, typename Search>
+   int32_t idx_search( secondary_index<Key>& idx, uint64_t code, uint64_t scope, uint64_t table, Key& secondary,
+                       uint64_t& primary, bool exact, Search&& search ) {
+      check_secondary( secondary );
+      auto* tab = find_table( code, scope, table );
+      if ( !tab )
+         return -1;
+      int32_t end = idx.cache.cache_table( tab->id );
+      auto    it  = search( tab->id );
+      if ( it == idx.entries.end() || std::get<0>( it->first ) != tab->id ||
+           ( exact && !( std::get<1>( it->first ) == secondary ) ) )
+         return end;
+      secondary = std::get<1>( it->first );
+      primary   = std::get<2>( it->first );
+      return idx.cache.add( it );
+   }
+
+   template <typename Key>
+   int32_t idx_find_secondary( secondary_index<Key>& idx, uint64_t code, uint64_t scope, uint64_t table, Key secondary, uint64_t* primary ) {
+      return idx_search( idx, code, scope, table, secondary, *primary, true, [&]( uint64_t t ) {
+         return idx.entries.lower_bound( { t, secondary, 0 } );
+      } );
+   }
+
+   template <typename Key>
+   int32_t idx_lowerbound( secondary_index<Key>& idx, uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t* primary ) {
+      Key search_key = secondary;
+      return idx_search( idx, code, scope, table, secondary, *primary, false, [&]( uint64_t t ) {
+         return idx.entries.lower_bound( { t, search_key, 0 } );
+      } );
+   }
+
+   template <typename Key>
+   int32_t idx_upperbound( secondary_index<Key>& idx, uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t* primary ) {
+      Key search_key = secondary;
+      return idx_search( idx, code, scope, table, secondary, *primary, false, [&]( uint64_t t ) {
+         return idx.entries.upper_bound( { t, search_key, std::numeric_limits<uint64_t>::max() } );
+      } );
+   }
+
+   template <typename Key>
+   int32_t idx_end( secondary_index<Key>& idx, uint64_t code, uint64_t scope, uint64_t table ) {
+      auto* tab = find_table( code, scope, table );
+      return tab ? idx.cache.cache_table( tab->id ) : -1;
+   }
+
+   key256 to_key256( const uint128_t* data, uint32_t len ) {
+      check( len == 2, "invalid size of secondary key array for idx256" );
+      return { data[0], data[1] };
+   }
+
+   // key-value intrinsics
+
+   void check_kv_write( uint64_t contract ) {
+      check( contract == get_db().receiver, "can not write to this key" );
+   }
+
+   kv_iterator& get_kv_iterator( uint32_t itr ) {
+      auto& its = get_db().kv_iterators;
+      check( itr < its.size() && its[itr].has_value(), "invalid kv iterator" );
+      return *its[itr];
+   }
+
+   kv_rows_t::iterator kv_find( const kv_iterator& i ) {
+      auto& rows = get_db().kv_rows;
+      auto  it   = rows.find( { i.contract, i.key } );
+      return it != rows.end() && it->second.id == i.id ? it : rows.end();
+   }
+
+   int32_t kv_status( const kv_iterator& i ) {
+      if ( i.at_end )
+         return iterator_end;
+      return kv_find( i ) == get_db().kv_rows.end() ? iterator_erased : iterator_ok;
+   }
+
+   kv_rows_t::iterator kv_current( const kv_iterator& i ) {
+      auto it = kv_find( i );
+      check( it != get_db().kv_rows.end(), "iterator to erased element" );
+      return it;
+   }
+
+   // first row past the rows of the iterator's contract and prefix
+   kv_rows_t::iterator kv_range_end( const kv_iterator& i ) {
+      auto&       rows = get_db().kv_rows;
+      std::string next = i.prefix;
+      while ( !next.empty() && uint8_t( next.back() ) == 0xff )
+         next.pop_back();
+      if ( !next.empty() ) {
+         next.back() = char( uint8_t( next.back() ) + 1 );
+         return rows.lower_bound( { i.contract, next } );
+      }
+      return i.contract == std::numeric_limits<uint64_t>::max() ? rows.end() : rows.lower_bound( { i.contract + 1, {} } );
+   }
+
+   int32_t kv_move( kv_iterator& i, kv_rows_t::iterator it, uint32_t& key_size, uint32_t& value_size ) {
+      i.at_end = it == get_db().kv_rows.end() || it->first.first != i.contract || !it->first.second.starts_with( i.prefix );
+      if ( i.at_end ) {
+         key_size = value_size = 0;
+         return iterator_end;
+      }
+      i.key      = it->first.second;
+      i.id       = it->second.id;
+      key_size   = it->first.second.size();
+      value_size = it->second.value.size();
+      return iterator_ok;
+   }
+
+   template <typename Get>
+   int32_t kv_read( uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size, Get&& get ) {
+      auto&   i      = get_kv_iterator( itr );
+      int32_t status = kv_status( i );
+      if ( status != iterator_ok ) {
+         actual_size = 0;
+         return status;
+      }
+      const std::string& src = get( kv_current( i ) );
+      if ( offset < src.size() )
+         memcpy( dest, src.data() + offset, std::min<size_t>( size, src.size() - offset ) );
+      actual_size = src.size();
+      return iterator_ok;
+   }
+
+   int32_t sign( int c ) { return c < 0 ? -1 : c > 0 ? 1 : 0; }
+
+   // FNV-1a
+   struct digest {
+      uint64_t value = 0xcbf29ce484222325;
+
+      void add( const void* data, size_t size ) {
+         for ( size_t i = 0; i < size; ++i ) {
+            value ^= static_cast<const unsigned char*>( data )[i];
+            value *= 0x100000001b3;
+         }
+      }
+
+      template <typename T>
+      void add( const T& v ) {
+         static_assert( std::has_unique_object_representations_v<T> || std::is_same_v<T, double> );
+         add( &v, sizeof( v ) );
+      }
+
+      template <typename Bytes>
+      void add_bytes( const Bytes& b ) {
+         add( uint64_t( b.size() ) );
+         add( b.data(), b.size() );
+      }
+   };
+
+   template <typename Key>
+   void add_secondary( digest& d, const secondary_index<Key>& idx, uint64_t table_id ) {
+      for ( auto it = idx.by_primary.lower_bound( { table_id, 0 } ); it != idx.by_primary.end() && it->first.first == table_id; ++it ) {
+         d.add( it->first.second );
+         if constexpr ( std::is_same_v<Key, long double> )
+            d.add( double( it->second ) ); // wasm and native long doubles have different formats
+         else
+            d.add( it->second );
+      }
+   }
+
+} // namespace
+
+   void set_receiver( name receiver ) {
+      EOSIO_HOST_CALL();
+      get_db().receiver = receiver.value;
+      eosio_set_contract_name( receiver.value );
+   }
+
+   name get_receiver() { return name{ get_db().receiver }; }
+
+   void start_session() {
+      EOSIO_HOST_CALL();
+      auto& db = get_db();
+      db.clear_iterators();
+      db.sessions.push_back( db.undo.size() );
+   }
+
+   void commit_session() {
+      EOSIO_HOST_CALL();
+      auto& db = get_db();
+      check( !db.sessions.empty(), "no open chaindb session" );
+      db.clear_iterators();
+      db.sessions.pop_back();
+      if ( db.sessions.empty() )
+         db.undo.clear();
+   }
+
+   void undo_session() {
+      EOSIO_HOST_CALL();
+      auto& db = get_db();
+      check( !db.sessions.empty(), "no open chaindb session" );
+      db.clear_iterators();
+      for ( size_t mark = db.sessions.back(); db.undo.size() > mark; db.undo.pop_back() )
+         db.undo.back()();
+      db.sessions.pop_back();
+   }
+
+   uint32_t session_depth() { return get_db().sessions.size(); }
+
+   void reset() {
+      EOSIO_HOST_CALL();
+      uint64_t receiver = get_db().receiver;
+      get_db()          = database{};
+      get_db().receiver = receiver;
+   }
+
+   usage get_usage() {
+      EOSIO_HOST_CALL();
+      auto& db = get_db();
+      usage u;
+      u.tables         = db.tables.size();
+      u.rows           = db.rows.size();
+      u.secondary_rows = db.idx64.by_primary.size() + db.idx128.by_primary.size() + db.idx256.by_primary.size() +
+                         db.idx_double.by_primary.size() + db.idx_long_double.by_primary.size();
+      u.kv_rows        = db.kv_rows.size();
+      return u;
+   }
+
+   uint64_t state_digest() {
+      EOSIO_HOST_CALL();
+      auto&  db = get_db();
+      digest d;
+      for ( const auto& [key, id] : db.table_ids ) {
+         d.add( std::get<0>( key ) );
+         d.add( std::get<1>( key ) );
+         d.add( std::get<2>( key ) );
+         for ( auto it = db.rows.lower_bound( { id, 0 } ); it != db.rows.end() && it->first.first == id; ++it ) {
+            d.add( it->first.second );
+            d.add( it->second.payer );
+            d.add_bytes( it->second.value );
+         }
+         add_secondary( d, db.idx64, id );
+         add_secondary( d, db.idx128, id );
+         add_secondary( d, db.idx256, id );
+         add_secondary( d, db.idx_double, id );
+         add_secondary( d, db.idx_long_double, id );
+      }
+      for ( const auto& [key, row] : db.kv_rows ) {
+         d.add( key.first );
+         d.add_bytes( key.second );
+         d.add_bytes( row.value );
+         d.add( row.payer );
+      }
+      return d.value;
+   }
+
+}} // namespace eosio::chaindb
+
+namespace eosio { namespace internal_use_do_not_use {
+
+using namespace eosio::chaindb;
+
+extern "C" {
+
+uint64_t current_receiver() {
+   EOSIO_INTRINSIC_STATS("current_receiver", 0);
+   return get_db().receiver;
+}
+
+int32_t db_store_i64(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("db_store_i64", len);
+   return store_i64(scope, table, payer, id, data, len);
+}
+void db_update_i64(int32_t itr, uint64_t payer, const void* data, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("db_update_i64", len);
+   update_i64(itr, payer, data, len);
+}
+void db_remove_i64(int32_t itr) {
+   EOSIO_INTRINSIC_STATS("db_remove_i64", 0);
+   remove_i64(itr);
+}
+int32_t db_get_i64(int32_t itr, const void* data, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("db_get_i64", 0);
+   int32_t size = get_i64(itr, const_cast<void*>(data), len);
+   if (len)
+      EOSIO_INTRINSIC_STATS_BYTES_OUT(size);
+   return size;
+}
+int32_t db_next_i64(int32_t itr, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_next_i64", 0);
+   return next_i64(itr, primary);
+}
+int32_t db_previous_i64(int32_t itr, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_previous_i64", 0);
+   return previous_i64(itr, primary);
+}
+
+int32_t db_find_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+   EOSIO_INTRINSIC_STATS("db_find_i64", 0);
+   return search_i64(code, scope, table, [&](uint64_t t) { return get_db().rows.find({t, id}); });
+}
+int32_t db_lowerbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+   EOSIO_INTRINSIC_STATS("db_lowerbound_i64", 0);
+   return search_i64(code, scope, table, [&](uint64_t t) { return get_db().rows.lower_bound({t, id}); });
+}
+int32_t db_upperbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+   EOSIO_INTRINSIC_STATS("db_upperbound_i64", 0);
+   return search_i64(code, scope, table, [&](uint64_t t) { return get_db().rows.upper_bound({t, id}); });
+}
+int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
+   EOSIO_INTRINSIC_STATS("db_end_i64", 0);
+   auto* tab = find_table(code, scope, table);
+   return tab ? get_db().primary.cache_table(tab->id) : -1;
+}
+
+#define CHAINDB_SECONDARY_INDEX(IDX, TYPE)                                                                          \
+   int32_t db_##IDX##_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const TYPE* secondary) {     \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_store", sizeof(TYPE));                                                     \
+      return idx_store(get_db().IDX, scope, table, payer, id, *secondary);                                          \
+   }                                                                                                                \
+   void db_##IDX##_update(int32_t itr, uint64_t payer, const TYPE* secondary) {                                      \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_update", sizeof(TYPE));                                                    \
+      idx_update(get_db().IDX, itr, payer, *secondary);                                                             \
+   }                                                                                                                \
+   void db_##IDX##_remove(int32_t itr) {                                                                             \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_remove", 0);                                                               \
+      idx_remove(get_db().IDX, itr);                                                                                \
+   }                                                                                                                \
+   int32_t db_##IDX##_next(int32_t itr, uint64_t* primary) {                                                         \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_next", 0);                                                                 \
+      return idx_next(get_db().IDX, itr, primary);                                                                  \
+   }                                                                                                                \
+   int32_t db_##IDX##_previous(int32_t itr, uint64_t* primary) {                                                     \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_previous", 0);                                                             \
+      return idx_previous(get_db().IDX, itr, primary);                                                              \
+   }                                                                                                                \
+   int32_t db_##IDX##_find_primary(uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t primary) { \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_find_primary", 0);                                                         \
+      return idx_find_primary(get_db().IDX, code, scope, table, *secondary, primary);                               \
+   }                                                                                                                \
+   int32_t db_##IDX##_find_secondary(uint64_t code, uint64_t scope, uint64_t table, const TYPE* secondary,           \
+                                     uint64_t* primary) {                                                           \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_find_secondary", sizeof(TYPE));                                            \
+      return idx_find_secondary(get_db().IDX, code, scope, table, *secondary, primary);                             \
+   }                                                                                                                \
+   int32_t db_##IDX##_lowerbound(uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t* primary) { \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_lowerbound", sizeof(TYPE));                                                \
+      return idx_lowerbound(get_db().IDX, code, scope, table, *secondary, primary);                                 \
+   }                                                                                                                \
+   int32_t db_##IDX##_upperbound(uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t* primary) { \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_upperbound", sizeof(TYPE));                                                \
+      return idx_upperbound(get_db().IDX, code, scope, table, *secondary, primary);                                 \
+   }                                                                                                                \
+   int32_t db_##IDX##_end(uint64_t code, uint64_t scope, uint64_t table) {                                           \
+      EOSIO_INTRINSIC_STATS("db_" #IDX "_end", 0);                                                                  \
+      return idx_end(get_db().IDX, code, scope, table);                                                             \
+   }
+
+CHAINDB_SECONDARY_INDEX(idx64, uint64_t)
+CHAINDB_SECONDARY_INDEX(idx128, uint128_t)
+CHAINDB_SECONDARY_INDEX(idx_double, double)
+CHAINDB_SECONDARY_INDEX(idx_long_double, long double)
+
+#undef CHAINDB_SECONDARY_INDEX
+
+int32_t db_idx256_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint128_t* data, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("db_idx256_store", len * sizeof(uint128_t));
+   return idx_store(get_db().idx256, scope, table, payer, id, to_key256(data, len));
+}
+void db_idx256_update(int32_t itr, uint64_t payer, const uint128_t* data, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("db_idx256_update", len * sizeof(uint128_t));
+   idx_update(get_db().idx256, itr, payer, to_key256(data, len));
+}
+void db_idx256_remove(int32_t itr) {
+   EOSIO_INTRINSIC_STATS("db_idx256_remove", 0);
+   idx_remove(get_db().idx256, itr);
+}
+int32_t db_idx256_next(int32_t itr, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_idx256_next", 0);
+   return idx_next(get_db().idx256, itr, primary);
+}
+int32_t db_idx256_previous(int32_t itr, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_idx256_previous", 0);
+   return idx_previous(get_db().idx256, itr, primary);
+}
+int32_t db_idx256_find_primary(uint64_t code, uint64_t scope, uint64_t table, uint128_t* data, uint32_t len, uint64_t primary) {
+   EOSIO_INTRINSIC_STATS("db_idx256_find_primary", 0);
+   key256  secondary = to_key256(data, len);
+   int32_t itr       = idx_find_primary(get_db().idx256, code, scope, table, secondary, primary);
+   std::copy(secondary.begin(), secondary.end(), data);
+   return itr;
+}
+int32_t db_idx256_find_secondary(uint64_t code, uint64_t scope, uint64_t table, const uint128_t* data, uint32_t len, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_idx256_find_secondary", len * sizeof(uint128_t));
+   return idx_find_secondary(get_db().idx256, code, scope, table, to_key256(data, len), primary);
+}
+int32_t db_idx256_lowerbound(uint64_t code, uint64_t scope, uint64_t table, uint128_t* data, uint32_t len, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_idx256_lowerbound", len * sizeof(uint128_t));
+   key256  secondary = to_key256(data, len);
+   int32_t itr       = idx_lowerbound(get_db().idx256, code, scope, table, secondary, primary);
+   std::copy(secondary.begin(), secondary.end(), data);
+   return itr;
+}
+int32_t db_idx256_upperbound(uint64_t code, uint64_t scope, uint64_t table, uint128_t* data, uint32_t len, uint64_t* primary) {
+   EOSIO_INTRINSIC_STATS("db_idx256_upperbound", len * sizeof(uint128_t));
+   key256  secondary = to_key256(data, len);
+   int32_t itr       = idx_upperbound(get_db().idx256, code, scope, table, secondary, primary);
+   std::copy(secondary.begin(), secondary.end(), data);
+   return itr;
+}
+int32_t db_idx256_end(uint64_t code, uint64_t scope, uint64_t table) {
+   EOSIO_INTRINSIC_STATS("db_idx256_end", 0);
+   return idx_end(get_db().idx256, code, scope, table);
+}
+
+int64_t kv_set(uint64_t contract, const char* key, uint32_t key_size, const char* value, uint32_t value_size, uint64_t payer) {
+   EOSIO_INTRINSIC_STATS("kv_set", key_size + value_size);
+   check_kv_write(contract);
+   auto&       db = get_db();
+   std::pair   k{contract, std::string(key, key_size)};
+   save(db.kv_rows, k);
+   auto it = db.kv_rows.find(k);
+   if (it == db.kv_rows.end()) {
+      db.kv_rows.emplace(std::move(k), kv_row{std::string(value, value_size), payer, ++db.next_kv_id});
+      return int64_t(key_size) + value_size;
+   }
+   int64_t delta = int64_t(value_size) - int64_t(it->second.value.size());
+   it->second.value.assign(value, value_size);
+   it->second.payer = payer;
+   return delta;
+}
+
+int64_t kv_erase(uint64_t contract, const char* key, uint32_t key_size) {
+   EOSIO_INTRINSIC_STATS("kv_erase", key_size);
+   check_kv_write(contract);
+   auto&     db = get_db();
+   std::pair k{contract, std::string(key, key_size)};
+   auto      it = db.kv_rows.find(k);
+   if (it == db.kv_rows.end())
+      return 0;
+   int64_t delta = -int64_t(key_size) - int64_t(it->second.value.size());
+   save(db.kv_rows, k);
+   db.kv_rows.erase(it);
+   return delta;
+}
+
+bool kv_get(uint64_t contract, const char* key, uint32_t key_size, uint32_t& value_size) {
+   EOSIO_INTRINSIC_STATS("kv_get", key_size);
+   auto& db = get_db();
+   auto  it = db.kv_rows.find({contract, std::string(key, key_size)});
+   if (it == db.kv_rows.end()) {
+      db.kv_temp.clear();
+      value_size = 0;
+      return false;
+   }
+   db.kv_temp = it->second.value;
+   value_size = db.kv_temp.size();
+   return true;
+}
+
+uint32_t kv_get_data(uint32_t offset, char* data, uint32_t data_size) {
+   EOSIO_INTRINSIC_STATS("kv_get_data", 0);
+   const auto& temp = get_db().kv_temp;
+   if (offset < temp.size()) {
+      size_t copy_size = std::min<size_t>(data_size, temp.size() - offset);
+      memcpy(data, temp.data() + offset, copy_size);
+      EOSIO_INTRINSIC_STATS_BYTES_OUT(copy_size);
+   }
+   return temp.size();
+}
+
+uint32_t kv_it_create(uint64_t contract, const char* prefix, uint32_t size) {
+   EOSIO_INTRINSIC_STATS("kv_it_create", size);
+   auto& its = get_db().kv_iterators;
+   auto  it  = std::find_if(its.begin(), its.end(), [](const auto& i) { return !i.has_value(); });
+   if (it == its.end())
+      it = its.emplace(its.end());
+   it->emplace(kv_iterator{contract, std::string(prefix, size), true, {}, 0});
+   return it - its.begin();
+}
+
+void kv_it_destroy(uint32_t itr) {
+   EOSIO_INTRINSIC_STATS("kv_it_destroy", 0);
+   get_kv_iterator(itr);
+   get_db().kv_iterators[itr].reset();
+}
+
+int32_t kv_it_status(uint32_t itr) {
+   EOSIO_INTRINSIC_STATS("kv_it_status", 0);
+   return kv_status(get_kv_iterator(itr));
+}
+
+int32_t kv_it_compare(uint32_t itr_a, uint32_t itr_b) {
+   EOSIO_INTRINSIC_STATS("kv_it_compare", 0);
+   auto& a = get_kv_iterator(itr_a);
+   auto& b = get_kv_iterator(itr_b);
+   check(a.contract == b.contract && a.prefix == b.prefix, "incompatible key-value iterators");
+   check(kv_status(a) != iterator_erased && kv_status(b) != iterator_erased, "iterator to erased element");
+   if (a.at_end || b.at_end)
+      return int32_t(a.at_end) - int32_t(b.at_end);
+   return sign(a.key.compare(b.key));
+}
+
+int32_t kv_it_key_compare(uint32_t itr, const char* key, uint32_t size) {
+   EOSIO_INTRINSIC_STATS("kv_it_key_compare", size);
+   auto& i = get_kv_iterator(itr);
+   check(kv_status(i) != iterator_erased, "iterator to erased element");
+   if (i.at_end)
+      return 1;
+   return sign(std::string_view(i.key).compare(std::string_view(key, size)));
+}
+
+int32_t kv_it_move_to_end(uint32_t itr) {
+   EOSIO_INTRINSIC_STATS("kv_it_move_to_end", 0);
+   get_kv_iterator(itr).at_end = true;
+   return iterator_end;
+}
+
+int32_t kv_it_next(uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+   EOSIO_INTRINSIC_STATS("kv_it_next", 0);
+   auto& i  = get_kv_iterator(itr);
+   auto  it = i.at_end ? get_db().kv_rows.lower_bound({i.contract, i.prefix}) : std::next(kv_current(i));
+   return kv_move(i, it, found_key_size, found_value_size);
+}
+
+int32_t kv_it_prev(uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+   EOSIO_INTRINSIC_STATS("kv_it_prev", 0);
+   auto& i  = get_kv_iterator(itr);
+   auto  it = i.at_end ? kv_range_end(i) : kv_current(i);
+   if (it == get_db().kv_rows.begin()) {
+      i.at_end = true;
+      found_key_size = found_value_size = 0;
+      return iterator_end;
+   }
+   return kv_move(i, std::prev(it), found_key_size, found_value_size);
+}
+
+int32_t kv_it_lower_bound(uint32_t itr, const char* key, uint32_t size, uint32_t& found_key_size, uint32_t& found_value_size) {
+   EOSIO_INTRINSIC_STATS("kv_it_lower_bound", size);
+   auto&       i = get_kv_iterator(itr);
+   std::string target(key, size);
+   if (target < i.prefix)
+      target = i.prefix;
+   return kv_move(i, get_db().kv_rows.lower_bound({i.contract, target}), found_key_size, found_value_size);
+}
+
+int32_t kv_it_key(uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+   EOSIO_INTRINSIC_STATS("kv_it_key", 0);
+   int32_t status = kv_read(itr, offset, dest, size, actual_size, [](auto it) -> const std::string& { return it->first.second; });
+   if (actual_size > offset)
+      EOSIO_INTRINSIC_STATS_BYTES_OUT(std::min(size, actual_size - offset));
+   return status;
+}
+
+int32_t kv_it_value(uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+   EOSIO_INTRINSIC_STATS("kv_it_value", 0);
+   int32_t status = kv_read(itr, offset, dest, size, actual_size, [](auto it) -> const std::string& { return it->second.value; });
+   if (actual_size > offset)
+      EOSIO_INTRINSIC_STATS_BYTES_OUT(std::min(size, actual_size - offset));
+   return status;
+}
+
+} // extern "C"
+
+}} // namespace eosio::internal_use_do_not_use
@@ -0,0 +1,157 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <eosio/name.hpp>
+
+#include <cstdint>
+#include <utility>
+
+extern "C" {
+   // only resolved when eosio::contract_memory is linked
+   __attribute__((weak)) void eosio_memory_action_begin( uint64_t receiver, uint64_t code, uint64_t action );
+   __attribute__((weak)) void eosio_memory_action_end();
+   __attribute__((weak)) void eosio_memory_action_abort();
+}
+
+namespace eosio { namespace chaindb {
+
+   /**
+    *  @defgroup chaindb Native Chain Database
+    *  @ingroup core
+    *  @brief In-memory `db_*` and `kv_*` intrinsics for native executables
+    *
+    *  Linking `eosio::chaindb` into a native executable or a tester module defines the `db_*_i64`,
+    *  `db_idx*` and `kv_*` intrinsics (and `current_receiver`) over ordered in-memory containers, so
+    *  code built on `multi_index`, `singleton`, `kv::map` and `kv::table` runs outside of an action.
+    *
+    *  The emulator follows the chain's rules: rows are written to the tables of the current
+    *  receiver, end iterators are negative and per table, tables disappear with their last row,
+    *  and db and kv iterators are only valid for the duration of one action. Writes made while a
+    *  session is open are recorded in an undo log so an action can be rolled back.
+    *
+    *  **Example:**
+    *  ```
+    *     eosio::chaindb::apply("mycontract"_n, [] {
+    *        accounts_table accounts("mycontract"_n, "alice"_n.value);
+    *        accounts.emplace("mycontract"_n, [](auto& a) { a.balance = 10; });
+    *     }); // committed, or rolled back if the lambda throws (native only)
+    *  ```
+    */
+
+   /**
+    *  Row counts of the emulated database.
+    *
+    *  @ingroup chaindb
+    */
+   struct usage {
+      uint64_t tables         = 0;
+      uint64_t rows           = 0; ///< rows of primary tables
+      uint64_t secondary_rows = 0; ///< entries of all secondary indices
+      uint64_t kv_rows        = 0;
+   };
+
+   /**
+    *  Sets the account whose tables are written by `db_*` stores and `kv_set`, and which is returned
+    *  by `current_receiver()` and `current_context_contract()`.
+    *
+    *  @ingroup chaindb
+    */
+   void set_receiver( name receiver );
+
+   /**
+    *  @ingroup chaindb
+    */
+   name get_receiver();
+
+   /**
+    *  Opens a session: every write from now on can be reverted by `undo_session`. Sessions nest,
+    *  committing an inner session folds its writes into the enclosing one. Opening, committing and
+    *  undoing a session invalidates all db and kv iterators, as an action boundary does.
+    *
+    *  @ingroup chaindb
+    */
+   void start_session();
+
+   /**
+    *  Keeps the writes of the innermost session.
+    *
+    *  @ingroup chaindb
+    */
+   void commit_session();
+
+   /**
+    *  Reverts every write of the innermost session and closes it.
+    *
+    *  @ingroup chaindb
+    */
+   void undo_session();
+
+   /**
+    *  Number of open sessions.
+    *
+    *  @ingroup chaindb
+    */
+   uint32_t session_depth();
+
+   /**
+    *  Drops all tables, kv rows, iterators and open sessions.
+    *
+    *  @ingroup chaindb
+    */
+   void reset();
+
+   /**
+    *  @ingroup chaindb
+    */
+   usage get_usage();
+
+   /**
+    *  Hash of every table row, secondary key and kv row with its payer. It only depends on the
+    *  contents of the database: not on the order of the writes, nor on whether the code that made
+    *  them was compiled to wasm or natively.
+    *
+    *  @ingroup chaindb
+    */
+   uint64_t state_digest();
+
+   /**
+    *  Runs `f` as an action of `receiver`: its writes are committed when it returns and rolled back
+    *  when it throws, after which the exception is rethrown. With `eosio::contract_memory` linked,
+    *  `f` runs in a simulated linear memory and fails when it exceeds the memory budget.
+    *
+    *  A tester module is built without exceptions: there a failing `f` aborts the module, and
+    *  nothing is rolled back.
+    *
+    *  @ingroup chaindb
+    */
+   template <typename F>
+   void apply( name receiver, F&& f ) {
+      set_receiver( receiver );
+      start_session();
+#ifdef __wasm__
+      if ( eosio_memory_action_begin )
+         eosio_memory_action_begin( receiver.value, receiver.value, 0 );
+      std::forward<F>( f )();
+      if ( eosio_memory_action_end )
+         eosio_memory_action_end();
+#else
+      try {
+         if ( eosio_memory_action_begin )
+            eosio_memory_action_begin( receiver.value, receiver.value, 0 );
+         std::forward<F>( f )();
+         if ( eosio_memory_action_end )
+            eosio_memory_action_end();
+      } catch ( ... ) {
+         if ( eosio_memory_action_abort )
+            eosio_memory_action_abort();
+         undo_session();
+         throw;
+      }
+#endif
+      commit_session();
+   }
+
+}} // namespace eosio::chaindb
@@ -0,0 +1,368 @@
+#include <eosio/contract_memory.hpp>
+
+#include <eosio/check.hpp>
+#include <eosio/dsmalloc.hpp>
+#include <eosio/intrinsic_stats.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <sys/mman.h>
+
+namespace {
+   using eosio::name;
+   using eosio::native::contract_memory;
+   using eosio::native::memory_budget;
+   using eosio::native::memory_report;
+
+   constexpr size_t page_size = contract_memory::page_size;
+   // dsmalloc aligns the end of each block rather than the pointer it returns, so the simulation only
+   // serves the alignment every allocation gets; over-aligned objects come from the process heap
+   constexpr size_t max_align = 16;
+
+   struct simulation;
+
+   // The dsmalloc `Memory` of a simulated action: a reserved region standing in for the linear memory
+   struct linear_memory {
+      simulation* sim = nullptr;
+
+      char*  heap_base();
+      size_t offset( const char* ptr );
+      size_t pages();
+      size_t grow( size_t pages );
+   };
+
+   using heap_allocator = eosio::basic_dsmalloc<linear_memory>;
+
+   // Per-thread state. Constant-initialized and trivially destructible, so operator new can use it at
+   // any point of the thread's life.
+   struct simulation {
+      char*         data           = nullptr;
+      uint32_t      reserved_pages = 0;
+      uint32_t      max_pages      = 0;
+      uint32_t      heap_base      = 0;
+      uint32_t      pages          = 0;
+      uint32_t      generation     = 0; // of the current action; tags its allocations
+      bool          active         = false;
+      bool          free_enabled   = false;
+      memory_report report         = {};
+      alignas( heap_allocator ) unsigned char heap_storage[sizeof( heap_allocator )] = {};
+
+      heap_allocator& heap() { return *std::launder( reinterpret_cast<heap_allocator*>( heap_storage ) ); }
+
+      bool contains( const void* ptr ) const {
+         auto p = static_cast<const char*>( ptr );
+         return data && p >= data && p < data + size_t( reserved_pages ) * page_size;
+      }
+   };
+
+   thread_local simulation sim;
+
+   char*  linear_memory::heap_base() { return sim->data + sim->heap_base; }
+   size_t linear_memory::offset( const char* ptr ) { return ptr - sim->data; }
+   size_t linear_memory::pages() { return sim->pages; }
+   size_t linear_memory::grow( size_t pages ) {
+      if ( sim->pages + pages > sim->max_pages )
+         return -1;
+      size_t old = sim->pages;
+      sim->pages += pages;
+      if ( pages )
+         ++sim->report.page_grows;
+      return old;
+   }
+
+   // dsmalloc's header is 16 bytes; the index and size it keeps take the first 8. The remaining 8 hold
+   // the requested size and the generation of the action, 0 once freed.
+   struct allocation_tag {
+      uint32_t size;
+      uint32_t generation;
+   };
+
+   allocation_tag& tag_of( void* ptr ) { return *reinterpret_cast<allocation_tag*>( static_cast<char*>( ptr ) - 8 ); }
+
+   std::atomic<bool>     is_enabled        = false;
+   std::atomic<uint32_t> max_pages_setting = contract_memory::chain_max_pages;
+   std::atomic<uint32_t> heap_base_setting = 8192;
+
+   struct registry {
+      std::mutex                 mtx;
+      memory_budget              budget;
+      std::vector<memory_report> reports;
+      std::string                dump_file;
+   };
+
+   registry& get_registry() {
+      static registry r;
+      return r;
+   }
+
+   void reserve( simulation& s, uint32_t pages ) {
+      if ( s.data )
+         munmap( s.data, size_t( s.reserved_pages ) * page_size );
+      int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+      flags |= MAP_NORESERVE;
+#endif
+      void* data = mmap( nullptr, size_t( pages ) * page_size, PROT_READ | PROT_WRITE, flags, -1, 0 );
+      eosio::check( data != MAP_FAILED, "cannot reserve the simulated contract memory" );
+      s.data           = static_cast<char*>( data );
+      s.reserved_pages = pages;
+   }
+
+   // Fills in the sizes of the memory as it is at the end of the action
+   void measure( simulation& s ) {
+      auto& r         = s.report;
+      r.pages         = s.pages;
+      r.heap_bytes    = s.heap().last_ptr - s.heap().memory.heap_base();
+      r.fragmentation = r.heap_bytes ? 1 - double( r.peak_live_bytes ) / r.heap_bytes : 0;
+   }
+
+   void finish( simulation& s, bool completed ) {
+      measure( s );
+      s.active    = false;
+      auto& r     = s.report;
+      r.completed = completed;
+      auto&                       reg = get_registry();
+      std::lock_guard<std::mutex> lock( reg.mtx );
+      reg.reports.push_back( r );
+   }
+
+   void begin( simulation& s, name receiver, name code, name action ) {
+      if ( s.active )
+         finish( s, false ); // the previous action threw past its end hook
+      if ( !is_enabled.load( std::memory_order_relaxed ) )
+         return;
+
+      uint32_t max_pages = max_pages_setting.load( std::memory_order_relaxed );
+      if ( !s.data || s.reserved_pages < max_pages )
+         reserve( s, max_pages );
+      else if ( s.pages )
+         madvise( s.data, size_t( s.pages ) * page_size, MADV_DONTNEED ); // a fresh memory for every action
+
+      s.max_pages    = max_pages;
+      s.heap_base    = std::min<uint64_t>( heap_base_setting.load( std::memory_order_relaxed ),
+                                            size_t( max_pages ) * page_size );
+      s.pages        = std::max<uint32_t>( 1, ( s.heap_base + page_size - 1 ) / page_size );
+      s.free_enabled = false;
+      s.report       = memory_report{ receiver, code, action };
+      if ( ++s.generation == 0 )
+         s.generation = 1;
+      new ( s.heap_storage ) heap_allocator( linear_memory{ &s } );
+      s.active = true;
+   }
+
+   void* allocate( simulation& s, size_t size ) {
+      // dsmalloc keeps sizes in 32 bits; anything close is far beyond the memory limit anyway
+      eosio::check( size < ( size_t( 1 ) << 31 ), "failed to allocate pages" );
+      void* ptr = s.heap()( size ? size : 1, max_align );
+      tag_of( ptr ) = { uint32_t( size ), s.generation };
+      auto& r       = s.report;
+      ++r.allocations;
+      r.live_bytes += size;
+      r.peak_live_bytes = std::max( r.peak_live_bytes, r.live_bytes );
+      return ptr;
+   }
+
+   void* allocate( size_t size, size_t align ) {
+      auto& s = sim;
+      if ( s.active && align <= max_align && !eosio::native::host_call_scope::active() )
+         return allocate( s, size );
+      void* ptr = align <= alignof( std::max_align_t )
+                        ? std::malloc( size ? size : 1 )
+                        : std::aligned_alloc( align, ( std::max<size_t>( size, 1 ) + align - 1 ) & ~( align - 1 ) );
+      eosio::check( ptr != nullptr, "out of memory" );
+      return ptr;
+   }
+
+   void deallocate( void* ptr ) {
+      auto& s = sim;
+      if ( !s.contains( ptr ) ) {
+         std::free( ptr );
+         return;
+      }
+      // Memory of earlier actions is gone with them
+      auto& tag = tag_of( ptr );
+      if ( !s.active || tag.generation != s.generation )
+         return;
+      tag.generation = 0;
+      s.report.live_bytes -= tag.size;
+      ++s.report.frees;
+      if ( s.free_enabled )
+         s.heap().free( static_cast<char*>( ptr ) );
+   }
+
+   std::string check_budget( const memory_report& r, const memory_budget& b ) {
+      char buf[128] = "";
+      if ( b.heap_bytes && r.heap_bytes > b.heap_bytes )
+         std::snprintf( buf, sizeof( buf ), "heap %llu B > %llu B", (unsigned long long)r.heap_bytes,
+                        (unsigned long long)b.heap_bytes );
+      else if ( b.pages && r.pages > b.pages )
+         std::snprintf( buf, sizeof( buf ), "%u pages > %u pages", r.pages, b.pages );
+      else if ( b.fragmentation && r.fragmentation > b.fragmentation )
+         std::snprintf( buf, sizeof( buf ), "fragmentation %.3f > %.3f", r.fragmentation, b.fragmentation );
+      return buf;
+   }
+
+   std::string label( const memory_report& r ) {
+      if ( r.action == name() )
+         return r.receiver.to_string();
+      if ( r.code == r.receiver )
+         return r.action.to_string();
+      return r.code.to_string() + "::" + r.action.to_string();
+   }
+
+   void write_dump() {
+      auto& r = get_registry();
+      if ( r.dump_file.empty() )
+         return;
+      std::string json = contract_memory::to_json();
+      if ( FILE* f = std::fopen( r.dump_file.c_str(), "w" ) ) {
+         std::fwrite( json.data(), 1, json.size(), f );
+         std::fclose( f );
+      } else {
+         std::fprintf( stderr, "cannot write the contract memory report to %s\n", r.dump_file.c_str() );
+      }
+   }
+
+   // EOSIO_MEMORY_REPORT=<file> simulates every action of the process, EOSIO_MEMORY_BUDGET=<bytes>
+   // limits their heap
+   [[maybe_unused]] const bool enabled_from_environment = [] {
+      if ( const char* budget = std::getenv( "EOSIO_MEMORY_BUDGET" ); budget && *budget )
+         get_registry().budget.heap_bytes = std::strtoull( budget, nullptr, 10 );
+      if ( const char* file = std::getenv( "EOSIO_MEMORY_REPORT" ); file && *file ) {
+         contract_memory::enable();
+         contract_memory::dump_at_exit( file );
+         return true;
+      }
+      return false;
+   }();
+} // namespace
+
+namespace eosio { namespace native {
+
+std::string memory_report::to_string() const {
+   char buf[192];
+   std::snprintf( buf, sizeof( buf ),
+                  ": heap %llu B (peak live %llu B, live %llu B), %u pages, %u grows, fragmentation %.3f%s",
+                  (unsigned long long)heap_bytes, (unsigned long long)peak_live_bytes, (unsigned long long)live_bytes,
+                  pages, page_grows, fragmentation, completed ? "" : ", failed" );
+   return label( *this ) + buf;
+}
+
+void contract_memory::enable( bool on ) { is_enabled.store( on, std::memory_order_relaxed ); }
+
+bool contract_memory::enabled() { return is_enabled.load( std::memory_order_relaxed ); }
+
+void contract_memory::set_max_pages( uint32_t pages ) { max_pages_setting.store( pages, std::memory_order_relaxed ); }
+
+uint32_t contract_memory::get_max_pages() { return max_pages_setting.load( std::memory_order_relaxed ); }
+
+void contract_memory::set_heap_base( uint32_t bytes ) { heap_base_setting.store( bytes, std::memory_order_relaxed ); }
+
+uint32_t contract_memory::get_heap_base() { return heap_base_setting.load( std::memory_order_relaxed ); }
+
+void contract_memory::set_budget( const memory_budget& budget ) {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   r.budget = budget;
+}
+
+memory_budget contract_memory::get_budget() {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   return r.budget;
+}
+
+std::vector<memory_report> contract_memory::reports() {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   return r.reports;
+}
+
+void contract_memory::reset() {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   r.reports.clear();
+}
+
+std::string contract_memory::to_json() {
+   std::string json = "{\"actions\":[";
+   bool        first = true;
+   for ( const auto& r : reports() ) {
+      char buf[384];
+      std::snprintf( buf, sizeof( buf ),
+                     "%s\n  {\"receiver\":\"%s\",\"code\":\"%s\",\"action\":\"%s\",\"completed\":%s,\"heap_bytes\":%llu,"
+                     "\"live_bytes\":%llu,\"peak_live_bytes\":%llu,\"allocations\":%llu,\"frees\":%llu,\"pages\":%u,"
+                     "\"page_grows\":%u,\"fragmentation\":%.4f}",
+                     first ? "" : ",", r.receiver.to_string().c_str(), r.code.to_string().c_str(),
+                     r.action.to_string().c_str(), r.completed ? "true" : "false", (unsigned long long)r.heap_bytes,
+                     (unsigned long long)r.live_bytes, (unsigned long long)r.peak_live_bytes,
+                     (unsigned long long)r.allocations, (unsigned long long)r.frees, r.pages, r.page_grows,
+                     r.fragmentation );
+      json += buf;
+      first = false;
+   }
+   json += "\n]}\n";
+   return json;
+}
+
+void contract_memory::dump_at_exit( std::string filename ) {
+   auto& r = get_registry();
+   {
+      std::lock_guard<std::mutex> lock( r.mtx );
+      bool                        registered = !r.dump_file.empty();
+      r.dump_file                            = std::move( filename );
+      if ( registered )
+         return;
+   }
+   std::atexit( write_dump );
+}
+
+}} // namespace eosio::native
+
+extern "C" {
+
+// Called by chaindb::apply and by the dispatcher eosio-codegen generates
+void eosio_memory_action_begin( uint64_t receiver, uint64_t code, uint64_t action ) {
+   begin( sim, name( receiver ), name( code ), name( action ) );
+}
+
+// Fails the action when it exceeded the budget
+void eosio_memory_action_end() {
+   auto& s = sim;
+   if ( !s.active )
+      return;
+   measure( s );
+   auto        budget  = eosio::native::contract_memory::get_budget();
+   std::string problem = check_budget( s.report, budget );
+   finish( s, problem.empty() ); // an action over budget fails
+   eosio::check( problem.empty(), "memory budget exceeded by " + label( s.report ) + ": " + problem );
+}
+
+// Closes an action that threw
+void eosio_memory_action_abort() {
+   if ( sim.active )
+      finish( sim, false );
+}
+
+void eosio_malloc_enable_free() { sim.free_enabled = true; }
+
+void eosio_malloc_disable_free() { sim.free_enabled = false; }
+
+} // extern "C"
+
+void* operator new( std::size_t size ) { return allocate( size, alignof( std::max_align_t ) ); }
+void* operator new[]( std::size_t size ) { return allocate( size, alignof( std::max_align_t ) ); }
+void* operator new( std::size_t size, std::align_val_t align ) { return allocate( size, size_t( align ) ); }
+void* operator new[]( std::size_t size, std::align_val_t align ) { return allocate( size, size_t( align ) ); }
+void  operator delete( void* p ) noexcept { deallocate( p ); }
+void  operator delete[]( void* p ) noexcept { deallocate( p ); }
+void  operator delete( void* p, std::size_t ) noexcept { deallocate( p ); }
+void  operator delete[]( void* p, std::size_t ) noexcept { deallocate( p ); }
+void  operator delete( void* p, std::align_val_t ) noexcept { deallocate( p ); }
+void  operator delete[]( void* p, std::align_val_t ) noexcept { deallocate( p ); }
+void  operator delete( void* p, std::size_t, std::align_val_t ) noexcept { deallocate( p ); }
+void  operator delete[]( void* p, std::size_t, std::align_val_t ) noexcept { deallocate( p ); }
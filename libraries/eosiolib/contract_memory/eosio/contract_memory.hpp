@@ -0,0 +1,118 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <eosio/name.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    *  @defgroup contract_memory Contract Memory
+    *  @ingroup core
+    *  @brief Runs native actions on the wasm heap allocator, in a simulated linear memory
+    *
+    *  Linking `eosio::contract_memory` replaces the global `operator new` and `operator delete`.
+    *  While simulation is enabled, each action starts with a fresh linear memory, as it does on
+    *  chain, and its allocations are served by the allocator contracts link in wasm builds
+    *  (`dsmalloc`). The memory grows one 64 KiB page at a time up to the chain's limit, and freeing
+    *  only reuses memory after `eosio::malloc_enable_free()`. An action that needs more memory than
+    *  the chain allows fails with the chain's "failed to allocate pages" error.
+    *
+    *  Actions are the ones `eosio::chaindb::apply` runs, and the ones the dispatcher generated for
+    *  a contract runs. Allocations made by natively implemented intrinsics, such as the chaindb
+    *  rows, stay on the process heap. Everything else an action allocates is only valid until the
+    *  next action starts on the same thread, and must be freed on that thread.
+    *
+    *  Each action produces a `memory_report`. When a `memory_budget` is set, an action exceeding
+    *  it fails, which rolls back its `chaindb::apply` and fails the test that ran it.
+    *
+    *  Simulation is off by default. Setting the environment variable `EOSIO_MEMORY_REPORT` to a
+    *  file name enables it at startup and writes the reports there as JSON when the process exits.
+    *
+    *  **Example:**
+    *  ```
+    *     eosio::native::contract_memory::enable();
+    *     eosio::native::contract_memory::set_budget({ .heap_bytes = 4 << 20 });
+    *     eosio::chaindb::apply("mycontract"_n, [] { mycontract::migrate(...); });
+    *     auto peak = eosio::native::contract_memory::reports().back().heap_bytes;
+    *  ```
+    */
+
+   /**
+    *  Memory used by one action.
+    *
+    *  @ingroup contract_memory
+    */
+   struct memory_report {
+      name     receiver;
+      name     code;
+      name     action;                ///< empty for `chaindb::apply`
+      bool     completed       = true; ///< false if the action threw
+      uint64_t heap_bytes      = 0;    ///< peak heap: bytes handed out by the allocator, headers and rounding included
+      uint64_t live_bytes      = 0;    ///< bytes requested and not yet freed when the action ended
+      uint64_t peak_live_bytes = 0;    ///< most bytes requested and not yet freed at any point
+      uint64_t allocations     = 0;
+      uint64_t frees           = 0;
+      uint32_t pages           = 0;    ///< memory size at the end, in 64 KiB pages
+      uint32_t page_grows      = 0;    ///< calls that grew the memory
+      double   fragmentation   = 0;    ///< 1 - peak_live_bytes / heap_bytes: share of the heap never in use at once
+
+      /// `transfer: heap 81936 B (peak live 61440 B, live 0 B), 2 pages, 1 grows, fragmentation 0.25`
+      std::string to_string() const;
+   };
+
+   /**
+    *  Limits an action must stay within; 0 means no limit.
+    *
+    *  @ingroup contract_memory
+    */
+   struct memory_budget {
+      uint64_t heap_bytes    = 0;
+      uint32_t pages         = 0;
+      double   fragmentation = 0;
+   };
+
+   /**
+    *  @ingroup contract_memory
+    */
+   class contract_memory {
+    public:
+      static constexpr uint32_t page_size       = 65536;
+      static constexpr uint32_t chain_max_pages = 528; ///< 33 MiB, the chain's default limit
+
+      /// Starts or stops simulating; takes effect at the next action
+      static void enable( bool on = true );
+      static bool enabled();
+
+      /// Maximum size of the linear memory, in pages
+      static void     set_max_pages( uint32_t pages );
+      static uint32_t get_max_pages();
+
+      /// Bytes below the heap: the stack and the contract's static data. Defaults to 8192, the stack
+      /// size `add_contract` gives contracts.
+      static void     set_heap_base( uint32_t bytes );
+      static uint32_t get_heap_base();
+
+      static void          set_budget( const memory_budget& budget );
+      static memory_budget get_budget();
+
+      /// Reports of the actions run so far, oldest first
+      static std::vector<memory_report> reports();
+
+      /// Drops the reports
+      static void reset();
+
+      /// `{"actions":[{"receiver":..,"code":..,"action":..,"completed":..,"heap_bytes":..,...},...]}`
+      static std::string to_json();
+
+      /// Writes `to_json()` to `filename` when the process exits
+      static void dump_at_exit( std::string filename );
+   };
+
+}} // namespace eosio::native
@@ -0,0 +1,79 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+#include <eosio/name.hpp>
+
+#include <cstring>
+#include <type_traits>
+
+/// @cond IMPLEMENTATIONS
+
+// Runtime of the binary smart contract trace format (`--smart-contract-trace-format=binary`).
+// Instrumented code records checkpoint ids, optionally with a scalar value, into a ring buffer.
+// The dispatcher flushes the buffer once per action as a single `cdt.trace` event whose data is
+//
+//    uint32_t   dropped   number of oldest records overwritten because the buffer was full
+//    varuint32  count     number of records that follow, oldest first
+//    count x {
+//       varuint32  id << 3 | kind
+//       uint64_t   value  present unless kind is binary_trace_kind::none
+//    }
+//
+// The buffer and the flush live in binary_trace.cpp, which the reference to binary_trace_state
+// links into instrumented contracts only; the dispatcher calls the flush through a weak reference.
+//
+// eosio-trace-decode turns the event data back into a readable trace using the checkpoint map
+// written by eosio-codegen next to the instrumented source.
+namespace eosio { namespace internal_use_do_not_use {
+
+   enum class binary_trace_kind : uint32_t {
+      none     = 0,
+      signed_  = 1,
+      unsigned_= 2,
+      floating = 3,
+      name     = 4
+   };
+
+   struct binary_trace_record {
+      uint32_t tag;
+      uint64_t value;
+   };
+
+   struct binary_trace_buffer {
+      static constexpr uint32_t capacity = 1024;
+      binary_trace_record records[capacity];
+      uint32_t            total;
+   };
+
+   extern binary_trace_buffer binary_trace_state;
+
+   inline void binary_trace(uint32_t id, binary_trace_kind kind = binary_trace_kind::none, uint64_t value = 0) {
+      auto& state = binary_trace_state;
+      state.records[state.total % binary_trace_buffer::capacity] = {id << 3 | static_cast<uint32_t>(kind), value};
+      ++state.total;
+   }
+
+   template <typename T>
+   inline void binary_trace_var(uint32_t id, const T& v) {
+      using type = std::decay_t<T>;
+      if constexpr (std::is_same_v<type, bool> || (std::is_integral_v<type> && std::is_unsigned_v<type>)) {
+         binary_trace(id, binary_trace_kind::unsigned_, static_cast<uint64_t>(v));
+      } else if constexpr (std::is_integral_v<type> || std::is_enum_v<type>) {
+         binary_trace(id, binary_trace_kind::signed_, static_cast<uint64_t>(static_cast<int64_t>(v)));
+      } else if constexpr (std::is_floating_point_v<type>) {
+         double d = v;
+         uint64_t bits;
+         memcpy(&bits, &d, sizeof(bits));
+         binary_trace(id, binary_trace_kind::floating, bits);
+      } else if constexpr (std::is_same_v<type, eosio::name>) {
+         binary_trace(id, binary_trace_kind::name, v.value);
+      } else {
+         binary_trace(id);
+      }
+   }
+
+}} // namespace eosio::internal_use_do_not_use
+
+/// @endcond
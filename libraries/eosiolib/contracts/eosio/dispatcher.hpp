@@ -179,6 +179,7 @@ extern "C" { \
          } \
          /* does not allow destructor of thiscontract to run: eosio_exit(0); */ \
       } \
+      eosio::flush_print(); \
    } \
 } \
 
@@ -206,6 +207,7 @@ extern "C" { \
    __attribute__((weak, export_name("apply"), visibility("default"))) \
    void apply( uint64_t receiver, uint64_t code, uint64_t action ) { \
       NAMESPACE :: eosio_apply( receiver, code, action ); \
+      eosio::flush_print(); \
    }\
 }\
 
@@ -8,6 +8,7 @@
 #include <eosio/key_value.hpp>
 #include <eosio/multi_index.hpp>
 #include <eosio/dispatcher.hpp>
+#include <eosio/result_stream.hpp>
 #include <eosio/contract.hpp>
 #include <eosio/map.hpp>
 #include <eosio/kv.hpp>
@@ -79,7 +79,7 @@ namespace detail {
          uint32_t value_size;
 
          auto primary_key = primary_index->get_key_void(value);
-         auto tbl_key = full_key(make_prefix(table_name, primary_index->index_name), primary_key);
+         auto tbl_key = full_key(primary_index->prefix, primary_key);
 
          auto primary_key_found = ::eosio::internal_use_do_not_use::kv_get(contract_name.value, tbl_key.data(), tbl_key.size(), value_size);
 
@@ -94,7 +94,7 @@ namespace detail {
          eosio::name payer = contract_name;
          for (const auto& idx : secondary_indices) {
             uint32_t value_size;
-            auto sec_tbl_key = full_key(make_prefix(table_name, idx->index_name), idx->get_key_void(value));
+            auto sec_tbl_key = full_key(idx->prefix, idx->get_key_void(value));
             auto sec_found = ::eosio::internal_use_do_not_use::kv_get(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), value_size);
 
             if (!primary_key_found) {
@@ -111,7 +111,7 @@ namespace detail {
                   eosio::check(copy_size == tbl_key.size() && res == 0, "Attempted to update an existing secondary index.");
 
                } else {
-                  auto old_sec_key = full_key(make_prefix(table_name, idx->index_name), idx->get_key_void(old_value));
+                  auto old_sec_key = full_key(idx->prefix, idx->get_key_void(old_value));
                   ::eosio::internal_use_do_not_use::kv_erase(contract_name.value, old_sec_key.data(), old_sec_key.size());
                   ::eosio::internal_use_do_not_use::kv_set(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), tbl_key.data(), tbl_key.size(), payer.value);
                }
@@ -131,7 +131,7 @@ namespace detail {
          uint32_t value_size;
 
          auto primary_key = primary_index->get_key_void(value);
-         auto tbl_key = full_key(make_prefix(table_name, primary_index->index_name), primary_key);
+         auto tbl_key = full_key(primary_index->prefix, primary_key);
          auto primary_key_found = ::eosio::internal_use_do_not_use::kv_get(contract_name.value, tbl_key.data(), tbl_key.size(), value_size);
 
          if (!primary_key_found) {
@@ -139,7 +139,7 @@ namespace detail {
          }
 
          for (const auto& idx : secondary_indices) {
-            auto sec_tbl_key = full_key(make_prefix(table_name, idx->index_name), idx->get_key_void(value));
+            auto sec_tbl_key = full_key(idx->prefix, idx->get_key_void(value));
             ::eosio::internal_use_do_not_use::kv_erase(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size());
          }
 
@@ -788,6 +788,7 @@ protected:
 
       primary_index_name = primary_index->index_name;
 
+      secondary_indices.reserve(sizeof...(indices));
       (setup_indices(indices), ...);
    }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <eosio/crypto_utils.hpp>
 #include <eosio/name.hpp>
 #include <eosio/to_key.hpp>
 
@@ -94,25 +95,11 @@ struct key_type : protected std::vector<char> {
 
 
    std::string to_hex() const {
-      const char* hex_characters = "0123456789abcdef";
-
-      uint32_t buffer_size = 2 * size();
+      uint32_t buffer_size = hex_encoded_size(size());
       check(buffer_size >= size(), "length passed into printhex is too large");
 
-      auto free_memory = [buffer_size](char* buf) { if (detail::max_stack_buffer_size < buffer_size) free(buf);};
-      std::unique_ptr<char, decltype(free_memory)> buffer( (char*)(detail::max_stack_buffer_size < buffer_size ? malloc(buffer_size) : alloca(buffer_size)), free_memory);
-
-      char* b = buffer.get();
-      const uint8_t* d = reinterpret_cast<const uint8_t*>(data());
-      for(uint32_t i = 0; i < size(); ++i) {
-         *b = hex_characters[d[i] >> 4];
-         ++b;
-         *b = hex_characters[d[i] & 0x0f];
-         ++b;
-      }
-
-      std::string ret{buffer.get(), buffer_size};
-
+      std::string ret(buffer_size, '\0');
+      hex_encode({data(), size()}, {ret.data(), ret.size()});
       return ret;
    }
 
@@ -130,26 +117,17 @@ struct full_key : public key_type {
    using key_type::key_type;
 
    full_key(const partial_key& a, const partial_key& b) {
-      *this += a + b;
+      reserve(a.size() + b.size());
+      *this += a;
+      *this += b;
    }
 
    static full_key from_hex( const std::string_view& str ) {
       full_key out;
 
       check( str.size() % 2 == 0, "invalid hex string length" );
-      out.reserve( str.size() / 2 );
-
-      auto start = str.data();
-      auto end   = start + str.size();
-      for(const char* p = start; p != end; p+=2 ) {
-          auto hic = p[0];
-          auto lowc = p[1];
-
-          uint8_t hi  = hic  <= '9' ? hic-'0' : 10+(hic-'a');
-          uint8_t low = lowc <= '9' ? lowc-'0' : 10+(lowc-'a');
-
-          out.push_back( char((hi << 4) | low) );
-      }
+      out.resize( str.size() / 2 );
+      check( hex_decode( str, {out.data(), out.size()} ) >= 0, "invalid hex string" );
 
       return out;
    }
@@ -170,8 +148,18 @@ inline partial_key make_key(const partial_key& t) {
    return t;
 }
 
+/**
+ * Same encoding as make_key(std::make_tuple(status, table_name, index_name)): the status byte followed by both
+ * names in big-endian order, written directly into a single 17 byte buffer.
+ */
 inline partial_key make_prefix(eosio::name table_name, eosio::name index_name, uint8_t status = 1) {
-   return make_key(std::make_tuple(status, table_name, index_name));
+   char buffer[1 + 2 * sizeof(uint64_t)];
+   buffer[0] = status;
+   for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+      buffer[1 + i]                    = char(table_name.value >> (56 - 8 * i));
+      buffer[1 + sizeof(uint64_t) + i] = char(index_name.value >> (56 - 8 * i));
+   }
+   return partial_key(buffer, sizeof(buffer));
 }
 
 /* @endcond */
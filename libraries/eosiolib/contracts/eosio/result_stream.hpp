@@ -0,0 +1,106 @@
+#pragma once
+#include <eosio/datastream.hpp>
+#include <eosio/dispatcher.hpp>
+
+#include <cstring>
+#include <vector>
+
+namespace eosio {
+
+   /**
+    * Streams the elements of a `std::vector<T>` action result directly into their packed form.
+    *
+    * Elements are serialized as soon as they are pushed, so an action never materializes the whole result
+    * vector, and the packed result is handed to `set_action_return_value` from a single buffer. The packed
+    * bytes are identical to those of `std::vector<T>` and abigen describes the result as `T[]`.
+    *
+    * @ingroup dispatcher
+    * @tparam T - The element type of the result
+    *
+    * Example:
+    * @code
+    * [[eosio::action, eosio::read_only]]
+    * eosio::result_stream<row> get() {
+    *    eosio::result_stream<row> result;
+    *    for (auto it = tbl.id.begin(); it != tbl.id.end(); ++it)
+    *       result.push_back(it.value());
+    *    return result;
+    * }
+    * @endcode
+    */
+   template <typename T>
+   class result_stream {
+      // room for the varuint32 element count, filled in once all the elements are known
+      static constexpr size_t count_space = 5;
+
+    public:
+      /**
+       * Construct an empty result stream
+       *
+       * @param reserve_bytes - The expected size of the packed elements, used to size the buffer up front
+       */
+      explicit result_stream(size_t reserve_bytes = 0) : _buffer(count_space) {
+         _buffer.reserve(count_space + reserve_bytes);
+      }
+
+      /**
+       * Serialize an element at the end of the result
+       *
+       * @param value - The element to append
+       */
+      void push_back(const T& value) {
+         const size_t size = pack_size(value);
+         const size_t pos  = _buffer.size();
+         _buffer.resize(pos + size);
+         datastream<char*> ds(_buffer.data() + pos, size);
+         ds << value;
+         ++_count;
+      }
+
+      template <typename... Args>
+      void emplace_back(Args&&... args) {
+         push_back(T{std::forward<Args>(args)...});
+      }
+
+      uint32_t size() const { return _count; }
+      bool     empty() const { return _count == 0; }
+
+      /// The packed elements, without the element count prefix
+      const char* elements_data() const { return _buffer.data() + count_space; }
+      size_t      elements_size() const { return _buffer.size() - count_space; }
+
+      /**
+       * Set the packed result as the action return value with a single host call
+       */
+      void write_return_value() {
+         char*  begin = write_count_prefix();
+         ::set_action_return_value(begin, _buffer.data() + _buffer.size() - begin);
+      }
+
+    private:
+      char* write_count_prefix() {
+         char     prefix[count_space];
+         size_t   len = 0;
+         uint32_t val = _count;
+         do {
+            uint8_t b = val & 0x7f;
+            val >>= 7;
+            b |= ((val > 0) << 7);
+            prefix[len++] = b;
+         } while (val);
+         char* begin = _buffer.data() + count_space - len;
+         std::memcpy(begin, prefix, len);
+         return begin;
+      }
+
+      std::vector<char> _buffer;
+      uint32_t          _count = 0;
+   };
+
+   template <typename T, typename S>
+   void to_bin(const result_stream<T>& obj, S& stream) {
+      varuint32_to_bin(obj.size(), stream);
+      stream.write(obj.elements_data(), obj.elements_size());
+   }
+
+} // namespace eosio
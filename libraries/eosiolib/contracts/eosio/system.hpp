@@ -10,7 +10,12 @@
 #include <eosio/serialize.hpp>
 #include <eosio/datastream.hpp>
 extern "C" {
+#ifdef __wasm__
    void eosio_malloc_enable_free();
+#else
+   // defined natively by eosio::contract_memory
+   __attribute__((weak)) void eosio_malloc_enable_free();
+#endif
 }
 namespace eosio {
   namespace internal_use_do_not_use {
@@ -101,6 +106,9 @@ namespace eosio {
    inline void malloc_enable_free() { 
       #ifdef __wasm__
          eosio_malloc_enable_free();
+      #else
+         if (eosio_malloc_enable_free)
+            eosio_malloc_enable_free();
       #endif
    }
 
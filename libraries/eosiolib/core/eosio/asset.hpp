@@ -1,16 +1,50 @@
 #pragma once
 
 #include <eosio/abieos_asset.hpp>
+#include <eosio/name.hpp>
 #include <eosio/print.hpp>
+#include <eosio/symbol.hpp>
 
 namespace eosio {
 
+/**
+ *  Largest number of characters written by `write_asset`: sign, "0.", 255 fractional digits,
+ *  a space and seven letters.
+ */
+inline constexpr uint32_t max_asset_chars = 1 + 2 + 255 + 1 + 7;
+
+/**
+ *  Largest number of characters written by `write_extended_asset`.
+ */
+inline constexpr uint32_t max_extended_asset_chars = max_asset_chars + 1 + max_name_chars;
+
+/**
+ *  Writes the string form of `obj`, e.g. "1.0000 EOS", as `asset::to_string` returns it, without
+ *  allocating. Returns one past the last character written.
+ */
+inline char* write_asset(char* out, const asset& obj) {
+   out    = write_fixed(out, obj.amount, obj.symbol.precision());
+   *out++ = ' ';
+   return write_symbol_code(out, obj.symbol.code());
+}
+
+/**
+ *  Writes the string form of `obj`, e.g. "1.0000 EOS@eosio.token".
+ */
+inline char* write_extended_asset(char* out, const extended_asset& obj) {
+   out    = write_asset(out, obj.quantity);
+   *out++ = '@';
+   return write_name(out, obj.contract);
+}
+
 inline void print(asset obj) {
-   print(obj.to_string());
+   char buf[max_asset_chars];
+   internal_use_do_not_use::console_write(buf, write_asset(buf, obj) - buf);
 }
 
 inline void print(extended_asset obj) {
-   print(obj.to_string());
+   char buf[max_extended_asset_chars];
+   internal_use_do_not_use::console_write(buf, write_extended_asset(buf, obj) - buf);
 }
 
 }
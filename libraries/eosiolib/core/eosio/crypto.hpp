@@ -6,6 +6,11 @@
 
 #include <eosio/abieos_crypto.hpp>
 #include <eosio/fixed_bytes.hpp>
+#include <eosio/serialize.hpp>
+
+#include <span>
+#include <string_view>
+#include <vector>
 
 namespace eosio {
 
@@ -109,6 +114,16 @@ namespace eosio {
     */
    eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig );
 
+   /**
+    *  Calculates the public key used for a given signature on a given digest.
+    *
+    *  @ingroup crypto
+    *  @param digest - Digest of the message that was signed
+    *  @param sig - Signature already serialized with `eosio::pack`, e.g. taken directly from action data
+    *  @return eosio::public_key - Recovered public key
+    */
+   eosio::public_key recover_key( const eosio::checksum256& digest, std::span<const char> sig );
+
    /**
     *  Tests a given public key with the recovered public key from digest and signature.
     *
@@ -119,6 +134,16 @@ namespace eosio {
     */
    void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey );
 
+   /**
+    *  Tests a given public key with the recovered public key from digest and signature.
+    *
+    *  @ingroup crypto
+    *  @param digest - Digest of the message that was signed
+    *  @param sig - Signature already serialized with `eosio::pack`
+    *  @param pubkey - Public key already serialized with `eosio::pack`
+    */
+   void assert_recover_key( const eosio::checksum256& digest, std::span<const char> sig, std::span<const char> pubkey );
+
 
    /**
     * @ingroup crypto
@@ -148,7 +173,7 @@ namespace eosio {
     * @ingroup crypto
     * @param msg - Message
     * @param msg_len - Message length
-    * @param sig - Signature in Base64 encoding format
+    * @param sig - Signature in Base64 encoding format, at most `rsa_public_key::max_size` bytes once decoded
     * @param sig_len - Signature length
     * @param pubkey - RSA public key in X.509 SubjectPublicKeyInfo format, PEM encoded
     * @param pubkey_len - Public key length
@@ -159,12 +184,52 @@ namespace eosio {
    /**
     * @ingroup crypto
     * @param msg - Message
-    * @param sig - Signature in Base64 encoding format
+    * @param sig - Signature in Base64 encoding format, at most `rsa_public_key::max_size` bytes once decoded
     * @param key - RSA public key in X.509 SubjectPublicKeyInfo format, PEM encoded
-    * @return bool - If the signature matches the message and public key, return true; otherwise, return false
+    * @return bool - If the signature matches the message and public key, return true; otherwise, return false.
+    *                Longer signatures return false without calling the intrinsic.
     */
    bool verify_rsa_sha256_sig( const std::string& msg, const std::string& sig, const std::string& pubkey );
 
+   /**
+    *  RSA public key held as its big-endian modulus and public exponent.
+    *
+    *  Parsing a PEM key is far more expensive than verifying a signature with it. Parse the key once
+    *  with `from_pem`, keep the result (it can be stored in a table), and verify with the
+    *  `verify_rsa_sha256_sig` overload taking an `rsa_public_key`, which does not allocate.
+    *
+    *  @ingroup crypto
+    */
+   struct rsa_public_key {
+      /// Largest supported modulus and exponent in bytes (8192 bit keys)
+      static constexpr uint32_t max_size = 1024;
+
+      std::vector<char> modulus;
+      std::vector<char> exponent;
+
+      /**
+       * Parses an RSA public key in X.509 SubjectPublicKeyInfo format, PEM encoded.
+       * Fails with `eosio::check` if the key is not supported.
+       *
+       * @param pem - PEM encoded public key
+       * @return rsa_public_key - The parsed key
+       */
+      static rsa_public_key from_pem( std::string_view pem );
+
+      EOSLIB_SERIALIZE( rsa_public_key, (modulus)(exponent) )
+   };
+
+   /**
+    * @ingroup crypto
+    * @param msg - Message
+    * @param msg_len - Message length
+    * @param sig - Signature bytes (not hex or Base64 encoded)
+    * @param sig_len - Signature length, at most `rsa_public_key::max_size`
+    * @param pubkey - Parsed RSA public key
+    * @return bool - If the signature matches the message and public key, return true; otherwise, return false
+    */
+   bool verify_rsa_sha256_sig( const char* msg, uint32_t msg_len, const char* sig, uint32_t sig_len, const rsa_public_key& pubkey );
+
    /**
     * @ingroup crypto
     * @param key - RSA public key PEM string
@@ -198,6 +263,62 @@ namespace eosio {
 
    bool is_supported_ecdsa_pubkey( const std::string& pubkey );
 
+   /**
+    *  One message, signature and ECDSA public key to verify with `verify_ecdsa_sigs`.
+    *  Encodings are the same as for `verify_ecdsa_sig`.
+    *
+    *  @ingroup crypto
+    */
+   struct ecdsa_sig_item {
+      std::string_view msg;
+      std::string_view sig;
+      std::string_view pubkey;
+   };
+
+   /**
+    *  One message, raw signature bytes and parsed RSA public key to verify with `verify_rsa_sha256_sigs`.
+    *
+    *  @ingroup crypto
+    */
+   struct rsa_sig_item {
+      std::string_view msg;
+      std::string_view sig;
+      const rsa_public_key* pubkey = nullptr;
+   };
+
+   /**
+    *  Verifies a batch of ECDSA signatures.
+    *
+    *  In a contract the intrinsic is called once per item. In the native tester build the items are spread
+    *  across a thread pool.
+    *
+    *  @ingroup crypto
+    *  @param items - Signatures to verify
+    *  @param results - Optional, receives the result of every item and must then be `items.size()` long;
+    *                   without it verification stops at the first failure
+    *  @return bool - true if every signature verified
+    */
+   bool verify_ecdsa_sigs( std::span<const ecdsa_sig_item> items, std::span<bool> results = {} );
+
+   /**
+    *  Verifies a batch of RSA SHA-256 signatures, see `verify_ecdsa_sigs`.
+    *  Consecutive items sharing a public key only encode that key once.
+    *
+    *  @ingroup crypto
+    *  @param items - Signatures to verify
+    *  @param results - Optional, receives the result of every item and must then be `items.size()` long
+    *  @return bool - true if every signature verified
+    */
+   bool verify_rsa_sha256_sigs( std::span<const rsa_sig_item> items, std::span<bool> results = {} );
+
+   namespace internal_use_do_not_use {
+      /**
+       * Calls `fn` on consecutive sub-ranges covering [0, n). Runs on the calling thread in a contract;
+       * the native tester library replaces it with a thread pool, so `fn` must be safe to run concurrently.
+       */
+      void parallel_for( uint32_t n, void (*fn)(void* ctx, uint32_t begin, uint32_t end), void* ctx );
+   }
+
 
    auto pb_serialize(auto& archive, const public_key& v) {
       return archive(public_key_to_string(v));
@@ -2,85 +2,204 @@
 
 #include "name.hpp"
 
+#include <array>
+#include <cstring>
+#include <span>
 #include <string_view>
 
 namespace eosio {
 
-   // base64 and hex functions are adapted from fc base64.cpp and hex.cpp
-   static inline bool is_base64_char(unsigned char c) {
-      return isalnum(c) || c == '+' || c == '/';
-   }
-
-   static constexpr uint8_t base64_lookup[128] = {
-      255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, // 16
-      255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, // 32
-      255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255, 255,  63, // 48
-       52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255, // 64
-      255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14, // 80
-       15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255, 255, // 96
-      255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40, // 112
-       41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255  // 128
-   };
+   // base64 and hex codecs are table driven and write into caller provided buffers; the std::string
+   // returning functions below are thin wrappers kept for existing callers
+   namespace detail {
+      constexpr char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+      // maps a character to its 6 bit value, invalid characters have the high bit set
+      constexpr std::array<uint8_t, 256> make_base64_lookup() {
+         std::array<uint8_t, 256> t{};
+         for (auto& v : t) v = 0xff;
+         for (uint8_t i = 0; i < 64; ++i) t[uint8_t(base64_chars[i])] = i;
+         return t;
+      }
 
-   static inline std::string base64_decode(std::string_view const& encoded_string) {
-      int in_len = encoded_string.size();
-      int i = 0;
-      int j = 0;
-      int in_ = 0;
-      unsigned char char_array_4[4], char_array_3[3];
-      std::string ret;
-      ret.reserve(in_len / 3 * 4);
-
-      while (in_len-- && encoded_string[in_] != '=') {
-         if(!is_base64_char(encoded_string[in_])) {
-            return "";
-         }
-         char_array_4[i++] = encoded_string[in_]; in_++;
-         if (i == 4) {
-            for (i = 0; i < 4; i++) {
-                char_array_4[i] = base64_lookup[char_array_4[i]];
-            }
-            char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-            char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-            char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+      // maps a character to its nibble value, invalid characters have the high bit set
+      constexpr std::array<uint8_t, 256> make_hex_lookup() {
+         std::array<uint8_t, 256> t{};
+         for (auto& v : t) v = 0xff;
+         for (uint8_t i = 0; i < 10; ++i) t['0' + i] = i;
+         for (uint8_t i = 0; i < 6; ++i) t['a' + i] = t['A' + i] = 10 + i;
+         return t;
+      }
 
-            for (i = 0; i < 3; i++) {
-               ret += char_array_3[i];
-            }
-            i = 0;
+      // both hex digits of every byte value, so encoding is one lookup per byte
+      constexpr std::array<char, 512> make_hex_pairs() {
+         std::array<char, 512> t{};
+         for (uint32_t i = 0; i < 256; ++i) {
+            t[2*i]   = "0123456789abcdef"[i >> 4];
+            t[2*i+1] = "0123456789abcdef"[i & 0x0f];
          }
+         return t;
       }
 
-      if (i) {
-         for (j = i; j < 4; j++) {
-            char_array_4[j] = 0;
-         }
+      inline constexpr auto base64_lookup = make_base64_lookup();
+      inline constexpr auto hex_lookup    = make_hex_lookup();
+      inline constexpr auto hex_pairs     = make_hex_pairs();
+   } // ns eosio::detail
 
-         for (j = 0; j < 4; j++) {
-            char_array_4[j] = base64_lookup[char_array_4[j]];
-         }
+   constexpr uint32_t hex_encoded_size( uint32_t n ) { return 2 * n; }
+   constexpr uint32_t base64_encoded_size( uint32_t n ) { return (n + 2) / 3 * 4; }
+   constexpr uint32_t base64_decoded_max_size( uint32_t n ) { return (n + 3) / 4 * 3; }
 
-         char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-         char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-         char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+   static inline bool is_base64_char(unsigned char c) {
+      return detail::base64_lookup[c] < 64;
+   }
+
+   /**
+    * Writes the lowercase hex encoding of `in` to `out`, which must hold `hex_encoded_size(in.size())` chars.
+    *
+    * @return number of chars written
+    */
+   static inline uint32_t hex_encode( std::span<const char> in, std::span<char> out ) {
+      const uint32_t n = in.size();
+      const uint8_t* src = reinterpret_cast<const uint8_t*>(in.data());
+      char* dst = out.data();
+      const char* pairs = detail::hex_pairs.data();
+      uint32_t i = 0;
+      for (; i + 4 <= n; i += 4, dst += 8) {
+         memcpy(dst,     pairs + 2 * src[i],     2);
+         memcpy(dst + 2, pairs + 2 * src[i + 1], 2);
+         memcpy(dst + 4, pairs + 2 * src[i + 2], 2);
+         memcpy(dst + 6, pairs + 2 * src[i + 3], 2);
+      }
+      for (; i < n; ++i, dst += 2) {
+         memcpy(dst, pairs + 2 * src[i], 2);
+      }
+      return 2 * n;
+   }
+
+   /**
+    * Decodes hex digits of either case from `in` into `out`, which must hold `in.size() / 2` bytes.
+    *
+    * @return number of bytes written, or -1 if `in` has an odd length or a non hex character
+    */
+   static inline int32_t hex_decode( std::string_view in, std::span<char> out ) {
+      if (in.size() % 2 != 0 || out.size() < in.size() / 2) {
+         return -1;
+      }
+      const uint8_t* src = reinterpret_cast<const uint8_t*>(in.data());
+      const uint8_t* lookup = detail::hex_lookup.data();
+      const uint32_t n = in.size() / 2;
+      char* dst = out.data();
+      uint8_t bad = 0;
+      uint32_t i = 0;
+      for (; i + 4 <= n; i += 4, src += 8) {
+         uint8_t h0 = lookup[src[0]], l0 = lookup[src[1]];
+         uint8_t h1 = lookup[src[2]], l1 = lookup[src[3]];
+         uint8_t h2 = lookup[src[4]], l2 = lookup[src[5]];
+         uint8_t h3 = lookup[src[6]], l3 = lookup[src[7]];
+         bad |= h0 | l0 | h1 | l1 | h2 | l2 | h3 | l3;
+         dst[i]     = char((h0 << 4) | l0);
+         dst[i + 1] = char((h1 << 4) | l1);
+         dst[i + 2] = char((h2 << 4) | l2);
+         dst[i + 3] = char((h3 << 4) | l3);
+      }
+      for (; i < n; ++i, src += 2) {
+         uint8_t h = lookup[src[0]], l = lookup[src[1]];
+         bad |= h | l;
+         dst[i] = char((h << 4) | l);
+      }
+      return (bad & 0x80) ? -1 : int32_t(n);
+   }
+
+   /**
+    * Writes the padded base64 encoding of `in` to `out`, which must hold `base64_encoded_size(in.size())` chars.
+    *
+    * @return number of chars written
+    */
+   static inline uint32_t base64_encode( std::span<const char> in, std::span<char> out ) {
+      const uint32_t n = in.size();
+      const uint8_t* src = reinterpret_cast<const uint8_t*>(in.data());
+      const char* chars = detail::base64_chars;
+      char* dst = out.data();
+      uint32_t i = 0;
+      for (; i + 3 <= n; i += 3, dst += 4) {
+         uint32_t v = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8) | src[i + 2];
+         dst[0] = chars[(v >> 18) & 0x3f];
+         dst[1] = chars[(v >> 12) & 0x3f];
+         dst[2] = chars[(v >> 6) & 0x3f];
+         dst[3] = chars[v & 0x3f];
+      }
+      if (i < n) {
+         uint32_t v = uint32_t(src[i]) << 16;
+         if (i + 1 < n) v |= uint32_t(src[i + 1]) << 8;
+         dst[0] = chars[(v >> 18) & 0x3f];
+         dst[1] = chars[(v >> 12) & 0x3f];
+         dst[2] = i + 1 < n ? chars[(v >> 6) & 0x3f] : '=';
+         dst[3] = '=';
+         dst += 4;
+      }
+      return dst - out.data();
+   }
 
-         for (j = 0; j < i - 1; j++) {
-            ret += char_array_3[j];
+   /**
+    * Decodes base64 from `in` into `out`, which must hold `base64_decoded_max_size(in.size())` bytes.
+    * Trailing '=' padding is optional.
+    *
+    * @return number of bytes written, or -1 if `in` is not valid base64
+    */
+   static inline int32_t base64_decode( std::string_view in, std::span<char> out ) {
+      uint32_t n = in.size();
+      for (int pad = 0; pad < 2 && n > 0 && in[n - 1] == '='; ++pad) {
+         --n;
+      }
+      if (n % 4 == 1 || out.size() < base64_decoded_max_size(n)) {
+         return -1;
+      }
+      const uint8_t* src = reinterpret_cast<const uint8_t*>(in.data());
+      const uint8_t* lookup = detail::base64_lookup.data();
+      char* dst = out.data();
+      uint8_t bad = 0;
+      uint32_t i = 0;
+      for (; i + 4 <= n; i += 4, dst += 3) {
+         uint8_t a = lookup[src[i]], b = lookup[src[i + 1]], c = lookup[src[i + 2]], d = lookup[src[i + 3]];
+         bad |= a | b | c | d;
+         uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+         dst[0] = char(v >> 16);
+         dst[1] = char(v >> 8);
+         dst[2] = char(v);
+      }
+      if (i < n) {
+         uint8_t a = lookup[src[i]], b = lookup[src[i + 1]], c = i + 2 < n ? lookup[src[i + 2]] : 0;
+         bad |= a | b | c;
+         uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6);
+         *dst++ = char(v >> 16);
+         if (i + 2 < n) {
+            *dst++ = char(v >> 8);
          }
       }
+      return (bad & 0x80) ? -1 : int32_t(dst - out.data());
+   }
 
+   static inline std::string base64_decode(std::string_view const& encoded_string) {
+      std::string ret(base64_decoded_max_size(encoded_string.size()), '\0');
+      int32_t len = base64_decode(encoded_string, std::span<char>(ret.data(), ret.size()));
+      if (len < 0) {
+         return "";
+      }
+      ret.resize(len);
       return ret;
    }
 
    static inline std::string to_hex( const char* d, uint32_t s ) {
-      std::string r;
-      const char* to_hex="0123456789abcdef";
-      uint8_t* c = (uint8_t*)d;
-      for( uint32_t i = 0; i < s; ++i ) {
-         (r += to_hex[(c[i]>>4)]) += to_hex[(c[i] &0x0f)];
-      }
+      std::string r(hex_encoded_size(s), '\0');
+      hex_encode({d, s}, {r.data(), r.size()});
       return r;
-    }
+   }
+
+   // writes 2 * s hex digits to out
+   static inline void to_hex( const char* d, uint32_t s, char* out ) {
+      hex_encode({d, s}, {out, hex_encoded_size(s)});
+   }
 
    static inline std::string base64_to_hex( const std::string_view& base64_str) {
       std::string decoded = base64_decode(base64_str);
@@ -96,19 +215,16 @@ namespace eosio {
       return r;
    }
 
-   static inline std::string strip_header_trailer(const std::string_view& in) {
-      const std::string header = "-----BEGIN PUBLIC KEY-----";
-      const std::string trailer = "-----END PUBLIC KEY-----";
+   static inline std::string_view strip_header_trailer(std::string_view in) {
+      constexpr std::string_view header = "-----BEGIN PUBLIC KEY-----";
+      constexpr std::string_view trailer = "-----END PUBLIC KEY-----";
 
-      std::string r{in};
-      if (r.compare(0, header.size(), header) != 0 || 
-          r.compare(r.size() - trailer.size(), trailer.size(), trailer) != 0) {
-         return "";
+      if (in.size() < header.size() + trailer.size() ||
+          in.substr(0, header.size()) != header ||
+          in.substr(in.size() - trailer.size()) != trailer) {
+         return {};
       }
-      r.erase(0, header.size());
-      r.erase(r.end() - trailer.size(), r.end());
-
-      return r;
+      return in.substr(header.size(), in.size() - header.size() - trailer.size());
    }
 
    struct rsa_key_parser {
@@ -227,18 +343,19 @@ namespace eosio {
       }
    };
 
-   static inline int parse_rsa_pubkey(const std::string& pubkey, std::string& mod, std::string& exp) {
+   // parses a PEM encoded X.509 SubjectPublicKeyInfo RSA key into its big-endian modulus and exponent bytes
+   static inline int parse_rsa_pubkey_bytes(std::string_view pubkey, std::string& mod_bytes, std::string& exp_bytes) {
       std::string key_stripped = strip_newline(pubkey);
       if (key_stripped.empty()) {
          return -1;
       }
 
-      key_stripped = strip_header_trailer(key_stripped);
-      if (key_stripped.empty()) {
+      std::string_view key_base64 = strip_header_trailer(key_stripped);
+      if (key_base64.empty()) {
          return -1;
       }
 
-      std::string key = base64_decode(key_stripped);
+      std::string key = base64_decode(key_base64);
       if (key.size() < 2) { // "0x30**"
          return -1;
       }
@@ -266,18 +383,26 @@ namespace eosio {
          return -1;
       }
 
-      std::string mod_bytes = parser.read_int();
+      mod_bytes = parser.read_int();
       if (mod_bytes.empty()) {
          return -1;
       }
-      mod = to_hex(mod_bytes.data(), mod_bytes.size());
 
-      std::string exp_bytes = parser.read_int();
+      exp_bytes = parser.read_int();
       if (exp_bytes.empty()) {
          return -1;
       }
-      exp = to_hex(exp_bytes.data(), exp_bytes.size());
 
       return 0;
    }
+
+   static inline int parse_rsa_pubkey(const std::string& pubkey, std::string& mod, std::string& exp) {
+      std::string mod_bytes, exp_bytes;
+      if (parse_rsa_pubkey_bytes(pubkey, mod_bytes, exp_bytes) != 0) {
+         return -1;
+      }
+      mod = to_hex(mod_bytes.data(), mod_bytes.size());
+      exp = to_hex(exp_bytes.data(), exp_bytes.size());
+      return 0;
+   }
 }
@@ -0,0 +1,167 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace eosio {
+
+   /**
+    *  @defgroup decimal Decimal Formatting
+    *  @ingroup core
+    *  @brief Allocation-free integer and fixed-point formatting into caller buffers
+    *
+    *  Digits are produced two at a time from a 200 character table, back to front, after the exact
+    *  length has been computed, so every writer does one pass over its output and no reversal.
+    *  Writers take a pointer to the first character and return one past the last one written; the
+    *  caller provides enough room (see `max_decimal_chars` and `fixed_decimal_size`).
+    */
+
+   namespace detail {
+      inline constexpr auto decimal_digit_pairs = [] {
+         std::array<char, 200> pairs{};
+         for ( int i = 0; i < 100; ++i ) {
+            pairs[2 * i]     = '0' + i / 10;
+            pairs[2 * i + 1] = '0' + i % 10;
+         }
+         return pairs;
+      }();
+
+      inline constexpr auto decimal_powers = [] {
+         std::array<uint64_t, 20> powers{};
+         powers[0] = 1;
+         for ( size_t i = 1; i < powers.size(); ++i )
+            powers[i] = powers[i - 1] * 10;
+         return powers;
+      }();
+
+      // number of decimal digits in `v`, counting 0 as one digit
+      inline uint32_t decimal_digits( uint64_t v ) {
+         uint32_t t = ( (64 - __builtin_clzll( v | 1 )) * 1233 ) >> 12; // floor(log10(v)) or one above it
+         return t + 1 - ( (v | 1) < decimal_powers[t] );
+      }
+
+      // writes the digits of `v` so that they end just before `end`; returns the first digit
+      inline char* write_digits_backward( char* end, uint64_t v ) {
+         while ( v >= 100 ) {
+            end -= 2;
+            memcpy( end, decimal_digit_pairs.data() + (v % 100) * 2, 2 );
+            v /= 100;
+         }
+         if ( v >= 10 ) {
+            end -= 2;
+            memcpy( end, decimal_digit_pairs.data() + v * 2, 2 );
+         } else {
+            *--end = '0' + v;
+         }
+         return end;
+      }
+
+      // writes exactly `width` digits of `v`, zero padded on the left
+      inline void write_digits_padded( char* out, uint64_t v, uint32_t width ) {
+         char* first = write_digits_backward( out + width, v );
+         memset( out, '0', first - out );
+      }
+   } // namespace detail
+
+   /**
+    *  Largest number of characters written by `write_unsigned` / `write_signed` for `T`.
+    *
+    *  @ingroup decimal
+    */
+   template <typename T>
+   inline constexpr uint32_t max_decimal_chars = std::numeric_limits<T>::digits10 + 1 + std::is_signed_v<T>;
+
+   /**
+    *  Writes `v` in decimal. `T` may be any unsigned integer up to 128 bits.
+    *
+    *  @ingroup decimal
+    */
+   template <typename T>
+   inline char* write_unsigned( char* out, T v ) {
+      static_assert( std::is_unsigned_v<T> || std::is_same_v<T, unsigned __int128> );
+      if constexpr ( sizeof(T) > sizeof(uint64_t) ) {
+         if ( v > std::numeric_limits<uint64_t>::max() ) {
+            constexpr uint64_t chunk = detail::decimal_powers[19];
+            out = write_unsigned( out, T(v / chunk) );
+            detail::write_digits_padded( out, uint64_t(v % chunk), 19 );
+            return out + 19;
+         }
+      }
+      char* end = out + detail::decimal_digits( uint64_t(v) );
+      detail::write_digits_backward( end, uint64_t(v) );
+      return end;
+   }
+
+   /**
+    *  Writes `v` in decimal with a leading '-' when negative. `T` may be any signed integer up to
+    *  128 bits, including its minimum value.
+    *
+    *  @ingroup decimal
+    */
+   template <typename T>
+   inline char* write_signed( char* out, T v ) {
+      using unsigned_t = std::make_unsigned_t<T>;
+      if ( v < 0 ) {
+         *out++ = '-';
+         return write_unsigned( out, unsigned_t(0) - unsigned_t(v) );
+      }
+      return write_unsigned( out, unsigned_t(v) );
+   }
+
+   /**
+    *  Number of characters `write_fixed` writes for the same arguments.
+    *
+    *  @ingroup decimal
+    */
+   inline uint32_t fixed_decimal_size( uint64_t magnitude, uint8_t decimals, bool negative ) {
+      uint32_t digits = detail::decimal_digits( magnitude );
+      uint32_t size   = decimals == 0 ? digits : digits > decimals ? digits + 1 : decimals + 2u;
+      return size + negative;
+   }
+
+   /**
+    *  Writes `magnitude * 10^-decimals`, e.g. `12345, 4` as "1.2345" and `5, 3` as "0.005". Exactly
+    *  `decimals` fractional digits are written and the decimal point is omitted when there are none.
+    *
+    *  @ingroup decimal
+    */
+   inline char* write_fixed( char* out, uint64_t magnitude, uint8_t decimals, bool negative ) {
+      if ( negative )
+         *out++ = '-';
+      uint32_t digits = detail::decimal_digits( magnitude );
+      if ( decimals == 0 ) {
+         detail::write_digits_backward( out + digits, magnitude );
+         return out + digits;
+      }
+      if ( digits <= decimals ) {
+         *out++ = '0';
+         *out++ = '.';
+         detail::write_digits_padded( out, magnitude, decimals );
+         return out + decimals;
+      }
+      char*    point = out + digits - decimals;
+      uint64_t scale = detail::decimal_powers[decimals];
+      detail::write_digits_backward( point, magnitude / scale );
+      *point = '.';
+      detail::write_digits_padded( point + 1, magnitude % scale, decimals );
+      return point + 1 + decimals;
+   }
+
+   /**
+    *  Writes a signed fixed-point amount, as stored in an `asset`.
+    *
+    *  @ingroup decimal
+    */
+   inline char* write_fixed( char* out, int64_t amount, uint8_t decimals ) {
+      bool negative = amount < 0;
+      return write_fixed( out, negative ? uint64_t(0) - uint64_t(amount) : uint64_t(amount), decimals, negative );
+   }
+
+} // namespace eosio
@@ -0,0 +1,177 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    *  @defgroup intrinsic_stats Intrinsic Statistics
+    *  @ingroup core
+    *  @brief Per-intrinsic call counts, bytes and wall time for native builds
+    *
+    *  Intrinsics implemented in native libraries (the `eosio::chaindb` database, the print and
+    *  assert functions of the unit test harness, and the crypto wrappers of eosiolib) record every
+    *  call while statistics are enabled. Disabled, the cost of an instrumented call is one relaxed
+    *  atomic load and a thread-local counter update. Intrinsics provided by the host process, such
+    *  as the ones native-tester implements itself, are not visible here.
+    *
+    *  Setting the environment variable `EOSIO_INTRINSIC_STATS` to a file name enables statistics
+    *  at startup and writes them there as JSON when the process exits.
+    *
+    *  **Example:**
+    *  ```
+    *     eosio::native::intrinsic_stats::enable();
+    *     eosio::chaindb::apply("mycontract"_n, [] { mycontract::transfer(...); });
+    *     auto gets = eosio::native::intrinsic_stats::get("db_get_i64").calls;
+    *  ```
+    */
+
+   /**
+    *  Counters of one intrinsic.
+    *
+    *  @ingroup intrinsic_stats
+    */
+   struct intrinsic_counters {
+      uint64_t calls       = 0;
+      uint64_t bytes_in    = 0; ///< bytes passed to the intrinsic (data, keys, messages)
+      uint64_t bytes_out   = 0; ///< bytes written back by the intrinsic
+      uint64_t nanoseconds = 0; ///< cumulative wall time, including nested intrinsic calls
+   };
+
+   /**
+    *  Counter slot of one intrinsic; instrumented functions keep a reference to theirs.
+    *
+    *  @ingroup intrinsic_stats
+    */
+   struct intrinsic_counter {
+      const char*           name;
+      std::atomic<uint64_t> calls       = 0;
+      std::atomic<uint64_t> bytes_in    = 0;
+      std::atomic<uint64_t> bytes_out   = 0;
+      std::atomic<uint64_t> nanoseconds = 0;
+
+      explicit intrinsic_counter( const char* name ) : name( name ) {}
+   };
+
+   /**
+    *  @ingroup intrinsic_stats
+    */
+   class intrinsic_stats {
+    public:
+      /// Starts or stops recording
+      static void enable( bool on = true );
+      static bool enabled() { return is_enabled.load( std::memory_order_relaxed ); }
+
+      /// Zeroes every counter
+      static void reset();
+
+      /// Counters of `name`; all zero if it was never called
+      static intrinsic_counters get( std::string_view name );
+
+      /// Counters of every intrinsic called at least once, sorted by name
+      static std::vector<std::pair<std::string, intrinsic_counters>> snapshot();
+
+      /// `{"intrinsics":{"db_get_i64":{"calls":..,"bytes_in":..,"bytes_out":..,"ns":..},...}}`
+      static std::string to_json();
+
+      /// Writes `to_json()` to `filename` when the process exits
+      static void dump_at_exit( std::string filename );
+
+      /// Counter slot for `name`, created on first use; the returned reference stays valid
+      static intrinsic_counter& counter( const char* name );
+
+      /// Monotonic clock used for the timings
+      static uint64_t now_ns();
+
+    private:
+      static inline std::atomic<bool> is_enabled = false;
+   };
+
+   /**
+    *  Records one call of an intrinsic from construction to destruction.
+    *
+    *  @ingroup intrinsic_stats
+    */
+   class intrinsic_scope {
+    public:
+      intrinsic_scope( intrinsic_counter& c, uint64_t bytes_in ) {
+         if ( intrinsic_stats::enabled() ) {
+            counter = &c;
+            counter->bytes_in.fetch_add( bytes_in, std::memory_order_relaxed );
+            start = intrinsic_stats::now_ns();
+         }
+      }
+
+      intrinsic_scope( const intrinsic_scope& ) = delete;
+      intrinsic_scope& operator=( const intrinsic_scope& ) = delete;
+
+      void add_bytes_out( uint64_t bytes ) {
+         if ( counter )
+            counter->bytes_out.fetch_add( bytes, std::memory_order_relaxed );
+      }
+
+      ~intrinsic_scope() {
+         if ( counter ) {
+            counter->nanoseconds.fetch_add( intrinsic_stats::now_ns() - start, std::memory_order_relaxed );
+            counter->calls.fetch_add( 1, std::memory_order_relaxed );
+         }
+      }
+
+    private:
+      intrinsic_counter* counter = nullptr;
+      uint64_t           start   = 0;
+   };
+
+#ifndef __wasm__
+   /**
+    *  Marks the enclosing code as the host side of an intrinsic. Allocations made there are the
+    *  host's, so `eosio::native::contract_memory` serves them from the process heap rather than
+    *  from the simulated linear memory of the running action.
+    *
+    *  @ingroup intrinsic_stats
+    */
+   class host_call_scope {
+    public:
+      host_call_scope() { ++depth; }
+      ~host_call_scope() { --depth; }
+      host_call_scope( const host_call_scope& ) = delete;
+      host_call_scope& operator=( const host_call_scope& ) = delete;
+
+      static bool active() { return depth != 0; }
+
+    private:
+      static inline thread_local uint32_t depth = 0;
+   };
+#endif
+
+}} // namespace eosio::native
+
+/// @cond IMPLEMENTATIONS
+
+#ifdef __wasm__
+#define EOSIO_INTRINSIC_STATS( NAME, BYTES_IN ) ((void)0)
+#define EOSIO_INTRINSIC_STATS_BYTES_OUT( BYTES ) ((void)0)
+#define EOSIO_HOST_CALL() ((void)0)
+#else
+/// Records the enclosing intrinsic call as `NAME`, with `BYTES_IN` bytes of input, and marks it as a host call
+#define EOSIO_INTRINSIC_STATS( NAME, BYTES_IN )                                                              \
+   EOSIO_HOST_CALL();                                                                                       \
+   static ::eosio::native::intrinsic_counter& _intrinsic_stats_counter =                                    \
+         ::eosio::native::intrinsic_stats::counter( NAME );                                                 \
+   ::eosio::native::intrinsic_scope _intrinsic_stats_scope( _intrinsic_stats_counter, ( BYTES_IN ) )
+/// Adds `BYTES` to the output of the call recorded by `EOSIO_INTRINSIC_STATS`
+#define EOSIO_INTRINSIC_STATS_BYTES_OUT( BYTES ) _intrinsic_stats_scope.add_bytes_out( BYTES )
+/// Marks the enclosing block as host code that isn't an intrinsic of its own
+#define EOSIO_HOST_CALL() ::eosio::native::host_call_scope _host_call_scope
+#endif
+
+/// @endcond
@@ -0,0 +1,217 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <eosio/check.hpp>
+#include <eosio/crypto.hpp>
+#include <eosio/serialize.hpp>
+
+#include <array>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace eosio {
+
+   /**
+    *  @defgroup merkle Merkle
+    *  @ingroup core
+    *  @brief Merkle roots, proofs and an incremental accumulator built on sha256
+    *
+    *  All helpers build the same tree. Each leaf is hashed as `sha256(0x00 || leaf)`, then nodes are
+    *  hashed pairwise level by level as `sha256(0x01 || left || right)`, and the last node of a level
+    *  with an odd number of nodes is promoted to the next level unchanged. The root of no leaves is
+    *  an all-zero checksum. As in RFC 6962, the distinct prefixes keep an internal node from being
+    *  passed off as a leaf.
+    */
+
+   namespace detail {
+      constexpr uint32_t merkle_node_size = 32;
+      constexpr char     merkle_leaf_prefix = 0x00;
+      constexpr char     merkle_node_prefix = 0x01;
+
+      inline void merkle_store( char* out, const checksum256& node ) {
+         auto bytes = node.extract_as_byte_array();
+         memcpy( out, bytes.data(), merkle_node_size );
+      }
+
+      inline checksum256 merkle_load( const char* in ) {
+         std::array<uint8_t, merkle_node_size> bytes;
+         memcpy( bytes.data(), in, merkle_node_size );
+         return checksum256( bytes );
+      }
+
+      // hashes the adjacent pair at `pair` and writes the parent to `out`, which may alias `pair`
+      inline void merkle_hash_pair( const char* pair, char* out ) {
+         char prefixed[1 + 2 * merkle_node_size];
+         prefixed[0] = merkle_node_prefix;
+         memcpy( prefixed + 1, pair, 2 * merkle_node_size );
+         merkle_store( out, sha256( prefixed, sizeof(prefixed) ) );
+      }
+
+      inline checksum256 merkle_hash_leaf( const checksum256& leaf ) {
+         char prefixed[1 + merkle_node_size];
+         prefixed[0] = merkle_leaf_prefix;
+         merkle_store( prefixed + 1, leaf );
+         return sha256( prefixed, sizeof(prefixed) );
+      }
+
+      // hashes one level of `n` nodes in place; returns the number of nodes on the next level
+      inline uint32_t merkle_reduce_level( char* nodes, uint32_t n ) {
+         uint32_t parents = 0;
+         for ( uint32_t i = 0; i + 1 < n; i += 2 )
+            merkle_hash_pair( nodes + i * merkle_node_size, nodes + parents++ * merkle_node_size );
+         if ( n % 2 )
+            memmove( nodes + parents++ * merkle_node_size, nodes + (n - 1) * merkle_node_size, merkle_node_size );
+         return parents;
+      }
+
+      // writes the hash of every leaf to `scratch`, the bottom level of the tree
+      inline void merkle_load_leaves( std::span<const checksum256> leaves, std::span<char> scratch ) {
+         check( scratch.size() >= leaves.size() * merkle_node_size, "merkle scratch buffer too small" );
+         for ( size_t i = 0; i < leaves.size(); ++i )
+            merkle_store( scratch.data() + i * merkle_node_size, merkle_hash_leaf( leaves[i] ) );
+      }
+   } // namespace detail
+
+   /**
+    *  Hashes a leaf into the node at the bottom of the tree.
+    *
+    *  @ingroup merkle
+    */
+   inline checksum256 merkle_hash_leaf( const checksum256& leaf ) { return detail::merkle_hash_leaf( leaf ); }
+
+   /**
+    *  Hashes two sibling nodes into their parent.
+    *
+    *  @ingroup merkle
+    */
+   inline checksum256 merkle_hash_pair( const checksum256& left, const checksum256& right ) {
+      char pair[1 + 2 * detail::merkle_node_size];
+      pair[0] = detail::merkle_node_prefix;
+      detail::merkle_store( pair + 1, left );
+      detail::merkle_store( pair + 1 + detail::merkle_node_size, right );
+      return sha256( pair, sizeof(pair) );
+   }
+
+   /**
+    *  Computes the root of `leaves` using `scratch`, which must hold `32 * leaves.size()` bytes,
+    *  as the only working memory. Every level is hashed in place, one sha256 call per leaf and per
+    *  parent node.
+    *
+    *  @ingroup merkle
+    */
+   inline checksum256 merkle_root( std::span<const checksum256> leaves, std::span<char> scratch ) {
+      if ( leaves.empty() )
+         return checksum256();
+      detail::merkle_load_leaves( leaves, scratch );
+      uint32_t n = leaves.size();
+      while ( n > 1 )
+         n = detail::merkle_reduce_level( scratch.data(), n );
+      return detail::merkle_load( scratch.data() );
+   }
+
+   /**
+    *  Computes the root of `leaves` with a single scratch allocation.
+    *
+    *  @ingroup merkle
+    */
+   inline checksum256 merkle_root( std::span<const checksum256> leaves ) {
+      std::vector<char> scratch( leaves.size() * detail::merkle_node_size );
+      return merkle_root( leaves, scratch );
+   }
+
+   /**
+    *  Returns the sibling nodes from the leaf at `index` up to the root, skipping levels where
+    *  the node is promoted without a sibling. The first sibling is the hash of a leaf, not the leaf.
+    *
+    *  @ingroup merkle
+    */
+   inline std::vector<checksum256> merkle_proof( std::span<const checksum256> leaves, uint32_t index ) {
+      check( index < leaves.size(), "merkle proof index out of range" );
+      std::vector<char> scratch( leaves.size() * detail::merkle_node_size );
+      detail::merkle_load_leaves( leaves, scratch );
+
+      std::vector<checksum256> proof;
+      for ( uint32_t n = leaves.size(); n > 1; index /= 2 ) {
+         uint32_t sibling = index ^ 1;
+         if ( sibling < n )
+            proof.push_back( detail::merkle_load( scratch.data() + sibling * detail::merkle_node_size ) );
+         n = detail::merkle_reduce_level( scratch.data(), n );
+      }
+      return proof;
+   }
+
+   /**
+    *  Checks that `leaf` is the leaf at `index` of a tree of `count` leaves with the given root.
+    *  The proof must have exactly one sibling per level where `count` gives the node one.
+    *
+    *  The prefixes keep a proof from passing an internal node off as a leaf, but the root still does
+    *  not commit to the number of leaves: a tree with more leaves can share the path from this
+    *  leaf, so the same proof verifies for either count. Callers must authenticate `count`, for
+    *  example by taking it from the same trusted source as `root`.
+    *
+    *  @ingroup merkle
+    */
+   inline bool verify_merkle_proof( const checksum256& leaf, uint32_t index, uint32_t count,
+                                    std::span<const checksum256> proof, const checksum256& root ) {
+      if ( index >= count )
+         return false;
+      checksum256 node = merkle_hash_leaf( leaf );
+      size_t used = 0;
+      for ( uint32_t n = count; n > 1; n = (n + 1) / 2, index /= 2 ) {
+         uint32_t sibling = index ^ 1;
+         if ( sibling >= n )
+            continue;
+         if ( used == proof.size() )
+            return false;
+         node = index % 2 ? merkle_hash_pair( proof[used], node ) : merkle_hash_pair( node, proof[used] );
+         ++used;
+      }
+      return used == proof.size() && node == root;
+   }
+
+   /**
+    *  Append-only Merkle accumulator with O(log n) state.
+    *
+    *  Only the roots of the perfect subtrees covering the leaves so far are kept (one per set bit of
+    *  `count`, largest first), so the accumulator is cheap to keep in a `singleton` and `root()`
+    *  always equals `merkle_root` over every appended leaf.
+    *
+    *  @ingroup merkle
+    */
+   struct incremental_merkle {
+      uint64_t                 count = 0;
+      std::vector<checksum256> peaks;
+
+      /**
+       *  Appends a leaf, hashing the leaf and one node per subtree it completes.
+       */
+      void append( const checksum256& leaf ) {
+         checksum256 node = merkle_hash_leaf( leaf );
+         for ( uint64_t c = count; c & 1; c >>= 1 ) {
+            node = merkle_hash_pair( peaks.back(), node );
+            peaks.pop_back();
+         }
+         peaks.push_back( node );
+         ++count;
+      }
+
+      /**
+       *  Current root, combining the peaks from the smallest subtree up.
+       */
+      checksum256 root() const {
+         if ( peaks.empty() )
+            return checksum256();
+         checksum256 node = peaks.back();
+         for ( size_t i = peaks.size() - 1; i > 0; --i )
+            node = merkle_hash_pair( peaks[i - 1], node );
+         return node;
+      }
+
+      EOSLIB_SERIALIZE( incremental_merkle, (count)(peaks) )
+   };
+
+} // namespace eosio
@@ -4,6 +4,7 @@
  */
 #pragma once
 #include "reflect.hpp"
+#include "print.hpp"
 #include <eosio/abieos_name.hpp>
 
 /// @cond IMPLEMENTATIONS
@@ -15,8 +16,35 @@ namespace eosio {
       }
    }
 
+   /**
+    *  Largest number of characters written by `write_name`.
+    */
+   inline constexpr uint32_t max_name_chars = 13;
+
+   /**
+    *  Writes the string form of `obj`, as `name::to_string` returns it, without allocating.
+    *  Returns one past the last character written.
+    */
+   inline char* write_name(char* out, name obj) {
+      constexpr char charmap[] = ".12345abcdefghijklmnopqrstuvwxyz";
+      uint64_t tmp = obj.value;
+      for (int i = 12; i >= 0; --i) {
+         out[i] = charmap[tmp & (i == 12 ? 0x0f : 0x1f)];
+         tmp >>= (i == 12 ? 4 : 5);
+      }
+      uint32_t len = 13;
+      while (len > 0 && out[len-1] == '.')
+         --len;
+      return out + len;
+   }
+
    inline void print(name obj) {
-      internal_use_do_not_use::printn(obj.value);
+      if (internal_use_do_not_use::print_buffered()) {
+         char str[max_name_chars];
+         internal_use_do_not_use::console_write(str, write_name(str, obj) - str);
+      } else {
+         internal_use_do_not_use::printn(obj.value);
+      }
    }
 
 }
@@ -3,6 +3,8 @@
  *  @copyright defined in eos/LICENSE
  */
 #pragma once
+#include "decimal.hpp"
+#include <algorithm>
 #include <utility>
 #include <string>
 #include <string_view>
@@ -35,10 +37,71 @@ namespace eosio {
          __attribute__((import_name("printn"))) void printn(uint64_t);
 
          __attribute__((import_name("printhex"))) void printhex(const void*, uint32_t);
+
+         // Defined by print_buffer.cpp, which is only linked into contracts that use
+         // EOSIO_BUFFERED_PRINT. The print functions test for it at run time, so their
+         // definitions are the same in every translation unit.
+         __attribute__((weak)) void eosio_print_buffer_write(const char*, uint32_t);
+
+         __attribute__((weak)) void eosio_print_buffer_write_double(double);
+
+         __attribute__((weak)) void eosio_print_buffer_flush();
+      }
+
+      /**
+       *  True when the contract links the print buffer, i.e. when at least one of its
+       *  translation units defines `EOSIO_BUFFERED_PRINT`.
+       */
+      inline bool print_buffered() {
+         return eosio_print_buffer_write != nullptr;
+      }
+
+      /**
+       *  Writes characters to the console. When the contract links the print buffer the
+       *  characters are appended to a per-action buffer that is handed to `prints_l`
+       *  when it fills, when the action returns and before an assertion aborts it,
+       *  otherwise they are printed immediately.
+       */
+      inline void console_write( const char* ptr, uint32_t len ) {
+         if (print_buffered())
+            eosio_print_buffer_write(ptr, len);
+         else
+            prints_l(ptr, len);
+      }
+
+      template <typename T>
+      inline void console_write_unsigned( T num ) {
+         char buf[max_decimal_chars<T>];
+         console_write(buf, write_unsigned(buf, num) - buf);
       }
 
+      template <typename T>
+      inline void console_write_signed( T num ) {
+         char buf[max_decimal_chars<T>];
+         console_write(buf, write_signed(buf, num) - buf);
+      }
    };
 
+   /**
+    *  Flushes console output held by the print buffer. Does nothing unless the
+    *  contract links the print buffer.
+    *
+    *  @ingroup console
+    */
+   inline void flush_print() {
+      if (internal_use_do_not_use::eosio_print_buffer_flush)
+         internal_use_do_not_use::eosio_print_buffer_flush();
+   }
+
+#ifdef EOSIO_BUFFERED_PRINT
+   namespace internal_use_do_not_use {
+      extern "C" const bool eosio_print_buffer_linked;
+
+      // the strong reference that links print_buffer.cpp into the contract
+      [[gnu::used]] static const bool* const eosio_print_buffer_anchor = &eosio_print_buffer_linked;
+   }
+#endif
+
    /**
     *  @defgroup console Console
     *  @ingroup core
@@ -58,6 +121,15 @@ namespace eosio {
     *  There are two ways to overload print:
     *  1. implement void print( const T& )
     *  2. implement T::print()const
+    *
+    *  @section buffering Buffered Output
+    *
+    *  Each print call normally crosses into the host. Defining `EOSIO_BUFFERED_PRINT`
+    *  before including the eosio headers in any translation unit links the print
+    *  buffer into the contract. All console output of the contract then has its numbers
+    *  formatted inside the contract and is coalesced into as few `prints_l` calls as
+    *  possible. Pending output is flushed when the action returns and before
+    *  `eosio_assert`, `eosio_assert_message` or `eosio_assert_code` aborts it.
     */
 
    /**
@@ -68,7 +140,23 @@ namespace eosio {
     *  @param size - number of bytes to print
     */
    inline void printhex( const void* ptr, uint32_t size) {
-      internal_use_do_not_use::printhex(ptr, size);
+      if (!internal_use_do_not_use::print_buffered()) {
+         internal_use_do_not_use::printhex(ptr, size);
+         return;
+      }
+      constexpr char hex_digits[] = "0123456789abcdef";
+      auto data = static_cast<const unsigned char*>(ptr);
+      char buf[64];
+      while (size) {
+         uint32_t n = std::min<uint32_t>(size, sizeof(buf) / 2);
+         for (uint32_t i = 0; i < n; ++i) {
+            buf[2*i]   = hex_digits[data[i] >> 4];
+            buf[2*i+1] = hex_digits[data[i] & 0x0f];
+         }
+         internal_use_do_not_use::console_write(buf, 2*n);
+         data += n;
+         size -= n;
+      }
    }
 
    /**
@@ -79,7 +167,7 @@ namespace eosio {
     *  @param len - number of chars to print
     */
    inline void printl( const char* ptr, size_t len ) {
-      internal_use_do_not_use::prints_l(ptr, len);
+      internal_use_do_not_use::console_write(ptr, len);
    }
 
    /**
@@ -89,7 +177,10 @@ namespace eosio {
     *  @param ptr - a null terminated string
     */
    inline void print( const char* ptr ) {
-      internal_use_do_not_use::prints(ptr);
+      if (internal_use_do_not_use::print_buffered())
+         internal_use_do_not_use::console_write(ptr, std::char_traits<char>::length(ptr));
+      else
+         internal_use_do_not_use::prints(ptr);
    }
 
    /**
@@ -99,7 +190,7 @@ namespace eosio {
     *  @param str - an std::string
     */
    inline void print( const std::string& str ) {
-      internal_use_do_not_use::prints_l(str.c_str(), str.size());
+      internal_use_do_not_use::console_write(str.c_str(), str.size());
    }
 
    /**
@@ -109,7 +200,7 @@ namespace eosio {
     *  @param str - an std::string_view
     */
    inline void print( std::string_view str ) {
-      internal_use_do_not_use::prints_l(str.data(), str.size());
+      internal_use_do_not_use::console_write(str.data(), str.size());
    }
 
    /**
@@ -120,10 +211,12 @@ namespace eosio {
    template <typename T, std::enable_if_t<std::is_integral<std::decay_t<T>>::value &&
                                           std::is_signed<std::decay_t<T>>::value, int> = 0>
    inline void print( T num ) {
-      if constexpr(std::is_same<T, int128_t>::value)
+      if constexpr(std::is_same<T, char>::value)
+        internal_use_do_not_use::console_write( &num, 1 );
+      else if (internal_use_do_not_use::print_buffered())
+        internal_use_do_not_use::console_write_signed(num);
+      else if constexpr(std::is_same<T, int128_t>::value)
         internal_use_do_not_use::printi128(&num);
-      else if constexpr(std::is_same<T, char>::value)
-        internal_use_do_not_use::prints_l( &num, 1 );
       else
         internal_use_do_not_use::printi(num);
    }
@@ -136,10 +229,12 @@ namespace eosio {
    template <typename T, std::enable_if_t<std::is_integral<std::decay_t<T>>::value &&
                                           !std::is_signed<std::decay_t<T>>::value, int> = 0>
    inline void print( T num ) {
-      if constexpr(std::is_same<T, uint128_t>::value)
+      if constexpr(std::is_same<T, bool>::value)
+         num ? internal_use_do_not_use::console_write("true", 4) : internal_use_do_not_use::console_write("false", 5);
+      else if (internal_use_do_not_use::print_buffered())
+         internal_use_do_not_use::console_write_unsigned(num);
+      else if constexpr(std::is_same<T, uint128_t>::value)
          internal_use_do_not_use::printui128(&num);
-      else if constexpr(std::is_same<T, bool>::value)
-         internal_use_do_not_use::prints(num?"true":"false");
       else
         internal_use_do_not_use::printui(num);
    }
@@ -150,7 +245,12 @@ namespace eosio {
     *  @ingroup console
     *  @param num to be printed
     */
-   inline void print( float num ) { internal_use_do_not_use::printsf( num ); }
+   inline void print( float num ) {
+      if (internal_use_do_not_use::print_buffered())
+         internal_use_do_not_use::eosio_print_buffer_write_double( num );
+      else
+         internal_use_do_not_use::printsf( num );
+   }
 
    /**
     *  Prints double-precision floating point number (i.e. double)
@@ -158,7 +258,12 @@ namespace eosio {
     *  @ingroup console
     *  @param num to be printed
     */
-   inline void print( double num ) { internal_use_do_not_use::printdf( num ); }
+   inline void print( double num ) {
+      if (internal_use_do_not_use::print_buffered())
+         internal_use_do_not_use::eosio_print_buffer_write_double( num );
+      else
+         internal_use_do_not_use::printdf( num );
+   }
 
    /**
     *  Prints quadruple-precision floating point number (i.e. long double)
@@ -166,7 +271,10 @@ namespace eosio {
     *  @ingroup console
     *  @param num to be printed
     */
-   inline void print( long double num ) { internal_use_do_not_use::printqf( &num ); }
+   inline void print( long double num ) {
+      flush_print();
+      internal_use_do_not_use::printqf( &num );
+   }
 
   /**
     *  Prints class object
@@ -188,7 +296,7 @@ namespace eosio {
     *  @param s null terminated string to be printed
     */
    inline void print_f( const char* s ) {
-      internal_use_do_not_use::prints(s);
+      print(s);
    }
 
    /**
@@ -207,14 +315,14 @@ namespace eosio {
     */
    template <typename Arg, typename... Args>
    inline void print_f( const char* s, Arg val, Args... rest ) {
-      while ( *s != '\0' ) {
-         if ( *s == '%' ) {
-            print( val );
-            print_f( s+1, rest... );
-            return;
-         }
-         internal_use_do_not_use::prints_l( s, 1 );
+      const char* literal = s;
+      while ( *s != '\0' && *s != '%' )
          s++;
+      if ( s != literal )
+         internal_use_do_not_use::console_write( literal, s - literal );
+      if ( *s == '%' ) {
+         print( val );
+         print_f( s+1, rest... );
       }
    }
 
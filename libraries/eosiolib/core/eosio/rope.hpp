@@ -1,9 +1,14 @@
 #pragma once
 
-#include <variant>
+#include <algorithm>
+#include <memory>
 #include <set>
 #include <stack>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 #include <eosio/check.hpp>
 #include <eosio/print.hpp>
 
@@ -19,14 +24,11 @@ namespace eosio {
       struct str_t {
          const char*              c_str;
          size_t                   size;
-         mutable const rope_node* temp = nullptr;
       };
       
       struct concat_t {
          rope_node*               left      = nullptr;
          rope_node*               right     = nullptr;
-         mutable const rope_node* temp      = nullptr;
-         mutable bool             temp_left = false;
       };
    }
 
@@ -38,62 +40,33 @@ namespace eosio {
          size_t size     = 0;
          
          static constexpr size_t strlen(const char* str) {
-            int i=0;
-            while (str[i++]);
+            size_t i = 0;
+            while (str[i])
+               ++i;
             return i;
          }
          
+         // later fragments hang off the left, so a left-first walk fills the buffer from the back;
+         // the walk keeps its own stack so the tree is never modified
          static void c_str(char* buffer, const rope_node* r, size_t& off) {
-            bool going_down = true;
-            if (r) {
-               std::visit([](const auto& n) {
-                  n.temp = nullptr;
-               }, *r);
-            }
-            while (r) {
-               if (going_down) {
-                  std::visit(overloaded {
-                     [&](const concat_t& c) {
-                        if (c.left) {
-                           c.temp_left = true;
-                           std::visit([&](const auto& n){
-                              n.temp = r;
-                           }, *c.left);
-                           going_down = true;
-                           r = c.left;
-                        } else if (c.right) {
-                           c.temp_left = false;
-                           std::visit([&](const auto& n){
-                              n.temp = r;
-                           }, *c.right);
-                           going_down = true;
-                           r = c.right;
-                        } else {
-                           going_down = false;
-                           r = c.temp;
-                        }
-                     },
-                     [&](const str_t& s) { 
-                        off -= s.size;
-                        memcpy(buffer+off, s.c_str, s.size);
-                        going_down = false;
-                        r = s.temp;
-                     }
-                  }, *r);
-               } else {
-                  const auto& c = std::get<concat_t>(*r);
-                  if (c.temp_left && c.right) {
-                     c.temp_left = false;
-                     std::visit([&](const auto& n){
-                        n.temp = r;
-                     }, *c.right);
-                     going_down = true;
-                     r = c.right;
-                  } else {
-                     going_down = false;
-                     r = c.temp;
+            std::vector<const rope_node*> pending;
+            if (r)
+               pending.push_back(r);
+            while (!pending.empty()) {
+               r = pending.back();
+               pending.pop_back();
+               std::visit(overloaded {
+                  [&](const concat_t& c) {
+                     if (c.right)
+                        pending.push_back(c.right);
+                     if (c.left)
+                        pending.push_back(c.left);
+                  },
+                  [&](const str_t& s) {
+                     off -= s.size;
+                     memcpy(buffer+off, s.c_str, s.size);
                   }
-               }
+               }, *r);
             }
          }
 
@@ -132,9 +105,9 @@ namespace eosio {
 
       public:
          rope(const char* s) {
-            root = new rope_node(concat_t{new rope_node(str_t{s,strlen(s)-1}), nullptr});
+            root = new rope_node(concat_t{new rope_node(str_t{s,strlen(s)}), nullptr});
             last = root;
-            size += strlen(s)-1;
+            size += strlen(s);
          }
 
          rope(std::string_view s = "") {
@@ -144,7 +117,7 @@ namespace eosio {
 
          template <size_t N> 
          inline constexpr void append(const char (&s)[N]) {
-            append(s, N);
+            append(s, N-1);
          }
 
          void append(const char* s, size_t len) {
@@ -177,7 +150,7 @@ namespace eosio {
          }
 
          constexpr rope& operator+= (const char* s) {
-            append(s, strlen(s)-1);
+            append(s, strlen(s));
             return *this;
          }
 
@@ -228,4 +201,123 @@ namespace eosio {
             return {c_str(), size};
          }
    };
+
+   /**
+    *  Append-only rope for assembling large outputs, e.g. JSON responses, from many fragments.
+    *
+    *  Fragments are recorded as (pointer, size) pairs in chunks of `fragments_per_chunk` entries,
+    *  so appending allocates once per chunk instead of once per fragment, and the total size is
+    *  tracked as fragments are added. `flatten` then copies everything into an exactly sized
+    *  buffer in one linear pass. The builder itself is never modified by flattening.
+    *
+    *  `append` only references its argument, which must outlive the builder; `append_copy` first
+    *  copies the bytes into storage owned by the builder.
+    */
+   class rope_builder {
+      public:
+         static constexpr size_t fragments_per_chunk = 256;
+         static constexpr size_t copy_chunk_size     = 4096;
+
+         rope_builder() = default;
+         rope_builder(const rope_builder&) = delete;
+         rope_builder& operator=(const rope_builder&) = delete;
+         rope_builder(rope_builder&& other) { *this = std::move(other); }
+
+         rope_builder& operator=(rope_builder&& other) {
+            head          = std::move(other.head);
+            tail          = std::exchange(other.tail, nullptr);
+            size          = std::exchange(other.size, 0);
+            count         = std::exchange(other.count, 0);
+            copies        = std::move(other.copies);
+            copy_used     = std::exchange(other.copy_used, 0);
+            copy_capacity = std::exchange(other.copy_capacity, 0);
+            return *this;
+         }
+
+         rope_builder& append(std::string_view s) {
+            if (s.empty())
+               return *this;
+            if (!tail || tail->used == fragments_per_chunk) {
+               auto c = std::make_unique<chunk>();
+               chunk* next = c.get();
+               (tail ? tail->next : head) = std::move(c);
+               tail = next;
+            }
+            tail->fragments[tail->used++] = {s.data(), s.size()};
+            size += s.size();
+            ++count;
+            return *this;
+         }
+
+         template <size_t N>
+         rope_builder& append(const char (&s)[N]) {
+            return append(std::string_view(s, N-1));
+         }
+
+         rope_builder& append_copy(std::string_view s) {
+            if (s.empty())
+               return *this;
+            if (copy_used + s.size() > copy_capacity) {
+               copy_capacity = std::max(copy_chunk_size, s.size());
+               copies.push_back(std::make_unique<char[]>(copy_capacity));
+               copy_used = 0;
+            }
+            char* dst = copies.back().get() + copy_used;
+            memcpy(dst, s.data(), s.size());
+            copy_used += s.size();
+            return append(std::string_view(dst, s.size()));
+         }
+
+         rope_builder& operator+=(std::string_view s) { return append(s); }
+
+         template <size_t N>
+         rope_builder& operator+=(const char (&s)[N]) { return append(s); }
+
+         size_t length() const { return size; }
+         size_t fragments() const { return count; }
+
+         /**
+          *  Copies the contents to `out`, which must hold `length()` bytes.
+          */
+         void flatten(char* out) const {
+            for (const chunk* c = head.get(); c; c = c->next.get()) {
+               for (size_t i = 0; i < c->used; ++i) {
+                  memcpy(out, c->fragments[i].data, c->fragments[i].size);
+                  out += c->fragments[i].size;
+               }
+            }
+         }
+
+         std::string str() const {
+            std::string ret(size, '\0');
+            flatten(ret.data());
+            return ret;
+         }
+
+         void print() const {
+            for (const chunk* c = head.get(); c; c = c->next.get())
+               for (size_t i = 0; i < c->used; ++i)
+                  eosio::print(std::string_view(c->fragments[i].data, c->fragments[i].size));
+         }
+
+      private:
+         struct fragment {
+            const char* data;
+            size_t      size;
+         };
+
+         struct chunk {
+            std::unique_ptr<chunk> next;
+            size_t                 used = 0;
+            fragment               fragments[fragments_per_chunk];
+         };
+
+         std::unique_ptr<chunk>               head;
+         chunk*                               tail  = nullptr;
+         size_t                               size  = 0;
+         size_t                               count = 0;
+         std::vector<std::unique_ptr<char[]>> copies;
+         size_t                               copy_used     = 0;
+         size_t                               copy_capacity = 0;
+   };
 } // ns eosio
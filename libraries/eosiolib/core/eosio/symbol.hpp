@@ -9,8 +9,33 @@
 
 namespace eosio {
 
+/**
+ *  Largest number of characters written by `write_symbol`: "255," and seven letters.
+ */
+inline constexpr uint32_t max_symbol_chars = 11;
+
+/**
+ *  Writes the string form of `code`, as `symbol_code::to_string` returns it, without allocating.
+ *  Returns one past the last character written.
+ */
+inline char* write_symbol_code(char* out, symbol_code code) {
+   for (uint64_t v = code.raw(); v; v >>= 8)
+      *out++ = char(v & 0xff);
+   return out;
+}
+
+/**
+ *  Writes the string form of `obj`, e.g. "4,EOS", as `symbol::to_string` returns it.
+ */
+inline char* write_symbol(char* out, symbol obj) {
+   out    = write_unsigned(out, obj.precision());
+   *out++ = ',';
+   return write_symbol_code(out, obj.code());
+}
+
 inline void print(symbol obj) {
-   print(obj.to_string());
+   char buf[max_symbol_chars];
+   internal_use_do_not_use::console_write(buf, write_symbol(buf, obj) - buf);
 }
 
 }
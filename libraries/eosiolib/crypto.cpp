@@ -3,10 +3,17 @@
  *  @copyright defined in eos/LICENSE
  */
 #include <eosio/crypto.hpp>
+#include <eosio/check.hpp>
+#include <eosio/intrinsic_stats.hpp>
 #include <eosio/datastream.hpp>
 
 #include <eosio/crypto_utils.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
 extern "C" {
    struct __attribute__((aligned (16))) capi_checksum160 { uint8_t hash[20]; };
    struct __attribute__((aligned (16))) capi_checksum256 { uint8_t hash[32]; };
@@ -44,71 +51,113 @@ extern "C" {
 namespace eosio {
 
    void assert_sha256( const char* data, uint32_t length, const eosio::checksum256& hash ) {
+      EOSIO_INTRINSIC_STATS( "assert_sha256", length );
       auto hash_data = hash.extract_as_byte_array();
       ::assert_sha256( data, length, reinterpret_cast<const ::capi_checksum256*>(hash_data.data()) );
    }
 
    void assert_sha1( const char* data, uint32_t length, const eosio::checksum160& hash ) {
+      EOSIO_INTRINSIC_STATS( "assert_sha1", length );
       auto hash_data = hash.extract_as_byte_array();
       ::assert_sha1( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
    }
 
    void assert_sha512( const char* data, uint32_t length, const eosio::checksum512& hash ) {
+      EOSIO_INTRINSIC_STATS( "assert_sha512", length );
       auto hash_data = hash.extract_as_byte_array();
       ::assert_sha512( data, length, reinterpret_cast<const ::capi_checksum512*>(hash_data.data()) );
    }
 
    void assert_ripemd160( const char* data, uint32_t length, const eosio::checksum160& hash ) {
+      EOSIO_INTRINSIC_STATS( "assert_ripemd160", length );
       auto hash_data = hash.extract_as_byte_array();
       ::assert_ripemd160( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
    }
 
    eosio::checksum256 sha256( const char* data, uint32_t length ) {
       ::capi_checksum256 hash;
+      EOSIO_INTRINSIC_STATS( "sha256", length );
+      EOSIO_INTRINSIC_STATS_BYTES_OUT( 32 );
       ::sha256( data, length, &hash );
       return {hash.hash};
    }
 
    eosio::checksum160 sha1( const char* data, uint32_t length ) {
       ::capi_checksum160 hash;
+      EOSIO_INTRINSIC_STATS( "sha1", length );
+      EOSIO_INTRINSIC_STATS_BYTES_OUT( 20 );
       ::sha1( data, length, &hash );
       return {hash.hash};
    }
 
    eosio::checksum512 sha512( const char* data, uint32_t length ) {
       ::capi_checksum512 hash;
+      EOSIO_INTRINSIC_STATS( "sha512", length );
+      EOSIO_INTRINSIC_STATS_BYTES_OUT( 64 );
       ::sha512( data, length, &hash );
       return {hash.hash};
    }
 
    eosio::checksum160 ripemd160( const char* data, uint32_t length ) {
       ::capi_checksum160 hash;
+      EOSIO_INTRINSIC_STATS( "ripemd160", length );
+      EOSIO_INTRINSIC_STATS_BYTES_OUT( 20 );
       ::ripemd160( data, length, &hash );
       return {hash.hash};
    }
 
-   eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig ) {
-      auto digest_data = digest.extract_as_byte_array();
+   namespace {
+      // larger scratch buffers are taken from the heap to keep them off the contract stack
+      constexpr uint32_t max_stack_buffer_size = 512;
+
+      struct scratch_buffer_deleter {
+         uint32_t size;
+         void operator()( char* buf ) const { if ( max_stack_buffer_size < size ) free(buf); }
+      };
+      using scratch_buffer = std::unique_ptr<char, scratch_buffer_deleter>;
+
+      // a macro because alloca has to run in the frame that uses the buffer
+      #define EOSIO_SCRATCH_BUFFER(size) \
+         scratch_buffer( (char*)(max_stack_buffer_size < (size) ? malloc(size) : alloca(size)), scratch_buffer_deleter{size} )
+
+      // K1 and R1 keys and signatures (variant index 0 and 1) have a fixed packed size and are
+      // serialized on the stack; only the variable length WebAuthn forms are packed to the heap
+      constexpr uint32_t max_packed_ecc_public_key_size = 1 + 33;
+      constexpr uint32_t max_packed_ecc_signature_size  = 1 + 65;
+
+      template <uint32_t BufferSize, typename T, typename F>
+      auto with_packed( const T& v, F&& f ) {
+         if ( v.index() < 2 ) {
+            char buffer[BufferSize];
+            eosio::datastream<char*> ds( buffer, BufferSize );
+            ds << v;
+            return f( std::span<const char>( buffer, ds.tellp() ) );
+         }
+         auto packed = eosio::pack( v );
+         return f( std::span<const char>( packed.data(), packed.size() ) );
+      }
+   }
 
-      auto sig_data = eosio::pack(sig);
+   eosio::public_key recover_key( const eosio::checksum256& digest, std::span<const char> sig ) {
+      EOSIO_INTRINSIC_STATS( "recover_key", 32 + sig.size() );
+      auto digest_data = digest.extract_as_byte_array();
 
       char optimistic_pubkey_data[256];
       uint32_t pubkey_size = ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
-                                          sig_data.data(), sig_data.size(),
+                                          sig.data(), sig.size(),
                                           optimistic_pubkey_data, sizeof(optimistic_pubkey_data) );
 
+      EOSIO_INTRINSIC_STATS_BYTES_OUT( pubkey_size );
       eosio::public_key pubkey;
       if ( pubkey_size <= sizeof(optimistic_pubkey_data) ) {
          eosio::datastream<const char*> pubkey_ds( optimistic_pubkey_data, pubkey_size );
          pubkey_ds >> pubkey;
       } else {
-         constexpr static uint32_t max_stack_buffer_size = 512;
-
          auto free_memory = [pubkey_size](char* buf) { if (max_stack_buffer_size < pubkey_size) free(buf);};
          std::unique_ptr<char, decltype(free_memory)> pubkey_data( (char*)(max_stack_buffer_size < pubkey_size ? malloc(pubkey_size) : alloca(pubkey_size)), free_memory);
 
          ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
-                        sig_data.data(), sig_data.size(),
+                        sig.data(), sig.size(),
                         pubkey_data.get(), pubkey_size );
          eosio::datastream<const char*> pubkey_ds( pubkey_data.get(), pubkey_size );
          pubkey_ds >> pubkey;
@@ -116,18 +165,31 @@ namespace eosio {
       return pubkey;
    }
 
-   void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey ) {
-      auto digest_data = digest.extract_as_byte_array();
+   eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig ) {
+      return with_packed<max_packed_ecc_signature_size>( sig, [&]( std::span<const char> sig_data ) {
+         return recover_key( digest, sig_data );
+      });
+   }
 
-      auto sig_data = eosio::pack(sig);
-      auto pubkey_data = eosio::pack(pubkey);
+   void assert_recover_key( const eosio::checksum256& digest, std::span<const char> sig, std::span<const char> pubkey ) {
+      EOSIO_INTRINSIC_STATS( "assert_recover_key", 32 + sig.size() + pubkey.size() );
+      auto digest_data = digest.extract_as_byte_array();
 
       ::assert_recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
-                            sig_data.data(), sig_data.size(),
-                            pubkey_data.data(), pubkey_data.size() );
+                            sig.data(), sig.size(),
+                            pubkey.data(), pubkey.size() );
+   }
+
+   void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey ) {
+      with_packed<max_packed_ecc_signature_size>( sig, [&]( std::span<const char> sig_data ) {
+         with_packed<max_packed_ecc_public_key_size>( pubkey, [&]( std::span<const char> pubkey_data ) {
+            assert_recover_key( digest, sig_data, pubkey_data );
+         });
+      });
    }
 
    bool verify_rsa_sha256_sig( const char* msg, uint32_t msg_len, const char* sig, uint32_t sig_len, const char* exp, uint32_t exp_len, const char* mod, uint32_t mod_len) {
+      EOSIO_INTRINSIC_STATS( "verify_rsa_sha256_sig", msg_len + sig_len + exp_len + mod_len );
       return ::verify_rsa_sha256_sig( msg, msg_len, 
                                       sig, sig_len, 
                                       exp, exp_len, 
@@ -141,21 +203,80 @@ namespace eosio {
                                     mod.data(), mod.size() );
    }
 
+   namespace {
+      // The intrinsic takes hex strings. All parameters are bounded by rsa_public_key::max_size, so they are
+      // hex encoded into one static buffer, which would take most of the contract stack and keeps the
+      // overloads taking binary inputs free of allocations. Native batches verify on several threads.
+      constexpr uint32_t rsa_hex_buffer_size = hex_encoded_size(3 * rsa_public_key::max_size);
+#ifdef __wasm__
+      char rsa_hex_buffer[rsa_hex_buffer_size];
+#else
+      thread_local char rsa_hex_buffer[rsa_hex_buffer_size];
+#endif
+
+      bool verify_rsa_sha256_sig_bytes( const char* msg, uint32_t msg_len, const char* sig, uint32_t sig_len,
+                                        const char* exp, uint32_t exp_len, const char* mod, uint32_t mod_len ) {
+         if ( sig_len == 0 || sig_len > rsa_public_key::max_size || exp_len > rsa_public_key::max_size || mod_len > rsa_public_key::max_size ) {
+            return false;
+         }
+
+         char* sig_hex = rsa_hex_buffer;
+         char* exp_hex = sig_hex + hex_encoded_size(sig_len);
+         char* mod_hex = exp_hex + hex_encoded_size(exp_len);
+         to_hex( sig, sig_len, sig_hex );
+         to_hex( exp, exp_len, exp_hex );
+         to_hex( mod, mod_len, mod_hex );
+
+         EOSIO_INTRINSIC_STATS( "verify_rsa_sha256_sig", msg_len + hex_encoded_size(sig_len + exp_len + mod_len) );
+         return ::verify_rsa_sha256_sig( msg, msg_len,
+                                         sig_hex, hex_encoded_size(sig_len),
+                                         exp_hex, hex_encoded_size(exp_len),
+                                         mod_hex, hex_encoded_size(mod_len) );
+      }
+   }
+
    bool verify_rsa_sha256_sig( const std::string& msg, const std::string& sig, const std::string& pubkey ) {
-      std::string sig_hex = base64_to_hex(strip_newline(sig));
-      if (sig_hex.empty()) {
+      std::string stripped;
+      std::string_view sig_base64 = sig;
+      if ( sig_base64.find('\n') != std::string_view::npos ) {
+         stripped = strip_newline(sig_base64);
+         sig_base64 = stripped;
+      }
+      // longer signatures cannot be verified by verify_rsa_sha256_sig_bytes, which bounds the hex buffer
+      if ( sig_base64.size() > base64_encoded_size(rsa_public_key::max_size) ) {
+         return false;
+      }
+
+      const uint32_t sig_size = base64_decoded_max_size(sig_base64.size());
+      auto sig_buffer = EOSIO_SCRATCH_BUFFER(sig_size);
+      char* sig_bytes = sig_buffer.get();
+      int32_t sig_len = base64_decode( sig_base64, {sig_bytes, sig_size} );
+      if ( sig_len <= 0 ) {
          return false;
       }
 
       std::string mod, exp;
-      if (parse_rsa_pubkey(pubkey, mod, exp) != 0) {
+      if ( parse_rsa_pubkey_bytes(pubkey, mod, exp) != 0 ) {
          return false;
       }
 
-      return verify_rsa_sha256_sig( msg.data(), msg.size(),
-                                    sig_hex.data(), sig_hex.size(),
-                                    exp.data(), exp.size(),
-                                    mod.data(), mod.size() );
+      return verify_rsa_sha256_sig_bytes( msg.data(), msg.size(), sig_bytes, sig_len,
+                                          exp.data(), exp.size(), mod.data(), mod.size() );
+   }
+
+   #undef EOSIO_SCRATCH_BUFFER
+
+   rsa_public_key rsa_public_key::from_pem( std::string_view pem ) {
+      std::string mod, exp;
+      eosio::check( parse_rsa_pubkey_bytes(pem, mod, exp) == 0 && mod.size() <= max_size && exp.size() <= max_size,
+                    "unsupported RSA public key" );
+      return { {mod.begin(), mod.end()}, {exp.begin(), exp.end()} };
+   }
+
+   bool verify_rsa_sha256_sig( const char* msg, uint32_t msg_len, const char* sig, uint32_t sig_len, const rsa_public_key& pubkey ) {
+      return verify_rsa_sha256_sig_bytes( msg, msg_len, sig, sig_len,
+                                          pubkey.exponent.data(), pubkey.exponent.size(),
+                                          pubkey.modulus.data(), pubkey.modulus.size() );
    }
 
    bool verify_rsa_sha256_sig( const char* msg, uint32_t msg_len, const char* sig, uint32_t sig_len, const char* pubkey, uint32_t pubkey_len ) {
@@ -172,13 +293,14 @@ namespace eosio {
    }
 
    bool verify_ecdsa_sig( const char* msg, uint32_t msg_len, const char* sig, uint32_t sig_len, const char* pubkey, uint32_t pubkey_len ) {
+      EOSIO_INTRINSIC_STATS( "verify_ecdsa_sig", msg_len + sig_len + pubkey_len );
       return ::verify_ecdsa_sig( msg, msg_len, sig, sig_len, pubkey, pubkey_len);
    }
 
    bool verify_ecdsa_sig( const std::string& msg, const std::string& sig, const std::string& pubkey ) {
-      return ::verify_ecdsa_sig( msg.data(), msg.size(), 
-                                 sig.data(), sig.size(), 
-                                 pubkey.data(), pubkey.size() );
+      return verify_ecdsa_sig( msg.data(), msg.size(), 
+                               sig.data(), sig.size(), 
+                               pubkey.data(), pubkey.size() );
    }
 
    bool is_supported_ecdsa_pubkey( const char* pubkey, uint32_t pubkey_len ) {
@@ -188,4 +310,92 @@ namespace eosio {
    bool is_supported_ecdsa_pubkey( const std::string& pubkey ) {
       return ::is_supported_ecdsa_pubkey( pubkey.data(), pubkey.size());
    }
+
+   namespace internal_use_do_not_use {
+      __attribute__((weak)) void parallel_for( uint32_t n, void (*fn)(void* ctx, uint32_t begin, uint32_t end), void* ctx ) {
+         if ( n > 0 ) {
+            fn( ctx, 0, n );
+         }
+      }
+   }
+
+   namespace {
+      template <typename Item>
+      struct sig_batch {
+         std::span<const Item> items;
+         std::span<bool>       results;
+         std::atomic<bool>     failed = false;   // only ever set to true, lets chunks stop early
+
+         bool done() const { return results.empty() && failed.load(std::memory_order_relaxed); }
+
+         void record( uint32_t i, bool ok ) {
+            if ( !results.empty() ) {
+               results[i] = ok;
+            }
+            if ( !ok ) {
+               failed.store(true, std::memory_order_relaxed);
+            }
+         }
+      };
+
+      template <typename Item, typename F>
+      bool run_sig_batch( sig_batch<Item>& batch, F chunk ) {
+         eosio::check( batch.results.empty() || batch.results.size() == batch.items.size(), "results must be empty or match the number of items" );
+         eosio::check( batch.items.size() <= std::numeric_limits<uint32_t>::max(), "too many items" );
+         internal_use_do_not_use::parallel_for( batch.items.size(), chunk, &batch );
+         return !batch.failed;
+      }
+
+      bool rsa_item_in_bounds( const rsa_sig_item& item ) {
+         return item.pubkey && !item.sig.empty() && item.sig.size() <= rsa_public_key::max_size &&
+                item.pubkey->exponent.size() <= rsa_public_key::max_size && item.pubkey->modulus.size() <= rsa_public_key::max_size;
+      }
+   }
+
+   bool verify_ecdsa_sigs( std::span<const ecdsa_sig_item> items, std::span<bool> results ) {
+      sig_batch<ecdsa_sig_item> batch{ items, results };
+      return run_sig_batch( batch, [](void* ctx, uint32_t begin, uint32_t end) {
+         auto& b = *static_cast<sig_batch<ecdsa_sig_item>*>(ctx);
+         for ( uint32_t i = begin; i < end && !b.done(); ++i ) {
+            const auto& item = b.items[i];
+            EOSIO_INTRINSIC_STATS( "verify_ecdsa_sig", item.msg.size() + item.sig.size() + item.pubkey.size() );
+            b.record( i, ::verify_ecdsa_sig( item.msg.data(), item.msg.size(),
+                                             item.sig.data(), item.sig.size(),
+                                             item.pubkey.data(), item.pubkey.size() ) );
+         }
+      });
+   }
+
+   bool verify_rsa_sha256_sigs( std::span<const rsa_sig_item> items, std::span<bool> results ) {
+      sig_batch<rsa_sig_item> batch{ items, results };
+
+      // items out of bounds fail without calling the intrinsic; the key stays encoded while it repeats
+      return run_sig_batch( batch, [](void* ctx, uint32_t begin, uint32_t end) {
+         auto& b = *static_cast<sig_batch<rsa_sig_item>*>(ctx);
+         char* key_hex = rsa_hex_buffer;
+         char* sig_hex = key_hex + hex_encoded_size(2 * rsa_public_key::max_size);
+         const rsa_public_key* encoded_key = nullptr;
+
+         for ( uint32_t i = begin; i < end && !b.done(); ++i ) {
+            const auto& item = b.items[i];
+            if ( !rsa_item_in_bounds(item) ) {
+               b.record( i, false );
+               continue;
+            }
+            const uint32_t exp_len = item.pubkey->exponent.size();
+            const uint32_t mod_len = item.pubkey->modulus.size();
+            if ( item.pubkey != encoded_key ) {
+               to_hex( item.pubkey->exponent.data(), exp_len, key_hex );
+               to_hex( item.pubkey->modulus.data(), mod_len, key_hex + hex_encoded_size(exp_len) );
+               encoded_key = item.pubkey;
+            }
+            to_hex( item.sig.data(), item.sig.size(), sig_hex );
+            EOSIO_INTRINSIC_STATS( "verify_rsa_sha256_sig", item.msg.size() + hex_encoded_size(item.sig.size() + exp_len + mod_len) );
+            b.record( i, ::verify_rsa_sha256_sig( item.msg.data(), item.msg.size(),
+                                                  sig_hex, hex_encoded_size(item.sig.size()),
+                                                  key_hex, hex_encoded_size(exp_len),
+                                                  key_hex + hex_encoded_size(exp_len), hex_encoded_size(mod_len) ) );
+         }
+      });
+   }
 }
@@ -1,14 +1,10 @@
 #include <eosio/print.hpp>
-#include <string.h>
 
 namespace eosio { namespace internal_use_do_not_use {
 
 extern "C" void printi(int64_t value) {
-   if (value < 0) {
-      prints("-");
-      printui(-value);
-   } else
-      printui(value);
+   char s[max_decimal_chars<int64_t>];
+   prints_l(s, write_signed(s, value) - s);
 }
 
 }} // namespace eosio::internal_use_do_not_use
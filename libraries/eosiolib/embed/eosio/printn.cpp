@@ -1,9 +1,10 @@
-#include <eosio/chain_conversions.hpp>
-#include <eosio/print.hpp>
-#include <string.h>
+#include <eosio/name.hpp>
 
 namespace eosio { namespace internal_use_do_not_use {
 
-extern "C" void printn(uint64_t n) { print(name_to_string(n)); }
+extern "C" void printn(uint64_t n) {
+   char s[max_name_chars];
+   prints_l(s, write_name(s, name{n}) - s);
+}
 
 }} // namespace eosio::internal_use_do_not_use
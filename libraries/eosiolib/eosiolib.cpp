@@ -1,4 +1,5 @@
 #include <eosio/datastream.hpp>
+#include <eosio/decimal.hpp>
 #include <eosio/powers.hpp>
 #include <eosio/system.hpp>
 #include <eosio/privileged.hpp>
@@ -111,50 +112,10 @@ namespace eosio {
     *  @post If the output string fits within the range [begin, end), the range [begin, returned pointer) contains the string representation of the number. Nothing is written if dry_run == true or returned pointer > end (insufficient space) or if returned pointer < begin (overflow in calculating desired end).
     */
    char* write_decimal( char* begin, char* end, bool dry_run, uint64_t number, uint8_t num_decimal_places, bool negative ) {
-      const auto& powers_of_ten = powers_of_base<10, uint64_t>;
-
-      uint8_t num_digits = (std::upper_bound( powers_of_ten.begin(), powers_of_ten.end(), number ) - powers_of_ten.begin()); // num_digits == 0 iff number == 0
-      // 0 <= num_digits <= 20
-
-      uint16_t characters_needed = std::max( num_digits, num_decimal_places );
-      uint16_t decimal_point_pos = num_digits;
-      if( num_decimal_places >= num_digits ) {
-         ++characters_needed; // space needing for additional leading zero digit
-         decimal_point_pos = 1;
-      } else {
-         decimal_point_pos -= num_decimal_places;
-      }
-      if( num_decimal_places > 0 ) ++characters_needed; // space for decimal point
-      uint16_t after_minus_pos = 0;
-      if( negative ) {
-         ++characters_needed; // space for minus sign
-         ++after_minus_pos;
-         ++decimal_point_pos;
-      }
-      // 1 <= characters_needed <= 258
-      // 1 <= decimal_point_pos <= num_digits + 1 <= 21
-
-      char* actual_end = begin + characters_needed;
+      char* actual_end = begin + fixed_decimal_size( number, num_decimal_places, negative ); // at most 258 characters
       if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
 
-      int i = characters_needed - 1;
-      for( ; number > 0 && i > decimal_point_pos; --i ) {
-         *(begin + i) = (number % 10) + '0';
-         number /= 10;
-      }
-      for( ; i > decimal_point_pos; --i ) {
-         *(begin + i) = '0';
-      }
-      if( i == decimal_point_pos ) {
-         *(begin + i) = '.';
-         --i;
-      }
-      for( ; i >= after_minus_pos; --i ) {
-         *(begin + i) = (number % 10) + '0';
-         number /= 10;
-      }
-      if( i == 0 ) *(begin + i) = '-';
-
+      write_fixed( begin, number, num_decimal_places, negative );
       return actual_end;
    }
 
@@ -0,0 +1,135 @@
+#include <eosio/intrinsic_stats.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+
+namespace eosio { namespace native {
+
+namespace {
+   struct registry {
+      std::mutex                    mtx;
+      std::deque<intrinsic_counter> counters; // deque keeps the slots in place as it grows
+      std::string                   dump_file;
+   };
+
+   registry& get_registry() {
+      static registry r;
+      return r;
+   }
+
+   intrinsic_counters load( const intrinsic_counter& c ) {
+      return { c.calls.load( std::memory_order_relaxed ), c.bytes_in.load( std::memory_order_relaxed ),
+               c.bytes_out.load( std::memory_order_relaxed ), c.nanoseconds.load( std::memory_order_relaxed ) };
+   }
+
+   void write_dump() {
+      auto& r = get_registry();
+      if ( r.dump_file.empty() )
+         return;
+      std::string json = intrinsic_stats::to_json();
+      if ( FILE* f = std::fopen( r.dump_file.c_str(), "w" ) ) {
+         std::fwrite( json.data(), 1, json.size(), f );
+         std::fclose( f );
+      } else {
+         std::fprintf( stderr, "cannot write intrinsic statistics to %s\n", r.dump_file.c_str() );
+      }
+   }
+
+   // EOSIO_INTRINSIC_STATS=<file> enables recording for the whole process
+   [[maybe_unused]] const bool enabled_from_environment = [] {
+      if ( const char* file = std::getenv( "EOSIO_INTRINSIC_STATS" ); file && *file ) {
+         intrinsic_stats::enable();
+         intrinsic_stats::dump_at_exit( file );
+         return true;
+      }
+      return false;
+   }();
+} // namespace
+
+void intrinsic_stats::enable( bool on ) { is_enabled.store( on, std::memory_order_relaxed ); }
+
+void intrinsic_stats::reset() {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   for ( auto& c : r.counters ) {
+      c.calls       = 0;
+      c.bytes_in    = 0;
+      c.bytes_out   = 0;
+      c.nanoseconds = 0;
+   }
+}
+
+intrinsic_counters intrinsic_stats::get( std::string_view name ) {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   for ( const auto& c : r.counters )
+      if ( name == c.name )
+         return load( c );
+   return {};
+}
+
+std::vector<std::pair<std::string, intrinsic_counters>> intrinsic_stats::snapshot() {
+   std::vector<std::pair<std::string, intrinsic_counters>> result;
+   {
+      auto&                       r = get_registry();
+      std::lock_guard<std::mutex> lock( r.mtx );
+      for ( const auto& c : r.counters ) {
+         auto counters = load( c );
+         if ( counters.calls )
+            result.emplace_back( c.name, counters );
+      }
+   }
+   std::sort( result.begin(), result.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+   return result;
+}
+
+std::string intrinsic_stats::to_json() {
+   std::string json = "{\"intrinsics\":{";
+   bool        first = true;
+   for ( const auto& [name, c] : snapshot() ) {
+      char buf[160];
+      std::snprintf( buf, sizeof( buf ),
+                     "\"calls\":%llu,\"bytes_in\":%llu,\"bytes_out\":%llu,\"ns\":%llu}",
+                     (unsigned long long)c.calls, (unsigned long long)c.bytes_in,
+                     (unsigned long long)c.bytes_out, (unsigned long long)c.nanoseconds );
+      json += first ? "\n  \"" : ",\n  \"";
+      json += name;
+      json += "\":{";
+      json += buf;
+      first = false;
+   }
+   json += "\n}}\n";
+   return json;
+}
+
+void intrinsic_stats::dump_at_exit( std::string filename ) {
+   auto& r = get_registry();
+   bool  registered;
+   {
+      std::lock_guard<std::mutex> lock( r.mtx );
+      registered  = !r.dump_file.empty();
+      r.dump_file = std::move( filename );
+   }
+   if ( !registered )
+      std::atexit( write_dump );
+}
+
+intrinsic_counter& intrinsic_stats::counter( const char* name ) {
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   for ( auto& c : r.counters )
+      if ( std::string_view( name ) == c.name )
+         return c;
+   return r.counters.emplace_back( name );
+}
+
+uint64_t intrinsic_stats::now_ns() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() )
+         .count();
+}
+
+}} // namespace eosio::native
@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <eosio/check.hpp>
+#include "eosio/small_memory_alloc.hpp"
+#include "eosio/big_memory_alloc.hpp"
+
+namespace eosio {
+   constexpr int free_list_meta_size = 16; // overhead of each allocation, at least 8 bytes (4 bytes list index + 4 buffer capacity)
+
+   /**
+    * The contract heap allocator, over a linear memory `Memory` that provides
+    * - `char* heap_base()`: first byte of the heap
+    * - `size_t offset(const char* ptr)`: address of `ptr` in the linear memory
+    * - `size_t pages()`: current size of the memory, in 64 KiB pages
+    * - `size_t grow(size_t pages)`: adds `pages`, returns -1 when the memory can't grow
+    */
+   template <typename Memory>
+   struct basic_dsmalloc {
+
+      Memory memory;
+      small_mem_alloc small_memory;
+      big_mem_alloc big_memory;
+
+      inline char* align(char* ptr, uint8_t align_amt) {
+         return (char*)((((size_t)ptr) + align_amt-1) & ~(align_amt-1));
+      }
+
+      inline size_t align(size_t ptr, uint8_t align_amt) {
+         return (ptr + align_amt-1) & ~(align_amt-1);
+      }
+
+      explicit basic_dsmalloc(Memory mem = {}) : memory(mem) {
+         last_ptr = memory.heap_base();
+         next_page = memory.pages();
+      }
+
+      void free(char *ptr) {
+         if (memory.offset(ptr) >= free_list_meta_size) {
+            ptr -= free_list_meta_size;
+            int id = *(int *)ptr;
+            if (id >= 0 && id < sizeof(small_memory.free_lists) / sizeof(small_memory.free_lists[0])) {
+               small_memory.add_to_freelist(ptr, id);
+            } else {
+               int sz = *(int *)(ptr + 4); // in (ptr + 4) size of the memory is stored.
+               big_memory.add_to_bigchunk(ptr, sz);
+            }
+         }
+      }
+
+      char* operator()(size_t sz, uint8_t align_amt=16) {
+         if (sz == 0)
+            return NULL;
+
+         sz += free_list_meta_size;
+         sz = align(sz, align_amt);
+         // adjust requested memory size to sizes in _free_list_chunk_size
+         int16_t free_list_id = small_memory.find_small_mem_size(&sz);
+
+         if(free_list_id >= 0 && small_memory.free_lists[free_list_id])
+            return small_memory.allocate_from_free_list(free_list_id, sz) + free_list_meta_size;
+
+         char *old_last_ptr = last_ptr;
+         size_t old_next_page = next_page;
+
+         char* ret = last_ptr;
+         last_ptr = align(last_ptr+sz, align_amt);
+
+         size_t pages_to_alloc = sz >> 16;
+         next_page += pages_to_alloc;
+         if ((next_page << 16) <= memory.offset(last_ptr)) {
+            next_page++;
+            pages_to_alloc++;
+         }
+         // grow resizes the linear memory in units of WebAssembly pages (64kb)
+         // returns -1 if it passes the max memory of 33mb
+         if (memory.grow(pages_to_alloc) == (size_t)-1) {
+            last_ptr = old_last_ptr;
+            next_page = old_next_page;
+            // check to reuse freed momory stored in bigchunk array.
+            ret = big_memory.alloc_from_bigchunk(sz);
+            eosio::check(ret != nullptr,  "failed to allocate pages");
+         }
+
+         *(int *)ret       = free_list_id;
+         *(int *)(ret + 4) = sz;
+         return ret + free_list_meta_size;
+      }
+
+      char*  last_ptr;
+      size_t next_page;
+   };
+} // ns eosio
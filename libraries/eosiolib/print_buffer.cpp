@@ -0,0 +1,80 @@
+#include <eosio/print.hpp>
+#include <string.h>
+
+// Backing store for EOSIO_BUFFERED_PRINT. This object is only linked into contracts that
+// use buffered printing, through the reference to eosio_print_buffer_linked that the macro
+// adds; the print functions, the dispatcher and the native assertion intrinsics reach
+// everything else here through weak references.
+namespace eosio { namespace internal_use_do_not_use {
+
+namespace {
+   constexpr uint32_t print_buffer_size = 1024;
+   char               print_buffer[print_buffer_size];
+   uint32_t           print_buffer_used;
+}
+
+extern "C" {
+
+int fpconv_dtoa(double, char dest[24]);
+
+extern const bool eosio_print_buffer_linked = true;
+
+void eosio_print_buffer_flush() {
+   if (print_buffer_used) {
+      prints_l(print_buffer, print_buffer_used);
+      print_buffer_used = 0;
+   }
+}
+
+void eosio_print_buffer_write(const char* ptr, uint32_t len) {
+   if (len > print_buffer_size - print_buffer_used) {
+      eosio_print_buffer_flush();
+      if (len >= print_buffer_size) {
+         prints_l(ptr, len);
+         return;
+      }
+   }
+   memcpy(print_buffer + print_buffer_used, ptr, len);
+   print_buffer_used += len;
+}
+
+void eosio_print_buffer_write_double(double value) {
+   char buf[24];
+   eosio_print_buffer_write(buf, fpconv_dtoa(value, buf));
+}
+
+#ifdef __wasm__
+// Output is most useful when the action aborts, so the assertion intrinsics are wrapped to
+// flush the buffer first. The wrappers take the place of the imports only in contracts that
+// link this object, and are weak so that a library defining eosio_assert keeps its own.
+__attribute__((import_name("eosio_assert")))
+void eosio_print_buffer_host_assert(uint32_t test, const char* msg);
+
+__attribute__((import_name("eosio_assert_message")))
+void eosio_print_buffer_host_assert_message(uint32_t test, const char* msg, uint32_t msg_len);
+
+__attribute__((import_name("eosio_assert_code")))
+void eosio_print_buffer_host_assert_code(uint32_t test, uint64_t code);
+
+__attribute__((weak)) void eosio_assert(uint32_t test, const char* msg) {
+   if (!test)
+      eosio_print_buffer_flush();
+   eosio_print_buffer_host_assert(test, msg);
+}
+
+__attribute__((weak)) void eosio_assert_message(uint32_t test, const char* msg, uint32_t msg_len) {
+   if (!test)
+      eosio_print_buffer_flush();
+   eosio_print_buffer_host_assert_message(test, msg, msg_len);
+}
+
+__attribute__((weak)) void eosio_assert_code(uint32_t test, uint64_t code) {
+   if (!test)
+      eosio_print_buffer_flush();
+   eosio_print_buffer_host_assert_code(test, code);
+}
+#endif
+
+} // extern "C"
+
+}} // namespace eosio::internal_use_do_not_use
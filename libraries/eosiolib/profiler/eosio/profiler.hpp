@@ -0,0 +1,76 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <eosio/name.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace eosio { namespace native { namespace profiler {
+
+   /**
+    *  @defgroup profiler Native Contract Profiler
+    *  @ingroup core
+    *  @brief Per-action, per-function cost profile of natively built contracts
+    *
+    *  Code compiled with `-finstrument-functions-after-inlining` (clang) or `-finstrument-functions`
+    *  and linked with `eosio::profiler` reports every function entry and exit to the profiler. With
+    *  the clang flag, inlined functions are not reported and count toward their caller. The CMake
+    *  function `target_native_profiling(target)` or `-DEOSIO_NATIVE_PROFILING=ON` set this up for
+    *  native contracts. Costs are attributed to
+    *  the action being applied: the dispatcher generated for a contract opens an action scope for
+    *  each action it runs, and other drivers (a unit test calling `eosio::chaindb::apply`, say) can
+    *  open one with `action_scope`.
+    *
+    *  Costs are counted in retired instructions when the CPU's performance counters can be read
+    *  (Linux `perf_event_open`). Unlike time, instruction counts barely change between runs, which is
+    *  closer to how the chain bills actions. Otherwise, or when `EOSIO_PROFILE_COUNTER=ns` is set,
+    *  costs are nanoseconds.
+    *
+    *  Setting `EOSIO_PROFILE=<dir>` enables profiling at startup and writes, when the process exits,
+    *  for each instrumented module:
+    *  - `<dir>/<module>.folded`: collapsed stacks (`action;outer;inner cost`) for flamegraph.pl,
+    *    speedscope or inferno
+    *  - `<dir>/<module>.json`: calls, inclusive and exclusive cost per action and function
+    *
+    *  Each module linking `eosio::profiler` keeps its own profile. Threads are profiled separately
+    *  and merged when the profile is written; write it while no instrumented code runs.
+    */
+
+   /// Starts or stops recording
+   void enable( bool on = true );
+   bool enabled();
+
+   /// Drops everything recorded so far
+   void reset();
+
+   /// "instructions" or "ns"
+   const char* counter_unit();
+
+   /// Collapsed stacks, one `action;function;...;function cost` line per distinct stack
+   std::string to_folded();
+
+   /// `{"unit":..,"actions":{"transfer":{"calls":..,"cost":..,"functions":[{"name":..,"calls":..,"inclusive":..,"exclusive":..},...]}}}`,
+   /// functions sorted by exclusive cost
+   std::string to_json();
+
+   /// Writes `<dir>/<module>.folded` and `<dir>/<module>.json`
+   void write( const std::string& dir );
+
+   /**
+    *  Attributes the costs of the enclosing scope to `action`.
+    *
+    *  @ingroup profiler
+    */
+   class action_scope {
+    public:
+      explicit action_scope( name action );
+      ~action_scope();
+      action_scope( const action_scope& ) = delete;
+      action_scope& operator=( const action_scope& ) = delete;
+   };
+
+}}} // namespace eosio::native::profiler
@@ -0,0 +1,471 @@
+#include <eosio/profiler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+// Nothing in this file may be instrumented: the hooks would recurse into themselves
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+namespace {
+   using eosio::name;
+
+   // Keys of action nodes have the top bit set; the rest is the index of the action's label
+   constexpr uint64_t action_bit = uint64_t(1) << 63;
+   constexpr uint32_t root       = 0;
+
+   struct node {
+      uint32_t                                   parent;
+      uint64_t                                   key;
+      uint64_t                                   calls     = 0;
+      uint64_t                                   inclusive = 0;
+      uint64_t                                   exclusive = 0;
+      std::vector<std::pair<uint64_t, uint32_t>> children  = {}; // key, node
+   };
+
+   struct frame {
+      uint32_t  node;
+      uint64_t  start;
+      uint64_t  children = 0;          // cost of the calls made from this frame
+      uintptr_t address  = UINTPTR_MAX; // machine frame of the function; action frames never go stale
+   };
+
+   // Call tree of one thread. Each distinct stack is one node, so the collapsed stacks and the per
+   // function totals are both derived from it when the profile is written.
+   struct thread_profile {
+      std::vector<node>  nodes{ node{ root, 0 } };
+      std::vector<frame> stack;
+      int                perf_fd = -1;
+
+      NO_INSTRUMENT uint32_t child( uint32_t parent, uint64_t key ) {
+         for ( auto [k, n] : nodes[parent].children )
+            if ( k == key )
+               return n;
+         uint32_t n = nodes.size();
+         nodes.push_back( node{ parent, key } );
+         nodes[parent].children.emplace_back( key, n );
+         return n;
+      }
+
+      NO_INSTRUMENT void push( uint64_t key, uint64_t now, uintptr_t address = UINTPTR_MAX ) {
+         uint32_t parent = stack.empty() ? root : stack.back().node;
+         stack.push_back( frame{ child( parent, key ), now, 0, address } );
+      }
+
+      NO_INSTRUMENT void pop( uint64_t now ) {
+         frame f       = stack.back();
+         stack.pop_back();
+         uint64_t cost = now - f.start;
+         auto&    n    = nodes[f.node];
+         ++n.calls;
+         n.inclusive += cost;
+         n.exclusive += cost - std::min( cost, f.children );
+         if ( !stack.empty() )
+            stack.back().children += cost;
+      }
+   };
+
+   struct registry {
+      std::mutex                                   mtx;
+      std::vector<std::unique_ptr<thread_profile>> threads;
+      std::vector<std::string>                     labels;
+      std::unordered_map<std::string, uint64_t>    label_index;
+      std::string                                  dump_dir;
+   };
+
+   // The hooks may only call functions of this file before the reentry guard is set: the linker can
+   // pick an instrumented copy of any inline library function (std::atomic::load included) from the
+   // contract's object files. Hence a plain flag read with a builtin, and the guard below.
+   bool              is_enabled = false;
+   thread_local bool in_profiler = false;
+
+   NO_INSTRUMENT bool recording() { return __atomic_load_n( &is_enabled, __ATOMIC_RELAXED ) && !in_profiler; }
+
+   class reentry_guard {
+    public:
+      NO_INSTRUMENT reentry_guard() : outer( in_profiler ) { in_profiler = true; }
+      NO_INSTRUMENT ~reentry_guard() { in_profiler = outer; }
+
+    private:
+      bool outer;
+   };
+
+   NO_INSTRUMENT registry& get_registry() {
+      static registry r;
+      return r;
+   }
+
+#ifdef __linux__
+   NO_INSTRUMENT int open_instruction_counter() {
+      perf_event_attr attr{};
+      attr.type           = PERF_TYPE_HARDWARE;
+      attr.size           = sizeof( attr );
+      attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      return syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+   }
+#else
+   NO_INSTRUMENT int open_instruction_counter() { return -1; }
+#endif
+
+   // Decided once per process so every thread reports in the same unit
+   NO_INSTRUMENT bool use_instructions() {
+      static const bool result = [] {
+         const char* counter = std::getenv( "EOSIO_PROFILE_COUNTER" );
+         if ( counter && std::string_view( counter ) == "ns" )
+            return false;
+         int fd = open_instruction_counter();
+         if ( fd < 0 )
+            return false;
+         close( fd );
+         return true;
+      }();
+      return result;
+   }
+
+   NO_INSTRUMENT thread_profile& local() {
+      static thread_local thread_profile* profile = nullptr;
+      if ( !profile ) {
+         auto  p = std::make_unique<thread_profile>();
+         if ( use_instructions() )
+            p->perf_fd = open_instruction_counter();
+         auto& r = get_registry();
+         std::lock_guard<std::mutex> lock( r.mtx );
+         profile = r.threads.emplace_back( std::move( p ) ).get();
+      }
+      return *profile;
+   }
+
+   NO_INSTRUMENT uint64_t now( const thread_profile& p ) {
+      if ( p.perf_fd >= 0 ) {
+         uint64_t count = 0;
+         if ( read( p.perf_fd, &count, sizeof( count ) ) == sizeof( count ) )
+            return count;
+         return 0;
+      }
+      return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() )
+            .count();
+   }
+
+   NO_INSTRUMENT uint64_t function_key( void* fn ) { return reinterpret_cast<uintptr_t>( fn ) & ~action_bit; }
+
+   NO_INSTRUMENT uint64_t action_key( const std::string& label ) {
+      auto&                       r = get_registry();
+      std::lock_guard<std::mutex> lock( r.mtx );
+      auto [it, inserted] = r.label_index.emplace( label, r.labels.size() );
+      if ( inserted )
+         r.labels.push_back( label );
+      return it->second | action_bit;
+   }
+
+   NO_INSTRUMENT void begin_action( const std::string& label ) {
+      if ( !recording() )
+         return;
+      reentry_guard guard;
+      auto&         p = local();
+      p.push( action_key( label ), now( p ) );
+   }
+
+   NO_INSTRUMENT void end_action() {
+      if ( !recording() )
+         return;
+      reentry_guard guard;
+      auto&         p   = local();
+      auto  it  = std::find_if( p.stack.rbegin(), p.stack.rend(),
+                                [&]( const frame& f ) { return p.nodes[f.node].key & action_bit; } );
+      if ( it == p.stack.rend() )
+         return;
+      uint64_t t     = now( p );
+      size_t   depth = p.stack.rend() - it - 1;
+      while ( p.stack.size() > depth )
+         p.pop( t );
+   }
+
+   NO_INSTRUMENT std::string module_name() {
+      Dl_info info;
+      if ( !dladdr( reinterpret_cast<void*>( &module_name ), &info ) || !info.dli_fname )
+         return "profile";
+      std::string_view path = info.dli_fname;
+      path                  = path.substr( path.find_last_of( '/' ) + 1 );
+      return std::string( path.substr( 0, path.find( '.' ) ) );
+   }
+
+   NO_INSTRUMENT std::string symbol_name( uint64_t key ) {
+      Dl_info info{};
+      if ( !dladdr( reinterpret_cast<void*>( key ), &info ) )
+         info = {};
+      // dladdr names the closest exported symbol below the address; only an exact match is this function
+      if ( info.dli_sname && info.dli_saddr == reinterpret_cast<void*>( key ) ) {
+         int   status    = 0;
+         char* demangled = abi::__cxa_demangle( info.dli_sname, nullptr, nullptr, &status );
+         std::string result = status == 0 && demangled ? demangled : info.dli_sname;
+         std::free( demangled );
+         std::replace( result.begin(), result.end(), ';', ':' );
+         return result;
+      }
+      // Not exported: module and offset, for addr2line or llvm-symbolizer
+      char buf[64];
+      if ( info.dli_fbase )
+         std::snprintf( buf, sizeof( buf ), "+0x%llx", (unsigned long long)( key - (uintptr_t)info.dli_fbase ) );
+      else
+         std::snprintf( buf, sizeof( buf ), "0x%llx", (unsigned long long)key );
+      std::string_view file = info.dli_fname ? info.dli_fname : "";
+      return std::string( file.substr( file.find_last_of( '/' ) + 1 ) ) + buf;
+   }
+
+   struct function_totals {
+      uint64_t calls     = 0;
+      uint64_t inclusive = 0;
+      uint64_t exclusive = 0;
+   };
+
+   struct action_totals {
+      uint64_t                                      calls = 0;
+      uint64_t                                      cost  = 0;
+      std::unordered_map<uint64_t, function_totals> functions;
+   };
+
+   constexpr const char* outside_action = "[outside action]";
+
+   // Walks every thread's call tree. `visit(action, path, node, recursive)` sees each node with the
+   // label of its action, the keys from the action down to the node, and whether the node's function
+   // is already on that path (its inclusive cost is then part of the outer call's).
+   template <typename F>
+   NO_INSTRUMENT void walk( F&& visit ) {
+      auto& r = get_registry();
+      for ( const auto& t : r.threads ) {
+         std::vector<uint64_t> path;
+         std::string           action = outside_action;
+         auto rec = [&]( auto& self, uint32_t n ) -> void {
+            const node&           nd        = t->nodes[n];
+            bool                  is_action = nd.key & action_bit;
+            bool                  recursive = false;
+            std::string           outer_action;
+            std::vector<uint64_t> outer_path;
+            if ( is_action ) {
+               outer_action = std::exchange( action, r.labels[nd.key & ~action_bit] );
+               outer_path   = std::exchange( path, {} );
+            } else {
+               recursive = std::find( path.begin(), path.end(), nd.key ) != path.end();
+            }
+            path.push_back( nd.key );
+            visit( action, path, nd, recursive );
+            for ( auto [k, c] : nd.children )
+               self( self, c );
+            if ( is_action ) {
+               action = std::move( outer_action );
+               path   = std::move( outer_path );
+            } else {
+               path.pop_back();
+            }
+         };
+         for ( auto [k, c] : t->nodes[root].children )
+            rec( rec, c );
+      }
+   }
+
+   NO_INSTRUMENT void write_file( const std::string& filename, const std::string& content ) {
+      if ( FILE* f = std::fopen( filename.c_str(), "w" ) ) {
+         std::fwrite( content.data(), 1, content.size(), f );
+         std::fclose( f );
+      } else {
+         std::fprintf( stderr, "cannot write profile to %s\n", filename.c_str() );
+      }
+   }
+
+   NO_INSTRUMENT void write_at_exit() {
+      auto& r = get_registry();
+      if ( !r.dump_dir.empty() )
+         eosio::native::profiler::write( r.dump_dir );
+   }
+
+   // EOSIO_PROFILE=<dir> enables profiling for the whole process
+   [[maybe_unused]] const bool enabled_from_environment = [] {
+      if ( const char* dir = std::getenv( "EOSIO_PROFILE" ); dir && *dir ) {
+         get_registry().dump_dir = dir;
+         eosio::native::profiler::enable();
+         std::atexit( write_at_exit );
+         return true;
+      }
+      return false;
+   }();
+} // namespace
+
+namespace eosio { namespace native { namespace profiler {
+
+NO_INSTRUMENT void enable( bool on ) {
+   // the toolchain builds with -fno-threadsafe-statics, so the statics are set up before any hook runs
+   reentry_guard guard;
+   (void)get_registry();
+   (void)use_instructions();
+   __atomic_store_n( &is_enabled, on, __ATOMIC_RELAXED );
+}
+
+NO_INSTRUMENT bool enabled() { return __atomic_load_n( &is_enabled, __ATOMIC_RELAXED ); }
+
+NO_INSTRUMENT void reset() {
+   reentry_guard               guard;
+   auto&                       r = get_registry();
+   std::lock_guard<std::mutex> lock( r.mtx );
+   for ( auto& t : r.threads ) {
+      for ( auto& n : t->nodes )
+         n.calls = n.inclusive = n.exclusive = 0;
+   }
+}
+
+NO_INSTRUMENT const char* counter_unit() { return use_instructions() ? "instructions" : "ns"; }
+
+NO_INSTRUMENT std::string to_folded() {
+   reentry_guard                   guard;
+   std::lock_guard<std::mutex>     lock( get_registry().mtx );
+   std::unordered_map<uint64_t, std::string> names;
+   std::map<std::string, uint64_t> stacks;
+   walk( [&]( const std::string& action, const std::vector<uint64_t>& path, const node& n, bool ) {
+      if ( !n.exclusive )
+         return;
+      std::string line = action;
+      for ( uint64_t key : path ) {
+         if ( key & action_bit )
+            continue;
+         auto [it, inserted] = names.try_emplace( key );
+         if ( inserted )
+            it->second = symbol_name( key );
+         line += ';';
+         line += it->second;
+      }
+      stacks[line] += n.exclusive;
+   } );
+   std::string result;
+   for ( const auto& [stack, cost] : stacks ) {
+      result += stack;
+      result += ' ';
+      result += std::to_string( cost );
+      result += '\n';
+   }
+   return result;
+}
+
+NO_INSTRUMENT std::string to_json() {
+   reentry_guard                        guard;
+   std::lock_guard<std::mutex>          lock( get_registry().mtx );
+   std::map<std::string, action_totals> actions;
+   walk( [&]( const std::string& action, const std::vector<uint64_t>&, const node& n, bool recursive ) {
+      auto& a = actions[action];
+      if ( n.key & action_bit ) {
+         a.calls += n.calls;
+         a.cost += n.inclusive;
+         return;
+      }
+      auto& f = a.functions[n.key];
+      f.calls += n.calls;
+      f.exclusive += n.exclusive;
+      if ( !recursive )
+         f.inclusive += n.inclusive;
+   } );
+
+   std::string json = std::string( "{\"unit\":\"" ) + ( use_instructions() ? "instructions" : "ns" ) + "\",\"actions\":{";
+   bool        first_action = true;
+   for ( const auto& [label, a] : actions ) {
+      std::vector<std::pair<uint64_t, function_totals>> functions( a.functions.begin(), a.functions.end() );
+      std::sort( functions.begin(), functions.end(),
+                 []( const auto& x, const auto& y ) { return x.second.exclusive > y.second.exclusive; } );
+      json += first_action ? "\n  \"" : ",\n  \"";
+      json += label + "\":{\"calls\":" + std::to_string( a.calls ) + ",\"cost\":" + std::to_string( a.cost ) +
+              ",\"functions\":[";
+      bool first_function = true;
+      for ( const auto& [key, f] : functions ) {
+         std::string name = symbol_name( key );
+         std::string escaped;
+         for ( char c : name ) {
+            if ( c == '"' || c == '\\' )
+               escaped += '\\';
+            escaped += c;
+         }
+         json += first_function ? "\n    {\"name\":\"" : ",\n    {\"name\":\"";
+         json += escaped + "\",\"calls\":" + std::to_string( f.calls ) + ",\"inclusive\":" +
+                 std::to_string( f.inclusive ) + ",\"exclusive\":" + std::to_string( f.exclusive ) + "}";
+         first_function = false;
+      }
+      json += "\n  ]}";
+      first_action = false;
+   }
+   json += "\n}}\n";
+   return json;
+}
+
+NO_INSTRUMENT void write( const std::string& dir ) {
+   reentry_guard guard;
+   std::string   base = dir + "/" + module_name();
+   write_file( base + ".folded", to_folded() );
+   write_file( base + ".json", to_json() );
+}
+
+NO_INSTRUMENT action_scope::action_scope( name action ) { begin_action( action.to_string() ); }
+
+NO_INSTRUMENT action_scope::~action_scope() { end_action(); }
+
+}}} // namespace eosio::native::profiler
+
+extern "C" {
+
+// An exception skips the exit hooks of the functions it unwinds, which leaves their frames on the
+// stack. The stack grows down and every live caller has a higher frame address than its callees,
+// so a frame at or below the entered function's address is one that has already unwound.
+NO_INSTRUMENT void __cyg_profile_func_enter( void* fn, void* ) {
+   if ( !recording() )
+      return;
+   reentry_guard guard;
+   auto&         p       = local();
+   uint64_t      t       = now( p );
+   auto          address = reinterpret_cast<uintptr_t>( __builtin_frame_address( 1 ) );
+   while ( !p.stack.empty() && p.stack.back().address <= address )
+      p.pop( t );
+   p.push( function_key( fn ), t, address );
+}
+
+// Unwound frames the enter hook has not closed yet are closed when an outer function returns
+NO_INSTRUMENT void __cyg_profile_func_exit( void* fn, void* ) {
+   if ( !recording() )
+      return;
+   reentry_guard guard;
+   auto&         p   = local();
+   uint64_t key = function_key( fn );
+   auto     it  = std::find_if( p.stack.rbegin(), p.stack.rend(), [&]( const frame& f ) {
+      return p.nodes[f.node].key == key || ( p.nodes[f.node].key & action_bit );
+   } );
+   if ( it == p.stack.rend() || p.nodes[it->node].key != key )
+      return;
+   uint64_t t     = now( p );
+   size_t   depth = p.stack.rend() - it - 1;
+   while ( p.stack.size() > depth )
+      p.pop( t );
+}
+
+// Called by the dispatcher eosio-codegen generates, when a module links the profiler
+NO_INSTRUMENT void eosio_profile_action_begin( uint64_t receiver, uint64_t code, uint64_t action ) {
+   if ( code == receiver )
+      begin_action( name( action ).to_string() );
+   else
+      begin_action( name( code ).to_string() + "::" + name( action ).to_string() );
+}
+
+NO_INSTRUMENT void eosio_profile_action_end() { end_action(); }
+
+} // extern "C"
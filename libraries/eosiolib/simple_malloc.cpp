@@ -1,8 +1,6 @@
 #include <errno.h>
 #include <memory>
-#include <eosio/check.hpp>
-#include "eosio/small_memory_alloc.hpp"
-#include "eosio/big_memory_alloc.hpp"
+#include "eosio/dsmalloc.hpp"
 
 #ifndef __wasm__
    extern "C" {
@@ -24,83 +22,17 @@ namespace {
       return &enabled;
    }
 
-   static constexpr int free_list_meta_size = 16; // overhead of each allocation, at least 8 bytes (4 bytes list index + 4 buffer capacity)
+   // the module's own linear memory, which starts at address 0
+   struct wasm_memory {
+      char*  heap_base() { return &__heap_base; }
+      size_t offset(const char* ptr) { return (size_t)ptr; }
+      size_t pages() { return CURRENT_MEMORY; }
+      size_t grow(size_t pages) { return GROW_MEMORY(pages); }
+   };
 }
 
-namespace eosio {   
-   struct dsmalloc {
-
-      small_mem_alloc small_memory;
-      big_mem_alloc big_memory;
-
-      inline char* align(char* ptr, uint8_t align_amt) {
-         return (char*)((((size_t)ptr) + align_amt-1) & ~(align_amt-1));
-      }
-
-      inline size_t align(size_t ptr, uint8_t align_amt) {
-         return (ptr + align_amt-1) & ~(align_amt-1);
-      }
-
-      dsmalloc() {
-         last_ptr = &__heap_base;
-         next_page = CURRENT_MEMORY;
-      }
-      
-      void free(char *ptr) {
-         if ((int)ptr >= free_list_meta_size) {
-            ptr -= free_list_meta_size;
-            int id = *(int *)ptr;
-            if (id >= 0 && id < sizeof(small_memory.free_lists) / sizeof(small_memory.free_lists[0])) {
-               small_memory.add_to_freelist(ptr, id);
-            } else {
-               int sz = *(int *)(ptr + 4); // in (ptr + 4) size of the memory is stored.
-               big_memory.add_to_bigchunk(ptr, sz);
-            }
-         }
-      }
-      
-      char* operator()(size_t sz, uint8_t align_amt=16) {
-         if (sz == 0)
-            return NULL;
-
-         sz += free_list_meta_size;
-         sz = align(sz, align_amt);
-         // adjust requested memory size to sizes in _free_list_chunk_size
-         int16_t free_list_id = small_memory.find_small_mem_size(&sz);
-
-         if(free_list_id >= 0 && small_memory.free_lists[free_list_id])
-            return small_memory.allocate_from_free_list(free_list_id, sz) + free_list_meta_size;
-
-         char *old_last_ptr = last_ptr;
-         size_t old_next_page = next_page;
-
-         char* ret = last_ptr;
-         last_ptr = align(last_ptr+sz, align_amt);
-
-         size_t pages_to_alloc = sz >> 16;
-         next_page += pages_to_alloc;
-         if ((next_page << 16) <= (size_t)last_ptr) {
-            next_page++;
-            pages_to_alloc++;
-         }
-         // GROW_MEMORY resize wasm linear memory in unit of WebAssembly page (64kb)
-         // throws -1 if it passes the max memory of 33mb
-         if (GROW_MEMORY(pages_to_alloc) == -1) {
-            last_ptr = old_last_ptr;
-            next_page = old_next_page;
-            // check to reuse freed momory stored in bigchunk array.
-            ret = big_memory.alloc_from_bigchunk(sz);
-            eosio::check(ret != nullptr,  "failed to allocate pages");  
-         }
-
-         *(int *)ret       = free_list_id;
-         *(int *)(ret + 4) = sz;
-         return ret + free_list_meta_size;
-      }
-
-      char*  last_ptr;
-      size_t next_page;
-   };
+namespace eosio {
+   using dsmalloc = basic_dsmalloc<wasm_memory>;
    dsmalloc _dsmalloc __attribute__((init_priority(101)));
 } // ns eosio
 
@@ -138,10 +70,10 @@ extern "C" {
 
    void* realloc(void* ptr_, size_t size) {
       char *ptr = (char *)ptr_;
-      if ((int)ptr >= free_list_meta_size) {
-         ptr -= free_list_meta_size;
+      if ((int)ptr >= eosio::free_list_meta_size) {
+         ptr -= eosio::free_list_meta_size;
          int sz = *(int *)(ptr + 4);
-         if (sz - free_list_meta_size >= size) return ptr_;
+         if (sz - eosio::free_list_meta_size >= size) return ptr_;
       }
       if (void* result = eosio::_dsmalloc(size)) {
          // May read out of bounds, but that's okay, as the
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <eosio/tester.hpp>
+
+#ifndef __wasm__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace eosio {
+
+/**
+ * Runs independent test chains concurrently. Only available in native tester modules; the wasm
+ * tester has no threads.
+ *
+ * Each chain of the pool has its own queue of work. The work queued on one chain runs in order,
+ * one item at a time, and work queued on different chains runs in parallel on the pool's worker
+ * threads. Results, including transaction traces, come back as std::future. An exception thrown
+ * by the work (a failed eosio::check, for example) is rethrown by the future's get().
+ *
+ * Catch2 assertions are not thread-safe. Scenarios should return what they observe and leave
+ * CHECK/REQUIRE to the test thread, which collects the futures:
+ *
+ *    eosio::test_chain_pool pool;
+ *    std::vector<std::future<eosio::transaction_trace>> traces;
+ *    for (auto& amount : amounts)
+ *       traces.push_back(pool.run([&](eosio::test_chain& t) { setup(t); return t.transfer(...); }));
+ *    for (size_t i = 0; i < traces.size(); ++i)
+ *       DYNAMIC_SECTION("transfer " << i) { eosio::expect(traces[i].get()); }
+ *
+ * The chains are created by the pool's workers and are only ever touched by one thread at a time,
+ * but the pool does not serialize host calls: the chain intrinsics of the host (create_chain,
+ * push_transaction, start_block, finish_block, destroy_chain and the others taking a chain index)
+ * are called for different chains from different threads at once. The pool requires a host whose
+ * chains are independent and whose chain intrinsics are thread-safe across chains; the
+ * "test_chain_pool keeps chains isolated" tester test checks that.
+ */
+class test_chain_pool {
+ private:
+   struct strand;
+
+ public:
+   /**
+    * Handle to a chain owned by the pool. The chain is destroyed after the work already queued on
+    * it has run, once the handle is destroyed. Handles must not outlive their pool.
+    */
+   class chain {
+    public:
+      chain(chain&&) = default;
+      chain& operator=(chain&&) = delete;
+      ~chain();
+
+      /// Queues `f(test_chain&)` on this chain
+      template <typename F>
+      auto post(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>&, test_chain&>> {
+         using R = std::invoke_result_t<std::decay_t<F>&, test_chain&>;
+         struct job {
+            std::promise<R>  result;
+            std::decay_t<F>  f;
+         };
+         auto j      = std::make_shared<job>(job{ {}, std::forward<F>(f) });
+         auto result = j->result.get_future();
+         pool->enqueue(s, [j](strand& st) {
+            try {
+               if constexpr (std::is_void_v<R>) {
+                  j->f(st.get());
+                  j->result.set_value();
+               } else {
+                  j->result.set_value(j->f(st.get()));
+               }
+            } catch (...) {
+               j->result.set_exception(std::current_exception());
+            }
+         });
+         return result;
+      }
+
+      /// Queues test_chain::push_transaction on a transaction built from `actions`
+      std::future<transaction_trace> push_transaction(std::vector<action>      actions,
+                                                      std::vector<private_key> keys = { test_chain::default_priv_key });
+
+      /// Queues test_chain::transact; the trace is validated on the worker as with @ref eosio::expect
+      std::future<transaction_trace> transact(std::vector<action> actions, const char* expected_except = nullptr);
+
+      std::future<void> start_block(int64_t skip_miliseconds = 0);
+      std::future<void> finish_block();
+
+    private:
+      friend test_chain_pool;
+      chain(test_chain_pool* pool, std::shared_ptr<strand> s) : pool(pool), s(std::move(s)) {}
+
+      test_chain_pool*        pool;
+      std::shared_ptr<strand> s;
+   };
+
+   /// Starts `threads` workers, or one per hardware thread if 0
+   explicit test_chain_pool(uint32_t threads = 0);
+   test_chain_pool(const test_chain_pool&) = delete;
+   test_chain_pool& operator=(const test_chain_pool&) = delete;
+
+   /// Runs the remaining work, then stops the workers
+   ~test_chain_pool();
+
+   /// Creates a chain, from `snapshot` if given. The chain starts on a worker with the first queued work.
+   chain create_chain(const char* snapshot = nullptr);
+
+   /// Runs `scenario(test_chain&)` on a new chain, which is destroyed when the scenario returns
+   template <typename F>
+   auto run(F&& scenario, const char* snapshot = nullptr)
+         -> std::future<std::invoke_result_t<std::decay_t<F>&, test_chain&>> {
+      return create_chain(snapshot).post(std::forward<F>(scenario));
+   }
+
+   /// Blocks until all queued work has run
+   void wait();
+
+   /// Number of worker threads
+   uint32_t size() const { return workers.size(); }
+
+ private:
+   struct strand {
+      std::optional<std::string>                snapshot;
+      std::unique_ptr<test_chain>               chain;
+      std::deque<std::function<void(strand&)>>  tasks;
+      bool                                      scheduled = false; // queued in `ready` or running
+
+      /// The chain, created on first use; also makes it the current chain of the calling thread
+      test_chain& get();
+   };
+
+   void enqueue(const std::shared_ptr<strand>& s, std::function<void(strand&)> task);
+   void worker_loop();
+
+   std::vector<std::thread>             workers;
+   std::mutex                           mtx;
+   std::condition_variable              cv;
+   std::condition_variable              idle_cv;
+   std::deque<std::shared_ptr<strand>>  ready;
+   size_t                               pending  = 0; // queued or running tasks, including chain teardown
+   bool                                 stopping = false;
+};
+
+} // namespace eosio
+
+#endif
@@ -11,6 +11,12 @@
 
 #include <cwchar>
 #include <fmt/format.h>
+#include <functional>
+#include <span>
+
+#ifndef __wasm__
+#include <mutex>
+#endif
 
 namespace eosio {
 namespace internal_use_do_not_use {
@@ -107,6 +113,26 @@ void convert(const chain_types::recurse_transaction_trace& src, eosio::transacti
 
 using chain_types::block_info;
 
+/**
+ * How much of each trace test_chain::push_transactions decodes.
+ */
+enum class trace_mode {
+   status,   ///< only the id, status and timings
+   failures, ///< the full trace of transactions that did not execute
+   full,     ///< the full trace of every transaction, as push_transaction returns
+};
+
+/**
+ * Outcome of one transaction pushed by test_chain::push_transactions.
+ */
+struct transaction_result {
+   checksum256                      id           = {};
+   transaction_status               status       = {};
+   uint32_t                         cpu_usage_us = {};
+   int64_t                          elapsed      = {};
+   std::optional<transaction_trace> trace        = {}; ///< set according to the trace_mode
+};
+
 /**
  * Validates the status of a transaction.  If expected_except is nullptr, then the
  * transaction should succeed.  Otherwise it represents a string which should be
@@ -228,6 +254,19 @@ class test_chain {
                                       const std::vector<std::vector<char>>& context_free_data = {},
                                       const std::vector<signature>& signatures        = {});
 
+   /**
+    * Pushes transactions onto the chain in order, signed with `keys`.  If no block is currently
+    * pending, starts one.
+    *
+    * Meant for pushing transactions in volume: buffers are reused across the batch, and traces are
+    * only decoded as far as `mode` asks for. With trace_mode::status, a trace costs a few fixed
+    * fields instead of its action traces, console output and deltas.
+    */
+   [[nodiscard]]
+   std::vector<transaction_result> push_transactions(std::span<const transaction> trxs,
+                                                     trace_mode mode = trace_mode::failures,
+                                                     const std::vector<private_key>& keys = { default_priv_key });
+
    /**
     * Pushes a transaction onto the chain.  If no block is currently pending, starts one.
     *
@@ -381,6 +420,57 @@ class test_chain {
    }
 }; // test_chain
 
+namespace internal_use_do_not_use {
+   /// Makes `chain` the chain send_inline pushes to on the calling thread
+   void set_current_chain(test_chain* chain);
+}
+
+/**
+ * Builds a chain state once and caches it as a snapshot, so fixtures that deploy contracts and
+ * create accounts don't repeat that work for every test.
+ *
+ * The snapshot is stored in `cache_dir` under a name made of the fixture name and a hash of the
+ * content of `input_files` (typically the wasm and abi files the setup deploys). Changing any of
+ * those files rebuilds the snapshot. The setup code itself cannot be hashed; rename the fixture
+ * when it changes. Every test_chain started from the snapshot reads it; the file is never written
+ * again, so chains of the same fixture share it. The default `cache_dir` is a fixed temporary
+ * directory, so results don't depend on the working directory; pass a directory of the build tree
+ * to keep the cache with the build.
+ *
+ *    eosio::test_chain_fixture token_fixture("token", { "token.wasm", "token.abi" }, [](eosio::test_chain& t) {
+ *       t.create_code_account("eosio.token"_n);
+ *       t.set_code("eosio.token"_n, "token.wasm");
+ *    });
+ *
+ *    struct token_chain : eosio::test_chain {
+ *       token_chain() : eosio::test_chain(token_fixture.snapshot().c_str()) {}
+ *    };
+ *
+ *    TEST_CASE_METHOD(token_chain, "transfer", "[token]") { ... }
+ */
+class test_chain_fixture {
+ public:
+   static constexpr const char* default_cache_dir = "/tmp/eosio-test-chain-fixtures";
+
+   test_chain_fixture(std::string name, std::vector<std::string> input_files, std::function<void(test_chain&)> setup,
+                      std::string cache_dir = default_cache_dir);
+   test_chain_fixture(const test_chain_fixture&) = delete;
+   test_chain_fixture& operator=(const test_chain_fixture&) = delete;
+
+   /// Path of the fixture's snapshot; runs the setup and writes the snapshot if it isn't cached yet
+   const std::string& snapshot();
+
+ private:
+   std::string                      name;
+   std::vector<std::string>         input_files;
+   std::function<void(test_chain&)> setup;
+   std::string                      cache_dir;
+   std::string                      path;
+#ifndef __wasm__
+   std::mutex                       mtx;
+#endif
+};
+
 /**
  * Manages a rodeos instance
  */
@@ -0,0 +1,127 @@
+#include <eosio/test_chain_pool.hpp>
+
+#ifndef __wasm__
+
+#include <algorithm>
+
+eosio::test_chain& eosio::test_chain_pool::strand::get() {
+   if (!chain)
+      chain = std::make_unique<test_chain>(snapshot ? snapshot->c_str() : nullptr);
+   internal_use_do_not_use::set_current_chain(chain.get());
+   return *chain;
+}
+
+eosio::test_chain_pool::test_chain_pool(uint32_t threads) {
+   if (!threads)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+   for (uint32_t i = 0; i < threads; ++i)
+      workers.emplace_back([this] { worker_loop(); });
+}
+
+eosio::test_chain_pool::~test_chain_pool() {
+   wait();
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      stopping = true;
+   }
+   cv.notify_all();
+   for (auto& t : workers)
+      t.join();
+}
+
+eosio::test_chain_pool::chain eosio::test_chain_pool::create_chain(const char* snapshot) {
+   auto s = std::make_shared<strand>();
+   if (snapshot)
+      s->snapshot = snapshot;
+   return chain(this, std::move(s));
+}
+
+void eosio::test_chain_pool::wait() {
+   std::unique_lock<std::mutex> lock(mtx);
+   idle_cv.wait(lock, [&] { return pending == 0; });
+}
+
+void eosio::test_chain_pool::enqueue(const std::shared_ptr<strand>& s, std::function<void(strand&)> task) {
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      s->tasks.push_back(std::move(task));
+      ++pending;
+      if (s->scheduled)
+         return;
+      s->scheduled = true;
+      ready.push_back(s);
+   }
+   cv.notify_one();
+}
+
+// Runs one task of a strand at a time and then requeues the strand behind the others, so a long
+// scenario queued early doesn't hold back the chains queued after it.
+void eosio::test_chain_pool::worker_loop() {
+   for (;;) {
+      std::shared_ptr<strand>      s;
+      std::function<void(strand&)> task;
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         cv.wait(lock, [&] { return stopping || !ready.empty(); });
+         if (ready.empty())
+            return;
+         s = std::move(ready.front());
+         ready.pop_front();
+         task = std::move(s->tasks.front());
+         s->tasks.pop_front();
+      }
+
+      task(*s);
+      internal_use_do_not_use::set_current_chain(nullptr);
+      task = nullptr;
+
+      bool notify_worker = false;
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         if (s->tasks.empty()) {
+            s->scheduled = false;
+         } else {
+            ready.push_back(std::move(s));
+            notify_worker = true;
+         }
+         if (--pending == 0)
+            idle_cv.notify_all();
+      }
+      if (notify_worker)
+         cv.notify_one();
+   }
+}
+
+eosio::test_chain_pool::chain::~chain() {
+   if (!s)
+      return;
+   // Destroys the chain on a worker once the work queued before it has run
+   pool->enqueue(s, [](strand& st) { st.chain.reset(); });
+}
+
+std::future<eosio::transaction_trace> eosio::test_chain_pool::chain::push_transaction(std::vector<action>      actions,
+                                                                                   std::vector<private_key> keys) {
+   return post([actions = std::move(actions), keys = std::move(keys)](test_chain& c) mutable {
+      return c.push_transaction(c.make_transaction(std::move(actions)), keys);
+   });
+}
+
+std::future<eosio::transaction_trace> eosio::test_chain_pool::chain::transact(std::vector<action> actions,
+                                                                           const char*         expected_except) {
+   std::optional<std::string> expected;
+   if (expected_except)
+      expected = expected_except;
+   return post([actions = std::move(actions), expected = std::move(expected)](test_chain& c) mutable {
+      return c.transact(std::move(actions), expected ? expected->c_str() : nullptr);
+   });
+}
+
+std::future<void> eosio::test_chain_pool::chain::start_block(int64_t skip_miliseconds) {
+   return post([skip_miliseconds](test_chain& c) { c.start_block(skip_miliseconds); });
+}
+
+std::future<void> eosio::test_chain_pool::chain::finish_block() {
+   return post([](test_chain& c) { c.finish_block(); });
+}
+
+#endif
@@ -260,10 +260,15 @@ std::ostream& eosio::operator<<(std::ostream& os, const name& obj) {
 const eosio::public_key  eosio::test_chain::default_pub_key  = public_key_from_string("EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV");
 const eosio::private_key eosio::test_chain::default_priv_key = private_key_from_string("5KQwrPbwdL6PhXujxW37FSSQZ1JiwsST4cqQzDeyXtP79zkvFD3");
 
-// We only allow one chain to exist at a time in the tester.
-// If we ever find that we need multiple chains, this will
-// need to be kept in sync with whatever updates the native layer.
+// The chain send_inline pushes to. Native modules may drive one chain per thread through
+// test_chain_pool, so there it is per thread.
+#ifdef __wasm__
 static eosio::test_chain* current_chain = nullptr;
+#else
+static thread_local eosio::test_chain* current_chain = nullptr;
+#endif
+
+void eosio::internal_use_do_not_use::set_current_chain(test_chain* chain) { current_chain = chain; }
 
 eosio::test_chain::test_chain(const char* snapshot)
     : id{ ::create_chain(snapshot ? snapshot : "", snapshot ? strlen(snapshot) : 0) } {
@@ -366,6 +371,45 @@ eosio::transaction_trace eosio::test_chain::push_transaction(const transaction&
    return convert_from_bin<transaction_trace>(bin);
 }
 
+std::vector<eosio::transaction_result> eosio::test_chain::push_transactions(std::span<const transaction> trxs,
+                                                                           trace_mode mode,
+                                                                           const std::vector<private_key>& keys) {
+   // Every transaction of the batch shares the empty context free data and signatures, and the keys
+   std::vector<char> suffix;
+   (void)convert_to_bin(std::vector<std::vector<char>>{}, suffix);
+   (void)convert_to_bin(std::vector<signature>{}, suffix);
+   (void)convert_to_bin(keys, suffix);
+
+   std::vector<transaction_result> results;
+   results.reserve(trxs.size());
+   std::vector<char> packed_trx;
+   std::vector<char> args;
+   std::vector<char> bin;
+   for (const auto& trx : trxs) {
+      packed_trx.resize(pack_size(trx));
+      datastream<char*> ds(packed_trx.data(), packed_trx.size());
+      ds << trx;
+      args.clear();
+      (void)convert_to_bin(packed_trx, args);
+      args.insert(args.end(), suffix.begin(), suffix.end());
+      ::push_transaction(id, args.data(), args.size(), [&](size_t size) {
+         bin.resize(size);
+         return bin.data();
+      });
+
+      // The trace starts with its variant index, then id, status, cpu_usage_us, net_usage_words and elapsed
+      auto&                   result = results.emplace_back();
+      datastream<const char*> in(bin.data(), bin.size());
+      unsigned_int            version, net_usage_words;
+      uint8_t                 status;
+      in >> version >> result.id >> status >> result.cpu_usage_us >> net_usage_words >> result.elapsed;
+      result.status = transaction_status(status);
+      if (mode == trace_mode::full || (mode == trace_mode::failures && result.status != transaction_status::executed))
+         result.trace = convert_from_bin<transaction_trace>(bin);
+   }
+   return results;
+}
+
 eosio::transaction_trace eosio::test_chain::transact(std::vector<action>&& actions, const std::vector<private_key>& keys,
                                               const char* expected_except) {
    auto trace = push_transaction(make_transaction(std::move(actions)), keys);
@@ -544,6 +588,61 @@ eosio::transaction_trace eosio::test_chain::issue_and_transfer(const name& contr
          expected_except);
 }
 
+eosio::test_chain_fixture::test_chain_fixture(std::string name, std::vector<std::string> input_files,
+                                              std::function<void(test_chain&)> setup, std::string cache_dir)
+    : name(std::move(name)), input_files(std::move(input_files)), setup(std::move(setup)),
+      cache_dir(std::move(cache_dir)) {}
+
+const std::string& eosio::test_chain_fixture::snapshot() {
+#ifndef __wasm__
+   std::lock_guard<std::mutex> lock(mtx);
+#endif
+   if (!path.empty())
+      return path;
+
+   std::vector<char> key(name.begin(), name.end());
+   for (const auto& file : input_files) {
+      auto content = read_whole_file(file);
+      key.push_back(0);
+      key.insert(key.end(), file.begin(), file.end());
+      key.push_back(0);
+      key.insert(key.end(), content.begin(), content.end());
+   }
+   auto        digest = eosio::sha256(key.data(), key.size()).extract_as_byte_array();
+   std::string hash;
+   for (size_t i = 0; i < 8; ++i)
+      hash += fmt::format("{:02x}", unsigned(digest[i]));
+   std::string snapshot_path = cache_dir + "/" + name + "-" + hash + ".bin";
+
+   if (execute("test -s '" + snapshot_path + "'") != 0) {
+      // the fixture chain becomes the current chain; the caller's is restored even if setup throws
+      struct restore_current_chain {
+         test_chain* previous = current_chain;
+         ~restore_current_chain() { current_chain = previous; }
+      } restore;
+
+      test_chain chain;
+      setup(chain);
+      chain.finish_block();
+      std::string chain_path = chain.get_path();
+      std::string written    = chain_path + "/fixture.bin";
+      chain.write_snapshot(written.c_str());
+      // Copied under a temporary name and renamed, so other test processes building the same
+      // fixture never start from a partial snapshot. The name of the chain's temporary directory
+      // is unique, so it makes the temporary name unique too. The copy is a reflink where cp and
+      // the file system support it.
+      while (chain_path.size() > 1 && chain_path.back() == '/')
+         chain_path.pop_back();
+      std::string tmp    = "'" + snapshot_path + "." + chain_path.substr(chain_path.find_last_of('/') + 1) + "'";
+      auto        status = execute("mkdir -p '" + cache_dir + "' && { cp --reflink=auto '" + written + "' " + tmp +
+                                   " 2>/dev/null || cp '" + written + "' " + tmp + "; } && mv -f " + tmp + " '" +
+                                   snapshot_path + "'");
+      check(status == 0, "test_chain_fixture: cannot write " + snapshot_path);
+   }
+   path = std::move(snapshot_path);
+   return path;
+}
+
 eosio::test_rodeos::test_rodeos() : id{ create_rodeos() } {}
 
 eosio::test_rodeos::~test_rodeos() { destroy_rodeos(id); }
@@ -1,31 +1,29 @@
+#include <eosio/intrinsic_stats.hpp>
 #include <eosio/name.hpp>
 #include <memory>
 
 extern "C" void prints_l(const char* cstr, uint32_t len);
-extern "C" void prints(const char* cstr) { prints_l(cstr, strlen(cstr)); }
+extern "C" void prints(const char* cstr) {
+   EOSIO_INTRINSIC_STATS("prints", strlen(cstr));
+   prints_l(cstr, strlen(cstr));
+}
 
 extern "C" void printn(uint64_t n) {
-   std::string s = eosio::name_to_string(n);
-   prints_l(s.data(), s.size());
+   EOSIO_INTRINSIC_STATS("printn", 8);
+   char s[eosio::max_name_chars];
+   prints_l(s, eosio::write_name(s, eosio::name{n}) - s);
 }
 
 extern "C" void printui(uint64_t value) {
-   char  s[21];
-   char* ch = s;
-   do {
-      *ch++ = '0' + (value % 10);
-      value /= 10;
-   } while (value);
-   std::reverse(s, ch);
-   prints_l(s, ch - s);
+   EOSIO_INTRINSIC_STATS("printui", 8);
+   char s[eosio::max_decimal_chars<uint64_t>];
+   prints_l(s, eosio::write_unsigned(s, value) - s);
 }
 
 extern "C" void printi(int64_t value) {
-   if (value < 0) {
-      prints("-");
-      printui(-value);
-   } else
-      printui(value);
+   EOSIO_INTRINSIC_STATS("printi", 8);
+   char s[eosio::max_decimal_chars<int64_t>];
+   prints_l(s, eosio::write_signed(s, value) - s);
 }
 
 extern "C" {
@@ -76,8 +74,11 @@ namespace internal_use_do_not_use {
    extern "C" {
 
    void eosio_assert(uint32_t test, const char* msg) {
-      if (!test)
+      EOSIO_INTRINSIC_STATS("eosio_assert", 4);
+      if (!test) {
+         eosio::flush_print();
          eosio_assert_message(test, msg, strlen(msg));
+      }
    }
 
    void eosio_assert_code(uint32_t test, uint64_t code) {
@@ -148,3 +149,136 @@ namespace internal_use_do_not_use {
    } // extern "C"
 } // namespace internal_use_do_not_use
 } // namespace eosio
+
+#ifndef __wasm__
+#include <eosio/crypto.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+   // Persistent workers backing eosio::verify_*_sigs in native test harnesses. The calling thread works on
+   // the batch too, and each batch is split into a few chunks per thread so uneven items balance out.
+   // A batch started from inside a chunk runs inline, since the pool is busy with the outer batch.
+   class verify_pool {
+    public:
+      static verify_pool& instance() {
+         static verify_pool pool;
+         return pool;
+      }
+
+      void run( uint32_t n, void (*fn)(void*, uint32_t, uint32_t), void* ctx ) {
+         if ( workers.empty() || n < 2 || in_batch ) {
+            if ( n > 0 )
+               fn( ctx, 0, n );
+            return;
+         }
+
+         std::lock_guard<std::mutex> run_lock( run_mtx );
+         job j( fn, ctx, n, std::max<uint32_t>( 1, n / (4 * (workers.size() + 1)) ) );
+         {
+            std::lock_guard<std::mutex> lock( mtx );
+            current = &j;
+            busy    = workers.size();
+            ++generation;
+         }
+         cv.notify_all();
+         work( j );
+
+         std::unique_lock<std::mutex> lock( mtx );
+         done_cv.wait( lock, [&] { return busy == 0; } );
+         current = nullptr;
+         if ( j.error )
+            std::rethrow_exception( j.error );
+      }
+
+      ~verify_pool() {
+         {
+            std::lock_guard<std::mutex> lock( mtx );
+            stopping = true;
+         }
+         cv.notify_all();
+         for ( auto& t : workers )
+            t.join();
+      }
+
+    private:
+      struct job {
+         job( void (*fn)(void*, uint32_t, uint32_t), void* ctx, uint32_t n, uint32_t chunk )
+            : fn(fn), ctx(ctx), n(n), chunk(chunk) {}
+
+         void (*fn)(void*, uint32_t, uint32_t);
+         void*                 ctx;
+         uint32_t              n;
+         uint32_t              chunk;
+         std::atomic<uint64_t> next = 0;
+         std::mutex            error_mtx;
+         std::exception_ptr    error;
+      };
+
+      verify_pool() {
+         unsigned threads = std::thread::hardware_concurrency();
+         for ( unsigned i = 1; i < threads; ++i )
+            workers.emplace_back( [this] { worker_loop(); } );
+      }
+
+      static void work( job& j ) {
+         in_batch = true;
+         try {
+            for ( uint64_t begin; (begin = j.next.fetch_add( j.chunk )) < j.n; )
+               j.fn( j.ctx, begin, std::min<uint64_t>( j.n, begin + j.chunk ) );
+         } catch ( ... ) {
+            std::lock_guard<std::mutex> lock( j.error_mtx );
+            if ( !j.error )
+               j.error = std::current_exception();
+            j.next = j.n;
+         }
+         in_batch = false;
+      }
+
+      void worker_loop() {
+         uint64_t seen = 0;
+         for ( ;; ) {
+            job* j;
+            {
+               std::unique_lock<std::mutex> lock( mtx );
+               cv.wait( lock, [&] { return stopping || generation != seen; } );
+               if ( stopping )
+                  return;
+               seen = generation;
+               j    = current;
+            }
+            work( *j );
+            {
+               std::lock_guard<std::mutex> lock( mtx );
+               if ( --busy == 0 )
+                  done_cv.notify_one();
+            }
+         }
+      }
+
+      static inline thread_local bool in_batch = false;
+
+      std::vector<std::thread> workers;
+      std::mutex               run_mtx;
+      std::mutex               mtx;
+      std::condition_variable  cv;
+      std::condition_variable  done_cv;
+      job*                     current    = nullptr;
+      size_t                   busy       = 0;
+      uint64_t                 generation = 0;
+      bool                     stopping   = false;
+   };
+} // namespace
+
+namespace eosio::internal_use_do_not_use {
+   void parallel_for( uint32_t n, void (*fn)(void* ctx, uint32_t begin, uint32_t end), void* ctx ) {
+      verify_pool::instance().run( n, fn, ctx );
+   }
+}
+#endif
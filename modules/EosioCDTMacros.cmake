@@ -87,9 +87,32 @@ function(add_module TARGET)
   endif()
 endfunction()
 
+# Instruments a native target for eosio::native::profiler; no effect on wasm targets.
+# Symbols keep default visibility so the profile can name the functions, and frame pointers are
+# kept so the profiler can tell which frames an exception has unwound.
+function(target_native_profiling TARGET)
+  if (NOT IS_WASM_TARGET)
+    target_compile_options(${TARGET} PRIVATE -fno-omit-frame-pointer)
+    if (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+      target_compile_options(${TARGET} PRIVATE -finstrument-functions-after-inlining)
+    else()
+      target_compile_options(${TARGET} PRIVATE -finstrument-functions)
+    endif()
+    set_target_properties(${TARGET} PROPERTIES CXX_VISIBILITY_PRESET default)
+    get_target_property(type ${TARGET} TYPE)
+    if (type STREQUAL "EXECUTABLE")
+      set_target_properties(${TARGET} PROPERTIES ENABLE_EXPORTS ON)
+    endif()
+    target_link_libraries(${TARGET} PRIVATE eosio::profiler)
+  endif()
+endfunction()
+
 macro(add_contract CONTRACT_NAME TARGET)
   add_module(${TARGET} ${ARGN})
   target_link_libraries(${TARGET} PRIVATE eosio::eosio)
+  if (EOSIO_NATIVE_PROFILING)
+    target_native_profiling(${TARGET})
+  endif()
   if (IS_WASM_TARGET)
     target_link_options(${TARGET}  PRIVATE -Wl,--entry,apply)
   endif()
@@ -66,6 +66,13 @@ namespace eosio { namespace cdt {
          _abi.wasm_actions.insert(ret);
       }
 
+      void add_wasm_action(const std::string& name, const std::string& handler) {
+         wasm_action ret;
+         ret.name = name;
+         ret.handler = handler;
+         _abi.wasm_actions.insert(ret);
+      }
+
       template<typename T>
       void add_wasm_notify(const clang_wrapper::Decl<T>& decl, const std::string& handler) {
          wasm_notify ret;
@@ -158,6 +165,29 @@ namespace eosio { namespace cdt {
          }
       }
 
+      void add_batch_action( const clang::CXXMethodDecl* _decl ) {
+         auto decl = clang_wrapper::wrap_decl(_decl);
+         auto batch_name = get_batch_action_name(decl);
+         validate_name( batch_name, [&](auto s) { CDT_ERROR("abigen_error", decl->getLocation(), s); } );
+
+         // the batch payload is a vector of the action's own argument type
+         abi_struct batch_struct;
+         batch_struct.name = "batch_" + decl->getNameAsString();
+         batch_struct.fields.push_back({"items", get_action_type(_decl) + "[]"});
+         _abi.structs.insert(batch_struct);
+
+         abi_action ret;
+         ret.name = batch_name;
+         ret.type = batch_struct.name;
+         ret.ricardian_contract = rcs[batch_name];
+         _abi.actions.insert(ret);
+
+         if (translate_type(decl->getReturnType()) != "void") {
+            add_type(decl->getReturnType());
+            _abi.action_results.insert({batch_name, translate_type(decl->getReturnType()) + "[]"});
+         }
+      }
+
       void add_tuple(std::string name, const clang::ArrayRef<clang::TemplateArgument>& args) {
          abi_struct tup;
          tup.name = name;
@@ -490,7 +520,7 @@ namespace eosio { namespace cdt {
             if (ctsd) {
                auto& args = ctsd->getTemplateArgs(); 
                auto name = ctsd->getQualifiedNameAsString();
-               static const std::vector<std::string> one_arg_types = {"std::vector", "std::set", "std::deque", "std::list", "std::optional", "eosio::binary_extension", "eosio::ignore", "std::array"};
+               static const std::vector<std::string> one_arg_types = {"std::vector", "std::set", "std::deque", "std::list", "std::optional", "eosio::binary_extension", "eosio::ignore", "std::array", "eosio::result_stream"};
 
                if (std::find(one_arg_types.begin(), one_arg_types.end(), name) != one_arg_types.end()) {
                   auto arg = args[0].getAsType();
@@ -766,7 +796,7 @@ namespace eosio { namespace cdt {
       ///
       inline std::pair<std::string, std::string> get_type_strings(const clang::QualType& type) {
 
-         static const std::vector<std::string> sequence_types{"std::vector", "std::set", "std::deque", "std::list"};
+         static const std::vector<std::string> sequence_types{"std::vector", "std::set", "std::deque", "std::list", "eosio::result_stream"};
 
          auto ctsd = get_template_specialization(type);
 
@@ -1334,6 +1364,8 @@ namespace eosio { namespace cdt {
             if (decl.isEosioAction() && ag.is_eosio_contract(decl, ag.get_contract_name())) {
                ag.add_struct(*decl);
                ag.add_action(*decl);
+               if (decl.isEosioBatch())
+                  ag.add_batch_action(*decl);
                for (auto param : decl->parameters()) {
                   ag.add_type( param->getType() );
                }
@@ -86,6 +86,10 @@ namespace blanc { namespace clang_wrapper {
             return attrs.find("eosio_read_only") != attrs.end();
          }
 
+         bool isEosioBatch() const {
+            return attrs.find("eosio_batch") != attrs.end();
+         }
+
          const Attr* getEosioActionAttr() const {
             return isEosioAction() ? &attrs.at("eosio_action") : nullptr;
          }
@@ -106,6 +110,10 @@ namespace blanc { namespace clang_wrapper {
             return isEosioNotify() ? &attrs.at("eosio_on_notify") : nullptr;
          }
 
+         const Attr* getEosioBatchAttr() const {
+            return isEosioBatch() ? &attrs.at("eosio_batch") : nullptr;
+         }
+
          const Attr* getEosioRicardianAttr() const {
             static const Attr empty{""};
             return &empty;
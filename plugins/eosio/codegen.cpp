@@ -71,6 +71,26 @@ public:
      main_name = mn;
    }
 
+   std::string get_param_type_name(const ParmVarDecl* param) const {
+      clang::LangOptions lang_opts;
+      lang_opts.CPlusPlus = true;
+      lang_opts.Bool = true;
+      clang::PrintingPolicy policy(lang_opts);
+      auto qt = param->getOriginalType().getNonReferenceType();
+      qt.removeLocalConst();
+      qt.removeLocalVolatile();
+      qt.removeLocalRestrict();
+      return clang::TypeName::getFullyQualifiedName(qt, ci->getASTContext(), policy);
+   }
+
+   static bool is_read_only(CXXMethodDecl* decl) {
+      return clang_wrapper::wrap_decl(decl).isEosioReadOnly();
+   }
+
+   static bool is_read_only(const clang_wrapper::Decl<CXXMethodDecl*>& decl) {
+      return decl.isEosioReadOnly();
+   }
+
    template <typename F, typename D>
    void create_dispatch(const std::string& attr, const std::string& func_name, F&& get_str, D decl) {
       constexpr static uint32_t max_stack_size = 512;
@@ -83,31 +103,30 @@ public:
          ss << "  [[clang::import_name(\"read_action_data\")]]\n";
          ss << "  uint32_t read_action_data(void*, uint32_t);\n";
          const auto& return_ty = decl->getReturnType().getAsString();
+         const auto* return_rd = decl->getReturnType().getNonReferenceType()->getAsCXXRecordDecl();
+         const bool  stream_result = return_rd && return_rd->getQualifiedNameAsString() == "eosio::result_stream";
+         // a read-only query without arguments has nothing to decode, skip the action data host calls entirely
+         const bool  lean_entry = decl->parameters().empty() && is_read_only(decl);
          if (return_ty != "void")
             ss << "  [[clang::import_name(\"set_action_return_value\")]]\n";
             ss << "  void set_action_return_value(void*, uint32_t);\n";
          ss << "  __attribute__((weak))\n";
          ss << "  void " << func_name << nm << "(unsigned long long r, unsigned long long c) {\n";
-         ss << "    size_t as = ::action_data_size();\n";
-         ss << "    auto free_memory = [as](void* buf) { if (as >= " << max_stack_size << ") free(buf);};\n";
-         ss << "    std::unique_ptr<void, decltype(free_memory)> buff{nullptr, free_memory};\n";
-         ss << "    if (as > 0) {\n";
-         ss << "      buff.reset(as >= " << max_stack_size << " ? malloc(as) : alloca(as));\n";
-         ss << "      ::read_action_data(buff.get(), as);\n";
-         ss << "    }\n";
-         ss << "    eosio::datastream<const char*> ds{(char*)buff.get(), as};\n";
+         if (lean_entry) {
+            ss << "    eosio::datastream<const char*> ds{nullptr, 0};\n";
+         } else {
+            ss << "    size_t as = ::action_data_size();\n";
+            ss << "    auto free_memory = [as](void* buf) { if (as >= " << max_stack_size << ") free(buf);};\n";
+            ss << "    std::unique_ptr<void, decltype(free_memory)> buff{nullptr, free_memory};\n";
+            ss << "    if (as > 0) {\n";
+            ss << "      buff.reset(as >= " << max_stack_size << " ? malloc(as) : alloca(as));\n";
+            ss << "      ::read_action_data(buff.get(), as);\n";
+            ss << "    }\n";
+            ss << "    eosio::datastream<const char*> ds{(char*)buff.get(), as};\n";
+         }
          int i=0;
          for (auto param : decl->parameters()) {
-            clang::LangOptions lang_opts;
-            lang_opts.CPlusPlus = true;
-            lang_opts.Bool = true;
-            clang::PrintingPolicy policy(lang_opts);
-            auto qt = param->getOriginalType().getNonReferenceType();
-            qt.removeLocalConst();
-            qt.removeLocalVolatile();
-            qt.removeLocalRestrict();
-            std::string tn = clang::TypeName::getFullyQualifiedName(qt, ci->getASTContext(), policy);
-            ss << "    " << tn << " arg" << i << "; ds >> arg" << i << ";\n";
+            ss << "    " << get_param_type_name(param) << " arg" << i << "; ds >> arg" << i << ";\n";
             i++;
          }
          const auto& call_action = [&]() {
@@ -120,11 +139,15 @@ public:
             ss << ");\n";
          };
          ss << "    ";
-         if (return_ty != "void") {
+         if (stream_result) {
+            ss << "auto result = ";
+         } else if (return_ty != "void") {
             ss << "const auto& result = ";
          }
          call_action();
-         if (return_ty != "void") {
+         if (stream_result) {
+            ss << "    result.write_return_value();\n";
+         } else if (return_ty != "void") {
             ss << "    const auto& packed_result = eosio::pack(result);\n";
             ss << "    set_action_return_value((void*)packed_result.data(), packed_result.size());\n";
          }
@@ -134,6 +157,70 @@ public:
       }
    }
 
+   // The batch handler decodes `vector<action>` one element at a time and invokes the action on a single
+   // contract instance, so member tables and their caches stay alive across the whole batch.
+   void create_batch_dispatch(CXXMethodDecl* decl) {
+      constexpr static uint32_t max_stack_size = 512;
+      std::string nm = decl->getNameAsString()+"_"+decl->getParent()->getNameAsString();
+      if (is_eosio_contract(decl, contract_name)) {
+         const auto& return_ty = decl->getReturnType().getAsString();
+         ss << "\n\nextern \"C\" {\n";
+         ss << "  [[clang::import_name(\"action_data_size\")]]\n";
+         ss << "  uint32_t action_data_size();\n";
+         ss << "  [[clang::import_name(\"read_action_data\")]]\n";
+         ss << "  uint32_t read_action_data(void*, uint32_t);\n";
+         if (return_ty != "void") {
+            ss << "  [[clang::import_name(\"set_action_return_value\")]]\n";
+            ss << "  void set_action_return_value(void*, uint32_t);\n";
+         }
+         ss << "  __attribute__((weak))\n";
+         ss << "  void __eosio_action_batch_" << nm << "(unsigned long long r, unsigned long long c) {\n";
+         ss << "    size_t as = ::action_data_size();\n";
+         ss << "    auto free_memory = [as](void* buf) { if (as >= " << max_stack_size << ") free(buf);};\n";
+         ss << "    std::unique_ptr<void, decltype(free_memory)> buff{nullptr, free_memory};\n";
+         ss << "    if (as > 0) {\n";
+         ss << "      buff.reset(as >= " << max_stack_size << " ? malloc(as) : alloca(as));\n";
+         ss << "      ::read_action_data(buff.get(), as);\n";
+         ss << "    }\n";
+         ss << "    eosio::datastream<const char*> ds{(char*)buff.get(), as};\n";
+         ss << "    eosio::unsigned_int batch_size; ds >> batch_size;\n";
+         ss << "    " << decl->getParent()->getQualifiedNameAsString() << " self{eosio::name{r},eosio::name{c},ds};\n";
+         if (return_ty != "void") {
+            ss << "    std::vector<std::decay_t<decltype(self." << decl->getNameAsString() << "(";
+            for (int i=0; i < decl->parameters().size(); i++) {
+               ss << "std::declval<" << get_param_type_name(decl->getParamDecl(i)) << ">()";
+               if (i < decl->parameters().size()-1)
+                  ss << ", ";
+            }
+            ss << "))>> results;\n";
+            ss << "    results.reserve(batch_size.value);\n";
+         }
+         ss << "    for (uint32_t batch_index = 0; batch_index < batch_size.value; ++batch_index) {\n";
+         int i=0;
+         for (auto param : decl->parameters()) {
+            ss << "      " << get_param_type_name(param) << " arg" << i << "; ds >> arg" << i << ";\n";
+            i++;
+         }
+         ss << "      ";
+         if (return_ty != "void")
+            ss << "results.push_back(";
+         ss << "self." << decl->getNameAsString() << "(";
+         for (int i=0; i < decl->parameters().size(); i++) {
+            ss << "std::move(arg" << i << ")";
+            if (i < decl->parameters().size()-1)
+               ss << ", ";
+         }
+         ss << (return_ty != "void" ? "));\n" : ");\n");
+         ss << "    }\n";
+         if (return_ty != "void") {
+            ss << "    const auto& packed_results = eosio::pack(results);\n";
+            ss << "    set_action_return_value((void*)packed_results.data(), packed_results.size());\n";
+         }
+         ss << "  }\n";
+         ss << "}\n";
+      }
+   }
+
    void create_action_dispatch(clang_wrapper::Decl<CXXMethodDecl*> decl) {
       auto func = [](clang_wrapper::Decl<CXXMethodDecl*> d) { return generation_utils::get_action_name(d); };
       create_dispatch("eosio_wasm_action", "__eosio_action_", func, decl);
@@ -178,6 +265,23 @@ public:
          }
          actions.insert(full_action_name); // insert the method action, so we don't create the dispatcher twice
 
+         if (decl.isEosioBatch()) {
+            auto batch_name = generation_utils::get_batch_action_name(decl);
+            validate_name(batch_name, [&](auto s) {
+               CDT_ERROR("codegen_error", decl->getLocation(), std::string("batch action name (")+batch_name+") is not a valid eosio name, "
+                                                               "pass an explicit name with eosio::batch(\"<name>\")");
+            });
+            if (!_action_set.count(batch_name))
+               _action_set.insert(batch_name);
+
+            std::string full_batch_name = "__eosio_action_batch_" + decl->getNameAsString() + "_" + decl->getParent()->getNameAsString();
+            if (actions.count(full_batch_name) == 0) {
+               create_batch_dispatch(*decl);
+               abigen::get().add_wasm_action(batch_name, full_batch_name);
+            }
+            actions.insert(full_batch_name);
+         }
+
          if (decl.isEosioReadOnly()) {
             read_only_actions.insert(*decl);
          }
@@ -374,13 +478,13 @@ class eosio_codegen_consumer : public ASTConsumer {
 private:
    std::string main_file;
    CompilerInstance* ci;
-   int smart_contract_trace_level;
+   smart_contract_trace_options trace_options;
 
 public:
    std::unique_ptr<eosio_codegen_visitor> visitor;
 
-   explicit eosio_codegen_consumer(CompilerInstance* CI, StringRef file, int smart_contract_trace_level_) 
-      : visitor(std::make_unique<eosio_codegen_visitor>(CI)), main_file(file), ci(CI), smart_contract_trace_level(smart_contract_trace_level_) {}
+   explicit eosio_codegen_consumer(CompilerInstance* CI, StringRef file, const smart_contract_trace_options& trace_options_) 
+      : visitor(std::make_unique<eosio_codegen_visitor>(CI)), main_file(file), ci(CI), trace_options(trace_options_) {}
 
    void HandleTranslationUnit(ASTContext& Context) override {
       auto& src_mgr = Context.getSourceManager();
@@ -395,8 +499,8 @@ public:
          visitor->process_read_only_actions();
 
          std::string output_debug_file_name; // need to be outside because visitor refer to it
-         if (smart_contract_trace_level) {
-            std::unique_ptr<eosio_tracegen_visitor> trace_visitor(std::make_unique<eosio_tracegen_visitor>(ci, main_file, smart_contract_trace_level));
+         if (trace_options.level) {
+            std::unique_ptr<eosio_tracegen_visitor> trace_visitor(std::make_unique<eosio_tracegen_visitor>(ci, main_file, trace_options));
             trace_visitor->TraverseDecl(Context.getTranslationUnitDecl());
             output_debug_file_name = std::string(main_fe->getName()) + ".debug";
             if (size_t inserted_count = trace_visitor->inject_debugging_code(main_fe->getName().str(), output_debug_file_name)) {
@@ -413,14 +517,14 @@ public:
 class eosio_codegen_frontend_action: public PluginASTAction {
 private:
    std::string contract_name;
-   int smart_contract_trace_level = (int)eosio_tracegen_visitor::smart_contract_trace_level_t::none;
+   smart_contract_trace_options trace_options;
 
 public:
    std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance& CI, StringRef file) override {
-      if (smart_contract_trace_level > (int)eosio_tracegen_visitor::smart_contract_trace_level_t::none) {
-         std::cout << "eosio_codegen_frontend_action: file=" << std::string(file) << " smart_contract_trace_level=" << smart_contract_trace_level << std::endl;
+      if (trace_options.level > (int)eosio_tracegen_visitor::smart_contract_trace_level_t::none) {
+         std::cout << "eosio_codegen_frontend_action: file=" << std::string(file) << " smart_contract_trace_level=" << trace_options.level << std::endl;
       }
-      auto consumer = std::make_unique<eosio_codegen_consumer>(&CI, file, smart_contract_trace_level);
+      auto consumer = std::make_unique<eosio_codegen_consumer>(&CI, file, trace_options);
       consumer->visitor->set_contract_name(contract_name);
       return consumer;
    }
@@ -436,10 +540,36 @@ public:
             contract_name = arg.substr(arg.find("=")+1);
          } else if (eosio::cdt::starts_with(arg, "smart-contract-trace-level=")) {
             std::string value = arg.substr(arg.find("=")+1);
-            if (::sscanf(value.c_str(), "%d", &smart_contract_trace_level) != 1) {
+            if (::sscanf(value.c_str(), "%d", &trace_options.level) != 1) {
                std::cerr << "failed to parse smart-contract-trace-level" << std::endl;
                return false;
             }
+         } else if (eosio::cdt::starts_with(arg, "smart-contract-trace-format=")) {
+            std::string value = arg.substr(arg.find("=")+1);
+            if (value != "text" && value != "binary") {
+               std::cerr << "smart-contract-trace-format must be text or binary" << std::endl;
+               return false;
+            }
+            trace_options.binary = value == "binary";
+         } else if (eosio::cdt::starts_with(arg, "smart-contract-trace-functions=")) {
+            // globs are separated by ';' since ',' separates the plugin arguments
+            for (auto& glob : tokenize(arg.substr(arg.find("=")+1), ";")) {
+               if (glob.empty())
+                  continue;
+               if (auto pattern = llvm::GlobPattern::create(glob); !pattern) {
+                  llvm::consumeError(pattern.takeError());
+                  std::cerr << "invalid smart-contract-trace-functions glob " << glob << std::endl;
+                  return false;
+               }
+               trace_options.functions.push_back(glob);
+            }
+         } else if (eosio::cdt::starts_with(arg, "smart-contract-trace-sample=")) {
+            std::string value = arg.substr(arg.find("=")+1);
+            if (::sscanf(value.c_str(), "%u/%u", &trace_options.sample_n, &trace_options.sample_m) != 2 ||
+                trace_options.sample_m == 0 || trace_options.sample_n > trace_options.sample_m) {
+               std::cerr << "smart-contract-trace-sample must be N/M with 0 <= N <= M and M > 0" << std::endl;
+               return false;
+            }
          } else {
             return false;
          }
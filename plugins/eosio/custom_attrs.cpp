@@ -92,6 +92,7 @@ BLANC_ATTR(EosioWasmAction, eosio_wasm_action, eosio::wasm_action, 0, 1, (!isa<F
 BLANC_ATTR(EosioWasmNotify, eosio_wasm_notify, eosio::wasm_notify, 0, 1, (!isa<FunctionDecl>(D)))
 BLANC_ATTR(EosioWasmAbi, eosio_wasm_abi, eosio::wasm_abi, 0, 1, (!isa<FunctionDecl>(D)))
 BLANC_ATTR(EosioReadOnly, eosio_read_only, eosio::read_only, 0, 0, (!isa<FunctionDecl>(D)))
+BLANC_ATTR(EosioBatch, eosio_batch, eosio::batch, 0, 1, (!isa<CXXMethodDecl>(D)))
 BLANC_ATTR(EosioType, eosio_type, eosio::type, 1, 0, (!isa<FieldDecl>(D)))
 
 namespace blanc {
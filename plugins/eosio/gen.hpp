@@ -163,6 +163,21 @@ struct generation_utils {
       return get_action_name(_decl);
    }
 
+   // eosio names cannot contain '_', so the companion batch action defaults to "<action>.b"
+   template<typename T>
+   static inline std::string get_batch_action_name( const clang_wrapper::Decl<T>& decl ) {
+      auto tmp = decl.getEosioBatchAttr()->getNameAsString();
+      if (!tmp.empty())
+         return tmp;
+      return get_action_name(decl) + ".b";
+   }
+
+   template<typename T>
+   static inline std::string get_batch_action_name( T decl ) {
+      auto _decl = clang_wrapper::wrap_decl(decl);
+      return get_batch_action_name(_decl);
+   }
+
    template<typename T>
    static inline std::string get_notify_pair( const clang_wrapper::Decl<T>& decl ) {
       std::string notify_pair = "";
@@ -7,6 +7,8 @@
 #include <clang/Frontend/FrontendPluginRegistry.h>
 #include <clang/Rewrite/Core/Rewriter.h>
 
+#include <llvm/Support/GlobPattern.h>
+
 #include <fstream>
 #include "tokenize.hpp"
 #include "gen.hpp"
@@ -15,6 +17,17 @@
 using namespace clang;
 using namespace eosio::cdt;
 
+struct smart_contract_trace_options {
+   int level = 0;
+   // record checkpoint ids into a ring buffer (binary_trace.hpp) instead of printing text
+   bool binary = false;
+   // only instrument functions whose name or qualified name matches one of these globs
+   std::vector<std::string> functions;
+   // record sample_n of every sample_m statement checkpoints
+   uint32_t sample_n = 1;
+   uint32_t sample_m = 1;
+};
+
 class eosio_tracegen_visitor : public RecursiveASTVisitor<eosio_tracegen_visitor>, public generation_utils {
 private:
    CompilerInstance* ci;
@@ -25,11 +38,15 @@ public: // smart contract tracking
    enum class smart_contract_trace_level_t : int {
       none = 0,
       statement,
-      full
+      full,
+      function // function entry & exit only, exit records the number of traced calls made
    };
    std::string main_file;
    SourceManager *sm = nullptr;
    int smart_contract_trace_level = (int)smart_contract_trace_level_t::none;
+   bool binary_trace = false;
+   std::vector<llvm::GlobPattern> function_globs;
+   uint32_t sample_n = 1, sample_m = 1;
 
    bool in_const_func = false;
    clang::Stmt *func_body = nullptr;
@@ -68,12 +85,22 @@ public: // smart contract tracking
 
 public:
 
-   explicit eosio_tracegen_visitor(CompilerInstance* CI, std::string main_file_, int smart_contract_trace_level_): ci(CI) {
+   explicit eosio_tracegen_visitor(CompilerInstance* CI, std::string main_file_, const smart_contract_trace_options& options): ci(CI) {
 
       get_error_emitter().set_compiler_instance(CI);
 
       sm = &(CI->getSourceManager());
-      smart_contract_trace_level = smart_contract_trace_level_;
+      smart_contract_trace_level = options.level;
+      binary_trace = options.binary;
+      sample_n = options.sample_n;
+      sample_m = options.sample_m;
+      for (const auto& glob : options.functions) {
+         if (auto pattern = llvm::GlobPattern::create(glob)) {
+            function_globs.push_back(std::move(*pattern));
+         } else {
+            llvm::consumeError(pattern.takeError());
+         }
+      }
       main_file = main_file_;
    }
 
@@ -201,9 +228,22 @@ public:
       }
    }
 
+   bool is_function_traced(clang::FunctionDecl* fd) const {
+      if (function_globs.empty())
+         return true;
+      std::string name = fd->getNameInfo().getAsString();
+      std::string qualified_name = fd->getQualifiedNameAsString();
+      for (const auto& glob : function_globs) {
+         if (glob.match(name) || glob.match(qualified_name))
+            return true;
+      }
+      return false;
+   }
+
    void visitDecl_for_tracking(clang::Decl* decl, clang::FunctionDecl* fd) {
       if (smart_contract_trace_level >= (int)smart_contract_trace_level_t::statement 
          && !(fd->isConstexpr()) 
+         && is_function_traced(fd)
          && fd->hasBody() 
          && fd->getBody()->getStmtClass() == clang::Stmt::CompoundStmtClass) {
          std::string func_name = fd->getNameInfo().getAsString();
@@ -216,7 +256,10 @@ public:
                stmt->getBeginLoc(), 
                stmt->getEndLoc(), 
                check_point_t::func_enter, func_name)) {
-               
+
+            if (smart_contract_trace_level == (int)smart_contract_trace_level_t::function)
+               return;
+
             // ParmVarDecl : VarDecl
             // VarDecl : DeclaratorDecl, Redeclarable<VarDecl>
             // DeclaratorDecl (has inner source location) : ValueDecl
@@ -279,10 +322,13 @@ public:
    }
 
    // return number of checkpoints inserted
+   // in binary mode the checkpoint id to source location map is written to <main file>.tracemap
    size_t inject_debugging_code(std::string main_fe_name, std::string output_debug_filename) {
 
       size_t insert_count = 0;
       std::stringstream out_data;
+      std::stringstream trace_map;
+      uint32_t next_trace_id = 1;
       llvm::SmallString<64> abs_file_path(main_fe_name);
       llvm::sys::fs::make_absolute(abs_file_path);
       std::string short_fn = abs_file_path.c_str();
@@ -294,9 +340,20 @@ public:
          std::cerr << "failed to open " << abs_file_path.c_str() << ". smart contract tracing will be disabled.\n";
          out_data << "#include \"" << abs_file_path.c_str() << "\"\n";
          return 0;
+      } else if (binary_trace) {
+         out_data << "#include <eosio/binary_trace.hpp>\n";
       } else {
          out_data << "#include <stdio.h>\n"; // need printf
-         if (smart_contract_trace_level >= (int)eosio_tracegen_visitor::smart_contract_trace_level_t::full) {
+      }
+      const bool trace_functions_only = smart_contract_trace_level == (int)eosio_tracegen_visitor::smart_contract_trace_level_t::function;
+      const bool sample_statements = sample_m > 1;
+      if (fin && (trace_functions_only || sample_statements)) {
+         out_data << "static unsigned _cdt_trace_call_count;\n"
+                  << "static unsigned _cdt_trace_sample_tick;\n"
+                  << "static inline bool _cdt_trace_sampled() { return _cdt_trace_sample_tick++ % " << sample_m << " < " << sample_n << "; }\n";
+      }
+      if (fin) {
+         if (!binary_trace && smart_contract_trace_level == (int)eosio_tracegen_visitor::smart_contract_trace_level_t::full) {
             out_data << R"(
 #include <optional>
 #include <vector>
@@ -432,8 +489,25 @@ template <typename T> inline void _cdt_debug_print_var(const char *varname, cons
                continue;
             }
 
+            auto add_trace_id = [&](const char* kind, const std::string& name) {
+               uint32_t id = next_trace_id++;
+               // tab separated, since file and function names (operator bool) may contain spaces
+               trace_map << id << '\t' << kind << '\t' << short_fn << ":" << line << ":" << col << '\t' << name << "\n";
+               return id;
+            };
+
             auto insert_code = [&](const eosio_tracegen_visitor::check_point_t &cp) {
-               if (cp.variable.length()) {
+               if (!cp.variable.length() && sample_statements) {
+                  out_data << "if (_cdt_trace_sampled()) ";
+               }
+               if (binary_trace) {
+                  if (!cp.variable.length()) {
+                     out_data << "eosio::internal_use_do_not_use::binary_trace(" << add_trace_id("stmt", cp.func) << ");";
+                  } else if (smart_contract_trace_level == (int)eosio_tracegen_visitor::smart_contract_trace_level_t::full) {
+                     out_data << "eosio::internal_use_do_not_use::binary_trace_var(" << add_trace_id("var", cp.variable)
+                              << "," << cp.variable << ");";
+                  }
+               } else if (cp.variable.length()) {
                   if (smart_contract_trace_level == (int)eosio_tracegen_visitor::smart_contract_trace_level_t::full) {
                      out_data << "_cdt_debug_print_var(\"," + cp.variable + "\"," + cp.variable + ");";
                   }
@@ -447,6 +521,16 @@ template <typename T> inline void _cdt_debug_print_var(const char *varname, cons
                ++insert_count;
             };
 
+            // the destructor of a local struct records function exit; in function mode it also reports
+            // how many traced calls, this one included, ran before the function returned
+            auto insert_exit_struct = [&](const std::string& name, const std::string& record) {
+               out_data << "struct " << name << "{";
+               if (trace_functions_only) {
+                  out_data << "unsigned _c=++_cdt_trace_call_count;";
+               }
+               out_data << "~" << name << "(){" << record << "}} " << name << "_1;";
+            };
+
             if (check_points.find(line_col) != check_points.end()) {
                const std::vector<eosio_tracegen_visitor::check_point_t> &list = check_points[line_col];
                for (size_t i = 0; i < list.size(); ++i) {
@@ -461,12 +545,33 @@ template <typename T> inline void _cdt_debug_print_var(const char *varname, cons
                      tmp_struct_ss << "_cdt_debug_func_" << line;
                      std::string tmp_struct_name = tmp_struct_ss.str();
 
+                     if (binary_trace) {
+                        uint32_t enter_id = add_trace_id("enter", list[i].func);
+                        uint32_t exit_id = add_trace_id("exit", list[i].func);
+                        std::stringstream record;
+                        record << "eosio::internal_use_do_not_use::binary_trace(" << exit_id;
+                        if (trace_functions_only) {
+                           record << ",eosio::internal_use_do_not_use::binary_trace_kind::unsigned_,_cdt_trace_call_count-_c+1";
+                        }
+                        record << ");";
+                        insert_exit_struct(tmp_struct_name, record.str());
+                        out_data << "eosio::internal_use_do_not_use::binary_trace(" << enter_id << ");";
+                        ++insert_count;
+                        while ((++i) < list.size() && list[i].variable.length()) {
+                           insert_code(list[i]);
+                        }
+                        --i;
+                        continue;
+                     }
+
                      // insert a tmp class to capture function exit
-                     out_data << "struct " << tmp_struct_name
-                              << "{~" << tmp_struct_name 
-                              << "(){printf(\"@" << short_fn << "(~" << list[i].func << ")@\");}"
-                              << "} " 
-                              << tmp_struct_name << "_1;";
+                     std::stringstream record;
+                     if (trace_functions_only) {
+                        record << "printf(\"@" << short_fn << "(~" << list[i].func << ":%u)@\",_cdt_trace_call_count-_c+1);";
+                     } else {
+                        record << "printf(\"@" << short_fn << "(~" << list[i].func << ")@\");";
+                     }
+                     insert_exit_struct(tmp_struct_name, record.str());
 
                      // insert function enter
                      out_data << "printf(\"@" << short_fn << ":" << line << ":" << col << "(@" << list[i].func << "\");";
@@ -496,6 +601,13 @@ template <typename T> inline void _cdt_debug_print_var(const char *varname, cons
       std::ofstream debug_file_stream(output_debug_filename.c_str());
       debug_file_stream << out_data.str();
       debug_file_stream.close();
+
+      if (binary_trace && insert_count) {
+         std::string trace_map_filename = std::string(abs_file_path.c_str()) + ".tracemap";
+         std::ofstream trace_map_stream(trace_map_filename.c_str());
+         trace_map_stream << trace_map.str();
+         std::cout << "trace map " << trace_map_filename << " generated\n";
+      }
       return insert_count;
    }
 
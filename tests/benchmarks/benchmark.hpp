@@ -0,0 +1,61 @@
+#pragma once
+
+#include "timing.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ *  Minimal benchmark harness shared by the native and wasm builds of cdt_benchmarks.
+ *
+ *  A benchmark body receives an iteration count and runs the measured operation that many times.
+ *  The runner grows the count until one batch takes at least the minimum time, then reports the
+ *  last batch as ns/op and operator new calls/op.
+ */
+namespace cdt_benchmarks {
+
+   using body = std::function<void(uint64_t iterations)>;
+
+   struct benchmark {
+      std::string name;
+      body        run;
+   };
+
+   std::vector<benchmark>& registry();
+
+   struct registrar {
+      registrar(const char* name, body run) { registry().push_back({ name, std::move(run) }); }
+   };
+
+   /// Number of calls to the global operator new since the start of the process
+   uint64_t allocation_count();
+
+   /// Deterministic xorshift generator so every build measures the same inputs
+   struct rng {
+      uint64_t state = 0x9e3779b97f4a7c15;
+
+      uint64_t operator()() {
+         state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         return state;
+      }
+   };
+
+   using cdt_timing::keep;
+
+} // namespace cdt_benchmarks
+
+#define CDT_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define CDT_BENCHMARK_CONCAT(a, b) CDT_BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ *  Defines and registers a benchmark: `CDT_BENCHMARK("group/name") { for (...; iterations; ...) }`
+ */
+#define CDT_BENCHMARK(NAME)                                                                                  \
+   static void CDT_BENCHMARK_CONCAT(cdt_benchmark_, __LINE__)(uint64_t iterations);                          \
+   static ::cdt_benchmarks::registrar CDT_BENCHMARK_CONCAT(cdt_benchmark_registrar_, __LINE__)(              \
+         NAME, CDT_BENCHMARK_CONCAT(cdt_benchmark_, __LINE__));                                              \
+   static void CDT_BENCHMARK_CONCAT(cdt_benchmark_, __LINE__)([[maybe_unused]] uint64_t iterations)
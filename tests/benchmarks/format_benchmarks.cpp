@@ -0,0 +1,81 @@
+#include "benchmark.hpp"
+
+#include <eosio/asset.hpp>
+#include <eosio/name.hpp>
+
+using namespace cdt_benchmarks;
+using eosio::asset;
+using eosio::name;
+using eosio::symbol;
+
+namespace {
+   const std::vector<std::string>& name_strings() {
+      static const std::vector<std::string> names = { "eosio",       "eosio.token",  "alice",         "bob",
+                                                      "exchange.gm", "a",            "zzzzzzzzzzzzj", "user.1234",
+                                                      "hello.world", "eosio.system", "dapp.x",        "tester" };
+      return names;
+   }
+
+   const std::vector<name>& names() {
+      static const std::vector<name> result = [] {
+         std::vector<name> v;
+         for (const auto& s : name_strings())
+            v.emplace_back(s);
+         return v;
+      }();
+      return result;
+   }
+
+   const std::vector<asset>& assets() {
+      static const std::vector<asset> result = [] {
+         std::vector<asset> v;
+         rng                next;
+         for (int i = 0; i < 64; ++i)
+            v.emplace_back(int64_t(next() >> 2) * (i % 2 ? 1 : -1), symbol("TOK", i % 9));
+         return v;
+      }();
+      return result;
+   }
+} // namespace
+
+CDT_BENCHMARK("name/from_string") {
+   const auto& strings = name_strings();
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(name(strings[i % strings.size()]));
+}
+
+CDT_BENCHMARK("name/to_string") {
+   const auto& values = names();
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(values[i % values.size()].to_string());
+}
+
+CDT_BENCHMARK("name/write_name") {
+   const auto& values = names();
+   char        buffer[eosio::max_name_chars];
+   for (uint64_t i = 0; i < iterations; ++i) {
+      keep(eosio::write_name(buffer, values[i % values.size()]));
+      keep(buffer);
+   }
+}
+
+CDT_BENCHMARK("name/round_trip") {
+   const auto& values = names();
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(name(values[i % values.size()].to_string()));
+}
+
+CDT_BENCHMARK("asset/to_string") {
+   const auto& values = assets();
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(values[i % values.size()].to_string());
+}
+
+CDT_BENCHMARK("asset/write_asset") {
+   const auto& values = assets();
+   char        buffer[eosio::max_asset_chars];
+   for (uint64_t i = 0; i < iterations; ++i) {
+      keep(eosio::write_asset(buffer, values[i % values.size()]));
+      keep(buffer);
+   }
+}
@@ -0,0 +1,116 @@
+#include "benchmark.hpp"
+
+#include <eosio/tester.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace {
+   uint64_t allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+   ++allocations;
+   void* p = std::malloc(size ? size : 1);
+   eosio::check(p != nullptr, "out of memory");
+   return p;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace cdt_benchmarks {
+
+   std::vector<benchmark>& registry() {
+      static std::vector<benchmark> benchmarks;
+      return benchmarks;
+   }
+
+   uint64_t allocation_count() { return allocations; }
+
+} // namespace cdt_benchmarks
+
+namespace {
+   using namespace cdt_benchmarks;
+   using namespace cdt_timing;
+
+   struct result {
+      std::string name;
+      uint64_t    iterations         = 0;
+      double      ns_per_op          = 0;
+      double      allocations_per_op = 0;
+   };
+
+   result measure(const benchmark& b, uint64_t min_time_ns, uint64_t overhead_ns) {
+      uint64_t allocs = 0;
+      auto     t      = time_batches(
+            [&](uint64_t iterations) {
+               allocs = allocation_count();
+               b.run(iterations);
+               allocs = allocation_count() - allocs;
+            },
+            min_time_ns, overhead_ns);
+      return { b.name, t.iterations, double(t.elapsed_ns) / t.iterations, double(allocs) / t.iterations };
+   }
+
+   std::string to_json(const std::vector<result>& results, uint64_t min_time_ms) {
+#ifdef __wasm__
+      std::string json = "{\"target\":\"wasm\"";
+#else
+      std::string json = "{\"target\":\"native\"";
+#endif
+      json += fmt::format(",\"min_time_ms\":{},\"benchmarks\":[", min_time_ms);
+      for (size_t i = 0; i < results.size(); ++i) {
+         const auto& r = results[i];
+         json += fmt::format("{}\n  {{\"name\":\"{}\",\"iterations\":{},\"ns_per_op\":{:.3f},\"allocations_per_op\":{:.3f}}}",
+                             i ? "," : "", r.name, r.iterations, r.ns_per_op, r.allocations_per_op);
+      }
+      json += "\n]}\n";
+      return json;
+   }
+} // namespace
+
+// usage: cdt_benchmarks [--filter <substring>] [--min-time-ms <n>] [--out <file>]
+int main(int argc, char** argv) {
+   std::string_view filter;
+   std::string_view out;
+   uint64_t         min_time_ms = default_min_time_ms;
+   for (int i = 1; i < argc; i += 2) {
+      eosio::check(i + 1 < argc, "missing value for " + std::string(argv[i]));
+      if (strcmp(argv[i], "--filter") == 0)
+         filter = argv[i + 1];
+      else if (strcmp(argv[i], "--min-time-ms") == 0)
+         min_time_ms = std::strtoull(argv[i + 1], nullptr, 10);
+      else if (strcmp(argv[i], "--out") == 0)
+         out = argv[i + 1];
+      else
+         eosio::check(false, "unknown argument " + std::string(argv[i]));
+   }
+
+   [[maybe_unused]] clock_session host_clock;
+
+   uint64_t            overhead = clock_overhead_ns();
+   std::vector<result> results;
+   for (const auto& b : registry()) {
+      if (filter.empty() || b.name.find(filter) != std::string::npos)
+         results.push_back(measure(b, min_time_ms * 1'000'000, overhead));
+   }
+
+   std::string json = to_json(results, min_time_ms);
+   if (out.empty()) {
+      std::cout << json;
+   } else {
+      using namespace eosio::internal_use_do_not_use;
+      int32_t file = open_file(out.data(), out.size(), "w", 1);
+      eosio::check(file >= 0, "cannot open " + std::string(out));
+      write_file(file, json.data(), json.size());
+      close_file(file);
+   }
+   return 0;
+}
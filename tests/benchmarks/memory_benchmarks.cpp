@@ -0,0 +1,51 @@
+#include "benchmark.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace cdt_benchmarks;
+
+// Allocations go through the global operator new so they are counted; in the wasm build that is
+// backed by the eosiolib malloc.
+
+CDT_BENCHMARK("allocator/fixed_size_churn") {
+   for (uint64_t i = 0; i < iterations; ++i) {
+      char* p = new char[64];
+      keep(p);
+      delete[] p;
+   }
+}
+
+CDT_BENCHMARK("allocator/mixed_size_churn") {
+   // keeps 64 blocks of 8 bytes to 4 KiB alive and replaces one of them per operation
+   std::array<char*, 64> live{};
+   rng                   next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      auto& slot = live[i % live.size()];
+      delete[] slot;
+      slot = new char[8 + next() % 4089];
+      keep(slot);
+   }
+   for (char* p : live)
+      delete[] p;
+}
+
+CDT_BENCHMARK("allocator/vector_growth") {
+   for (uint64_t i = 0; i < iterations; ++i) {
+      std::vector<uint64_t> v;
+      for (uint64_t j = 0; j < 256; ++j)
+         v.push_back(j);
+      keep(v);
+   }
+}
+
+CDT_BENCHMARK("allocator/string_append") {
+   for (uint64_t i = 0; i < iterations; ++i) {
+      std::string s;
+      for (int j = 0; j < 32; ++j)
+         s += "0123456789";
+      keep(s);
+   }
+}
@@ -0,0 +1,142 @@
+#include "benchmark.hpp"
+
+#include <eosio/asset.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/varint.hpp>
+
+#include <optional>
+
+using namespace cdt_benchmarks;
+using eosio::asset;
+using eosio::datastream;
+using eosio::name;
+using eosio::signed_int;
+using eosio::symbol;
+using eosio::unsigned_int;
+
+namespace {
+   // the arguments of eosio.token::transfer, the most common action payload
+   struct transfer_args {
+      name        from;
+      name        to;
+      asset       quantity;
+      std::string memo;
+
+      EOSLIB_SERIALIZE(transfer_args, (from)(to)(quantity)(memo))
+   };
+
+   // a table row with nested containers
+   struct account_state {
+      uint64_t                   id;
+      name                       owner;
+      std::vector<asset>         balances;
+      std::vector<uint64_t>      permissions;
+      std::optional<std::string> note;
+
+      EOSLIB_SERIALIZE(account_state, (id)(owner)(balances)(permissions)(note))
+   };
+
+   const transfer_args& sample_transfer() {
+      static const transfer_args t{ "alice"_n, "bob"_n, asset(12345, symbol("TOK", 4)),
+                                    "payment for invoice 2024-0193" };
+      return t;
+   }
+
+   const account_state& sample_account() {
+      static const account_state a = [] {
+         account_state a{ 42, "carol"_n, {}, {}, std::string("vip") };
+         for (int64_t i = 0; i < 8; ++i)
+            a.balances.push_back(asset(i * 1000, symbol("TOK", 4)));
+         for (uint64_t i = 0; i < 16; ++i)
+            a.permissions.push_back(i * 0x0101010101010101);
+         return a;
+      }();
+      return a;
+   }
+
+   // values spread over every varint length
+   const std::vector<uint32_t>& varint_values() {
+      static const std::vector<uint32_t> values = [] {
+         std::vector<uint32_t> v(1024);
+         rng                   next;
+         for (auto& x : v)
+            x = uint32_t(next()) >> (next() % 32);
+         return v;
+      }();
+      return values;
+   }
+} // namespace
+
+CDT_BENCHMARK("datastream/pack_transfer") {
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(eosio::pack(sample_transfer()));
+}
+
+CDT_BENCHMARK("datastream/pack_transfer_fixed_buffer") {
+   char buffer[128];
+   for (uint64_t i = 0; i < iterations; ++i) {
+      datastream<char*> ds(buffer, sizeof(buffer));
+      ds << sample_transfer();
+      keep(buffer);
+   }
+}
+
+CDT_BENCHMARK("datastream/unpack_transfer") {
+   auto bytes = eosio::pack(sample_transfer());
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(eosio::unpack<transfer_args>(bytes));
+}
+
+CDT_BENCHMARK("datastream/pack_size_account_state") {
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(eosio::pack_size(sample_account()));
+}
+
+CDT_BENCHMARK("datastream/pack_account_state") {
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(eosio::pack(sample_account()));
+}
+
+CDT_BENCHMARK("datastream/unpack_account_state") {
+   auto bytes = eosio::pack(sample_account());
+   for (uint64_t i = 0; i < iterations; ++i)
+      keep(eosio::unpack<account_state>(bytes));
+}
+
+CDT_BENCHMARK("varint/pack_unsigned_int") {
+   const auto& values = varint_values();
+   char        buffer[5];
+   for (uint64_t i = 0; i < iterations; ++i) {
+      datastream<char*> ds(buffer, sizeof(buffer));
+      ds << unsigned_int(values[i % values.size()]);
+      keep(buffer);
+   }
+}
+
+CDT_BENCHMARK("varint/pack_signed_int") {
+   const auto& values = varint_values();
+   char        buffer[5];
+   for (uint64_t i = 0; i < iterations; ++i) {
+      datastream<char*> ds(buffer, sizeof(buffer));
+      ds << signed_int(int32_t(values[i % values.size()]) >> 1);
+      keep(buffer);
+   }
+}
+
+CDT_BENCHMARK("varint/unpack_unsigned_int") {
+   const auto&               values = varint_values();
+   std::vector<unsigned_int> varints(values.begin(), values.end());
+   auto                      bytes = eosio::pack(varints); // length prefix, then the varints
+   datastream<const char*>   ds(bytes.data(), bytes.size());
+   unsigned_int              count;
+   ds >> count;
+   const size_t start = ds.tellp();
+   for (uint64_t i = 0; i < iterations; ++i) {
+      if (i % count.value == 0)
+         ds.seekp(start);
+      unsigned_int v;
+      ds >> v;
+      keep(v);
+   }
+}
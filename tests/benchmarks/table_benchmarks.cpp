@@ -0,0 +1,163 @@
+#include "benchmark.hpp"
+
+#include <eosio/chaindb.hpp>
+#include <eosio/map.hpp>
+#include <eosio/multi_index.hpp>
+
+using namespace cdt_benchmarks;
+using eosio::name;
+namespace chaindb = eosio::chaindb;
+
+// Tables live in the eosio::chaindb stand-in database. Every operation runs as its own action
+// through chaindb::apply, so it pays for the undo session and starts with a cold multi_index object
+// cache and a fresh set of iterators, as it would on chain.
+
+namespace {
+   constexpr name     self       = "benchmark"_n;
+   constexpr uint64_t table_rows = 10000;
+   constexpr uint64_t scan_rows  = 100;
+
+   struct account_row {
+      uint64_t id;
+      uint64_t owner;
+      int64_t  balance;
+
+      uint64_t primary_key() const { return id; }
+      uint64_t by_owner() const { return owner; }
+
+      EOSLIB_SERIALIZE(account_row, (id)(owner)(balance))
+   };
+
+   using accounts_table = eosio::multi_index<"accounts"_n, account_row,
+      eosio::indexed_by<"byowner"_n, eosio::const_mem_fun<account_row, uint64_t, &account_row::by_owner>>>;
+   using balances_map = eosio::kv::map<"balances"_n, uint64_t, int64_t>;
+
+   uint64_t owner_of(uint64_t id) { return id * 0x9e3779b97f4a7c15; }
+
+   // `table_rows` rows in both tables, populated once per process
+   void fixture() {
+      static bool populated = false;
+      chaindb::set_receiver(self);
+      if (populated)
+         return;
+      chaindb::reset();
+      chaindb::apply(self, [] {
+         accounts_table accounts(self, self.value);
+         balances_map   balances(self);
+         for (uint64_t id = 0; id < table_rows; ++id) {
+            accounts.emplace(self, [&](auto& a) {
+               a.id      = id;
+               a.owner   = owner_of(id);
+               a.balance = id;
+            });
+            balances[id] = int64_t(id);
+         }
+      });
+      populated = true;
+   }
+} // namespace
+
+CDT_BENCHMARK("multi_index/emplace_erase") {
+   fixture();
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         accounts_table accounts(self, self.value);
+         auto           it = accounts.emplace(self, [&](auto& a) {
+            a.id      = table_rows + i;
+            a.owner   = owner_of(table_rows + i);
+            a.balance = 0;
+         });
+         accounts.erase(it);
+      });
+   }
+}
+
+CDT_BENCHMARK("multi_index/find") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         accounts_table accounts(self, self.value);
+         keep(accounts.get(next() % table_rows).balance);
+      });
+   }
+}
+
+CDT_BENCHMARK("multi_index/modify") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         accounts_table accounts(self, self.value);
+         accounts.modify(accounts.find(next() % table_rows), self, [](auto& a) { ++a.balance; });
+      });
+   }
+}
+
+// one operation scans `scan_rows` consecutive rows
+CDT_BENCHMARK("multi_index/scan_100") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         accounts_table accounts(self, self.value);
+         int64_t        total = 0;
+         uint64_t       n     = 0;
+         for (auto it = accounts.lower_bound(next() % table_rows); it != accounts.end() && n < scan_rows; ++it, ++n)
+            total += it->balance;
+         keep(total);
+      });
+   }
+}
+
+CDT_BENCHMARK("multi_index/secondary_lower_bound") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         accounts_table accounts(self, self.value);
+         auto           by_owner = accounts.get_index<"byowner"_n>();
+         auto           it       = by_owner.lower_bound(next());
+         if (it != by_owner.end())
+            keep(it->id);
+      });
+   }
+}
+
+CDT_BENCHMARK("kv_map/set") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         balances_map balances(self);
+         balances[next() % table_rows] = int64_t(i);
+      });
+   }
+}
+
+CDT_BENCHMARK("kv_map/find") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         balances_map balances(self);
+         keep(balances.find(next() % table_rows)->second());
+      });
+   }
+}
+
+// one operation scans `scan_rows` consecutive rows
+CDT_BENCHMARK("kv_map/scan_100") {
+   fixture();
+   rng next;
+   for (uint64_t i = 0; i < iterations; ++i) {
+      chaindb::apply(self, [&] {
+         balances_map balances(self);
+         int64_t      total = 0;
+         uint64_t     n     = 0;
+         for (auto it = balances.lower_bound(next() % table_rows); it != balances.end() && n < scan_rows; ++it, ++n)
+            total += it->second();
+         keep(total);
+      });
+   }
+}
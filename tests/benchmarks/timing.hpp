@@ -0,0 +1,104 @@
+#pragma once
+
+#include <eosio/check.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#ifdef __wasm__
+#include <eosio/tester.hpp>
+#else
+#include <chrono>
+#endif
+
+/**
+ *  Clock and batch calibration shared by cdt_benchmarks and cdt_differential.
+ *
+ *  A batch runs the measured operation a given number of times. `time_batches` grows the count
+ *  until one batch takes at least the minimum time, after subtracting the cost of reading the clock.
+ */
+namespace cdt_timing {
+
+#ifdef __wasm__
+   // The wasm tester has no clock intrinsic, so the host clock is sampled through a shell command.
+   // Each sample costs about a millisecond; that overhead is calibrated away and the default
+   // minimum batch time is raised so it stays a small fraction of every measurement.
+   constexpr uint64_t default_min_time_ms = 1000;
+
+   inline constexpr const char* clock_file = "cdt_timing.clock";
+
+   inline uint64_t now_ns() {
+      eosio::execute(std::string("date +%s%N > ") + clock_file);
+      auto        data = eosio::read_whole_file(clock_file);
+      std::string text(data.begin(), data.end());
+      while (!text.empty() && (text.back() == '\n' || text.back() == '\r'))
+         text.pop_back();
+      bool valid = !text.empty();
+      uint64_t result = 0;
+      for (char c : text) {
+         valid = valid && c >= '0' && c <= '9';
+         result = result * 10 + (c - '0');
+      }
+      // `date` without %N support (BSD, macOS) prints the N literally
+      eosio::check(valid, "cannot read the host clock: `date +%s%N` printed \"" + text +
+                          "\", a date with nanosecond support such as GNU coreutils is needed");
+      return result;
+   }
+
+   /// Removes the file the host clock is read through when the run ends
+   struct clock_session {
+      ~clock_session() { eosio::execute(std::string("rm -f ") + clock_file); }
+   };
+#else
+   constexpr uint64_t default_min_time_ms = 200;
+
+   inline uint64_t now_ns() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+   }
+
+   struct clock_session {};
+#endif
+
+   /// Lowest observed cost of reading the clock twice
+   inline uint64_t clock_overhead_ns() {
+      uint64_t best = UINT64_MAX;
+      for (int i = 0; i < 5; ++i) {
+         uint64_t start = now_ns();
+         best           = std::min(best, now_ns() - start);
+      }
+      return best;
+   }
+
+   struct batch {
+      uint64_t iterations = 0;
+      uint64_t elapsed_ns = 0;
+   };
+
+   /// Calls `run(iterations)` with a growing count until a batch takes `min_time_ns`, and returns that batch
+   template <typename F>
+   batch time_batches(F&& run, uint64_t min_time_ns, uint64_t overhead_ns) {
+      constexpr uint64_t max_iterations = 1'000'000'000;
+      uint64_t           iterations     = 1;
+      for (;;) {
+         uint64_t start = now_ns();
+         run(iterations);
+         uint64_t elapsed = now_ns() - start;
+         elapsed          = elapsed > overhead_ns ? elapsed - overhead_ns : 0;
+         if (elapsed >= min_time_ns || iterations >= max_iterations)
+            return { iterations, elapsed };
+         double scale = elapsed ? 1.4 * min_time_ns / elapsed : 100;
+         iterations   = std::max(iterations + 1, uint64_t(iterations * std::min(scale, 100.0)));
+         iterations   = std::min(iterations, max_iterations);
+      }
+   }
+
+   /// Keeps the computation of `value` from being optimized away
+   template <typename T>
+   inline void keep(const T& value) {
+      asm volatile("" : : "r"(&value) : "memory");
+   }
+
+} // namespace cdt_timing
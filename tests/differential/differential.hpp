@@ -0,0 +1,52 @@
+#pragma once
+
+#include <eosio/name.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ *  Action set shared by the native and wasm builds of cdt_differential.
+ *
+ *  Each action runs as an action of its receiver through `eosio::chaindb::apply`, on one database
+ *  that keeps the writes of the actions before it. Actions run grouped by the part of their name
+ *  before the '/', groups in alphabetical order, and in order of definition within a group, so both
+ *  builds run them in the same order. The body returns the packed value the action returns.
+ *
+ *  For every action the runner records the return value and the digest of the database after it,
+ *  and measures its cost from the state it started from, undoing the writes of every measured run.
+ *  In the native build, an action that throws is rolled back and recorded with the exception's
+ *  message instead; wasm is built without exceptions, so there a failing action aborts the run.
+ */
+namespace cdt_differential {
+
+   using body = std::function<std::vector<char>()>;
+
+   struct action {
+      std::string name;
+      eosio::name receiver;
+      body        run;
+   };
+
+   std::vector<action>& registry();
+
+   struct registrar {
+      registrar(const char* name, eosio::name receiver, body run) {
+         registry().push_back({ name, receiver, std::move(run) });
+      }
+   };
+
+} // namespace cdt_differential
+
+#define CDT_DIFFERENTIAL_CONCAT_IMPL(a, b) a##b
+#define CDT_DIFFERENTIAL_CONCAT(a, b) CDT_DIFFERENTIAL_CONCAT_IMPL(a, b)
+
+/**
+ *  Defines and registers an action: `CDT_DIFFERENTIAL_ACTION("group/name", "receiver"_n) { ...; return eosio::pack(result); }`
+ */
+#define CDT_DIFFERENTIAL_ACTION(NAME, RECEIVER)                                                              \
+   static std::vector<char> CDT_DIFFERENTIAL_CONCAT(cdt_differential_, __LINE__)();                          \
+   static ::cdt_differential::registrar CDT_DIFFERENTIAL_CONCAT(cdt_differential_registrar_, __LINE__)(      \
+         NAME, RECEIVER, CDT_DIFFERENTIAL_CONCAT(cdt_differential_, __LINE__));                              \
+   static std::vector<char> CDT_DIFFERENTIAL_CONCAT(cdt_differential_, __LINE__)()
@@ -0,0 +1,261 @@
+#include "differential.hpp"
+#include "../benchmarks/timing.hpp"
+
+#include <eosio/chaindb.hpp>
+#include <eosio/system.hpp>
+#include <eosio/tester.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <string_view>
+
+namespace cdt_differential {
+
+   std::vector<action>& registry() {
+      static std::vector<action> actions;
+      return actions;
+   }
+
+   struct action_result {
+      std::string name;
+      std::string receiver;
+      std::string return_value; ///< hex
+      std::string error;        ///< what the action threw, empty if it returned
+      uint64_t    state_digest  = 0;
+      uint64_t    iterations    = 0; ///< 0 if the action was not measured
+      uint64_t    ns_per_action = 0;
+   };
+   EOSIO_REFLECT(action_result, name, receiver, return_value, error, state_digest, iterations, ns_per_action);
+
+   struct run_result {
+      std::string                target;
+      uint64_t                   min_time_ms = 0;
+      std::vector<action_result> actions;
+   };
+   EOSIO_REFLECT(run_result, target, min_time_ms, actions);
+
+} // namespace cdt_differential
+
+namespace {
+   using namespace cdt_differential;
+   namespace chaindb = eosio::chaindb;
+
+   using namespace cdt_timing;
+
+#ifdef __wasm__
+   constexpr const char* target_name = "wasm";
+#else
+   constexpr const char* target_name = "native";
+#endif
+
+   std::string to_hex(const std::vector<char>& bytes) {
+      static constexpr char digits[] = "0123456789abcdef";
+      std::string           result;
+      for (unsigned char c : bytes) {
+         result += digits[c >> 4];
+         result += digits[c & 15];
+      }
+      return result;
+   }
+
+   std::string_view group_of(std::string_view name) { return name.substr(0, name.find('/')); }
+
+   // registration order across translation units is unspecified; groups fix the order of the run
+   std::vector<const action*> ordered_actions() {
+      std::vector<const action*> result;
+      for (const auto& a : registry())
+         result.push_back(&a);
+      std::stable_sort(result.begin(), result.end(),
+                       [](const action* a, const action* b) { return group_of(a->name) < group_of(b->name); });
+      return result;
+   }
+
+   // runs `a` from the current state until a batch takes `min_time_ns`; the writes of every run are undone
+   void measure(const action& a, action_result& r, uint64_t min_time_ns, uint64_t overhead_ns) {
+      auto t = time_batches(
+            [&](uint64_t iterations) {
+               for (uint64_t i = 0; i < iterations; ++i) {
+                  chaindb::start_session();
+#ifdef __wasm__
+                  chaindb::apply(a.receiver, [&] { keep(a.run()); });
+#else
+                  try {
+                     chaindb::apply(a.receiver, [&] { keep(a.run()); });
+                  } catch (...) {
+                     chaindb::undo_session();
+                     throw;
+                  }
+#endif
+                  chaindb::undo_session();
+               }
+            },
+            min_time_ns, overhead_ns);
+      r.iterations    = t.iterations;
+      r.ns_per_action = t.elapsed_ns / t.iterations;
+   }
+
+   run_result run_actions(std::string_view filter, uint64_t min_time_ms) {
+      run_result result{ target_name, min_time_ms };
+      uint64_t   overhead = clock_overhead_ns();
+      chaindb::reset();
+      for (const action* a : ordered_actions()) {
+         action_result r{ a->name, a->receiver.to_string() };
+         auto          run = [&] {
+            if (filter.empty() || a->name.find(filter) != std::string::npos)
+               measure(*a, r, min_time_ms * 1'000'000, overhead);
+            std::vector<char> return_value;
+            chaindb::apply(a->receiver, [&] { return_value = a->run(); });
+            r.return_value = to_hex(return_value);
+         };
+#ifdef __wasm__
+         // wasm has no exceptions: a failing action aborts the run
+         run();
+#else
+         // an action that fails is rolled back and recorded with its error, so the run goes on
+         try {
+            run();
+         } catch (const std::exception& e) {
+            r.iterations = 0;
+            r.error      = e.what();
+         }
+#endif
+         r.state_digest = chaindb::state_digest();
+         result.actions.push_back(std::move(r));
+      }
+      return result;
+   }
+
+   void write_whole_file(std::string_view filename, const std::vector<char>& contents) {
+      using namespace eosio::internal_use_do_not_use;
+      int32_t file = open_file(filename.data(), filename.size(), "w", 1);
+      eosio::check(file >= 0, "cannot open " + std::string(filename));
+      write_file(file, contents.data(), contents.size());
+      close_file(file);
+   }
+
+   run_result read_run(std::string_view filename) {
+      auto data = eosio::read_whole_file(filename);
+      data.push_back(0);
+      run_result               result;
+      eosio::json_token_stream stream(data.data());
+      eosio::from_json(result, stream);
+      return result;
+   }
+
+   // Prints the outputs and relative cost of every action run by both `a` and `b`, and flags
+   // actions whose cost ratio is more than `spread` times away from the median ratio: for those,
+   // native timings are a poor proxy for the cost on chain. Returns 1 if any output differs or
+   // an action ran in only one of the builds.
+   int compare(const run_result& a, const run_result& b, double spread) {
+      const run_result& wasm   = b.target == "wasm" ? b : a;
+      const run_result& native = &wasm == &a ? b : a;
+
+      std::map<std::string, const action_result*> native_actions;
+      for (const auto& r : native.actions)
+         native_actions[r.name] = &r;
+      std::map<std::string, const action_result*> wasm_actions;
+      for (const auto& r : wasm.actions)
+         wasm_actions[r.name] = &r;
+
+      int                                         result = 0;
+      std::vector<std::pair<std::string, double>> ratios;
+      std::cout << fmt::format("{:<36} {:<10} {:>16} {:>16} {:>12}\n", "action", "output",
+                               wasm.target + " ns", native.target + " ns", "ratio");
+      for (const auto& w : wasm.actions) {
+         auto it = native_actions.find(w.name);
+         if (it == native_actions.end()) {
+            std::cout << fmt::format("{:<36} missing from the {} run\n", w.name, native.target);
+            result = 1;
+            continue;
+         }
+         const auto& n      = *it->second;
+         std::string output = "same";
+         if (w.error != n.error)
+            output = "error";
+         else if (w.return_value != n.return_value)
+            output = "returns";
+         else if (w.state_digest != n.state_digest)
+            output = "state";
+         if (output != "same")
+            result = 1;
+         std::string ratio;
+         if (w.iterations && n.iterations && n.ns_per_action) {
+            double r = double(w.ns_per_action) / n.ns_per_action;
+            ratios.emplace_back(w.name, r);
+            ratio = fmt::format("{:.2f}", r);
+         }
+         std::cout << fmt::format("{:<36} {:<10} {:>16} {:>16} {:>12}\n", w.name, output,
+                                  w.iterations ? std::to_string(w.ns_per_action) : "-",
+                                  n.iterations ? std::to_string(n.ns_per_action) : "-", ratio);
+         if (output == "error") {
+            std::cout << fmt::format("  {}: {}\n", wasm.target, w.error.empty() ? "returned" : w.error);
+            std::cout << fmt::format("  {}: {}\n", native.target, n.error.empty() ? "returned" : n.error);
+         }
+      }
+      for (const auto& n : native.actions) {
+         if (!wasm_actions.count(n.name)) {
+            std::cout << fmt::format("{:<36} missing from the {} run\n", n.name, wasm.target);
+            result = 1;
+         }
+      }
+
+      if (!ratios.empty()) {
+         std::vector<double> sorted;
+         for (const auto& [name, r] : ratios)
+            sorted.push_back(r);
+         std::sort(sorted.begin(), sorted.end());
+         double median = sorted[sorted.size() / 2];
+         std::cout << fmt::format("\nmedian {}/{} cost ratio: {:.2f}\n", wasm.target, native.target, median);
+         for (const auto& [name, r] : ratios)
+            if (r > median * spread || r * spread < median)
+               std::cout << fmt::format("  {}: ratio {:.2f}, native cost is a poor proxy\n", name, r);
+      }
+      return result;
+   }
+} // namespace
+
+// usage: cdt_differential [--filter <substring>] [--min-time-ms <n>] [--out <file>] [--compare <file>] [--spread <x>]
+int main(int argc, char** argv) {
+   std::string_view filter;
+   std::string_view out;
+   std::string_view other;
+   uint64_t         min_time_ms = default_min_time_ms;
+   double           spread      = 4;
+   for (int i = 1; i < argc; i += 2) {
+      eosio::check(i + 1 < argc, "missing value for " + std::string(argv[i]));
+      if (strcmp(argv[i], "--filter") == 0)
+         filter = argv[i + 1];
+      else if (strcmp(argv[i], "--min-time-ms") == 0)
+         min_time_ms = std::strtoull(argv[i + 1], nullptr, 10);
+      else if (strcmp(argv[i], "--out") == 0)
+         out = argv[i + 1];
+      else if (strcmp(argv[i], "--compare") == 0)
+         other = argv[i + 1];
+      else if (strcmp(argv[i], "--spread") == 0)
+         spread = std::strtod(argv[i + 1], nullptr);
+      else
+         eosio::check(false, "unknown argument " + std::string(argv[i]));
+   }
+
+   // the module runs every action many times in one linear memory
+   eosio::malloc_enable_free();
+
+   [[maybe_unused]] clock_session host_clock;
+
+   auto                 result = run_actions(filter, min_time_ms);
+   std::vector<char>    json;
+   eosio::vector_stream stream(json);
+   eosio::to_json(result, stream);
+   json.push_back('\n');
+   if (out.empty() && other.empty())
+      std::cout << std::string_view(json.data(), json.size());
+   if (!out.empty())
+      write_whole_file(out, json);
+   if (!other.empty())
+      return compare(result, read_run(other), spread);
+   return 0;
+}
@@ -0,0 +1,63 @@
+#include "differential.hpp"
+
+#include <eosio/datastream.hpp>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using eosio::name;
+
+// Allocation patterns whose cost depends on the allocator: the wasm build allocates from the
+// contract heap allocator and grows its linear memory page by page, the native build uses the
+// process heap.
+
+namespace {
+   constexpr name self = "memory"_n;
+
+   uint64_t mix(uint64_t x) {
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccd;
+      x ^= x >> 33;
+      return x;
+   }
+} // namespace
+
+CDT_DIFFERENTIAL_ACTION("memory/vector_growth", self) {
+   std::vector<uint64_t> v;
+   for (uint64_t i = 0; i < 100000; ++i)
+      v.push_back(mix(i));
+   uint64_t sum = 0;
+   for (auto x : v)
+      sum += x;
+   return eosio::pack(sum);
+}
+
+CDT_DIFFERENTIAL_ACTION("memory/small_objects", self) {
+   std::map<uint64_t, std::string> m;
+   for (uint64_t i = 0; i < 5000; ++i)
+      m.emplace(mix(i), std::string(16 + i % 48, char('a' + i % 26)));
+   uint64_t sum = 0;
+   for (const auto& [k, v] : m)
+      sum = mix(sum ^ k) + v.size();
+   return eosio::pack(sum);
+}
+
+CDT_DIFFERENTIAL_ACTION("memory/large_block", self) {
+   std::vector<char> block(4 << 20);
+   for (size_t i = 0; i < block.size(); i += 4096)
+      block[i] = char(i >> 12);
+   uint64_t sum = 0;
+   for (size_t i = 0; i < block.size(); i += 4096)
+      sum += uint8_t(block[i]);
+   return eosio::pack(sum);
+}
+
+CDT_DIFFERENTIAL_ACTION("memory/sort", self) {
+   std::vector<uint64_t> v(50000);
+   for (uint64_t i = 0; i < v.size(); ++i)
+      v[i] = mix(i);
+   std::sort(v.begin(), v.end());
+   return eosio::pack(std::vector<uint64_t>{ v.front(), v[v.size() / 2], v.back() });
+}
@@ -0,0 +1,99 @@
+#include "differential.hpp"
+
+#include <eosio/map.hpp>
+#include <eosio/multi_index.hpp>
+
+using eosio::name;
+
+// multi_index and kv::map read rows of up to 512 bytes into a stack buffer (alloca) and larger rows
+// into the heap, so each operation is run with rows on both sides of that threshold.
+
+namespace {
+   constexpr name     self        = "rows"_n;
+   constexpr uint64_t small_first = 0;
+   constexpr uint64_t large_first = 1000;
+   constexpr uint64_t row_count   = 100;
+   constexpr size_t   small_size  = 64;
+   constexpr size_t   large_size  = 2048;
+
+   struct blob_row {
+      uint64_t          id;
+      std::vector<char> data;
+
+      uint64_t primary_key() const { return id; }
+
+      EOSLIB_SERIALIZE(blob_row, (id)(data))
+   };
+
+   using blobs_table = eosio::multi_index<"blobs"_n, blob_row>;
+   using blobs_map   = eosio::kv::map<"blobs"_n, uint64_t, std::vector<char>>;
+
+   std::vector<char> payload(uint64_t id, size_t size) {
+      std::vector<char> data(size);
+      for (size_t i = 0; i < size; ++i)
+         data[i] = char(id * 31 + i);
+      return data;
+   }
+
+   void emplace_rows(uint64_t first, size_t size) {
+      blobs_table blobs(self, self.value);
+      for (uint64_t id = first; id < first + row_count; ++id)
+         blobs.emplace(self, [&](auto& b) {
+            b.id   = id;
+            b.data = payload(id, size);
+         });
+   }
+
+   // a fresh table object per action, so every row is read from the database
+   uint64_t sum_rows(uint64_t first) {
+      blobs_table blobs(self, self.value);
+      uint64_t    sum = 0;
+      for (auto it = blobs.lower_bound(first); it != blobs.end() && it->id < first + row_count; ++it)
+         for (char c : it->data)
+            sum += uint8_t(c);
+      return sum;
+   }
+
+   void set_values(uint64_t first, size_t size) {
+      blobs_map blobs(self);
+      for (uint64_t id = first; id < first + row_count; ++id)
+         blobs[id] = payload(id, size);
+   }
+
+   uint64_t sum_values(uint64_t first) {
+      blobs_map blobs(self);
+      uint64_t  sum = 0;
+      for (uint64_t id = first; id < first + row_count; ++id)
+         for (char c : blobs.find(id)->second())
+            sum += uint8_t(c);
+      return sum;
+   }
+} // namespace
+
+CDT_DIFFERENTIAL_ACTION("rows/emplace_small", self) {
+   emplace_rows(small_first, small_size);
+   return {};
+}
+
+CDT_DIFFERENTIAL_ACTION("rows/emplace_large", self) {
+   emplace_rows(large_first, large_size);
+   return {};
+}
+
+CDT_DIFFERENTIAL_ACTION("rows/read_small", self) { return eosio::pack(sum_rows(small_first)); }
+
+CDT_DIFFERENTIAL_ACTION("rows/read_large", self) { return eosio::pack(sum_rows(large_first)); }
+
+CDT_DIFFERENTIAL_ACTION("rows/kv_set_small", self) {
+   set_values(small_first, small_size);
+   return {};
+}
+
+CDT_DIFFERENTIAL_ACTION("rows/kv_set_large", self) {
+   set_values(large_first, large_size);
+   return {};
+}
+
+CDT_DIFFERENTIAL_ACTION("rows/kv_read_small", self) { return eosio::pack(sum_values(small_first)); }
+
+CDT_DIFFERENTIAL_ACTION("rows/kv_read_large", self) { return eosio::pack(sum_values(large_first)); }
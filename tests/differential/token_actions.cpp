@@ -0,0 +1,129 @@
+#include "differential.hpp"
+
+#include <eosio/asset.hpp>
+#include <eosio/contract.hpp>
+#include <eosio/multi_index.hpp>
+
+using eosio::asset;
+using eosio::name;
+using eosio::symbol;
+
+namespace {
+   constexpr name self = "token"_n;
+   const symbol   sys("SYS", 4);
+
+   // eosio.token without authorization checks and notifications, which need a chain
+   class token : public eosio::contract {
+    public:
+      token() : contract(self, self, eosio::datastream<const char*>(nullptr, 0)) {}
+
+      void create(name issuer, const asset& maximum_supply) {
+         auto sym = maximum_supply.symbol;
+         eosio::check(maximum_supply.is_valid(), "invalid supply");
+         eosio::check(maximum_supply.amount > 0, "max-supply must be positive");
+
+         stats statstable(get_self(), sym.code().raw());
+         eosio::check(statstable.find(sym.code().raw()) == statstable.end(), "token with symbol already exists");
+         statstable.emplace(get_self(), [&](auto& s) {
+            s.supply.symbol = maximum_supply.symbol;
+            s.max_supply    = maximum_supply;
+            s.issuer        = issuer;
+         });
+      }
+
+      void issue(name to, const asset& quantity, const std::string& memo) {
+         eosio::check(memo.size() <= 256, "memo has more than 256 bytes");
+         stats statstable(get_self(), quantity.symbol.code().raw());
+         const auto& st = statstable.get(quantity.symbol.code().raw(), "token with symbol does not exist");
+         eosio::check(quantity.is_valid() && quantity.amount > 0, "invalid quantity");
+         eosio::check(quantity.amount <= st.max_supply.amount - st.supply.amount, "quantity exceeds available supply");
+         statstable.modify(st, eosio::same_payer, [&](auto& s) { s.supply += quantity; });
+         add_balance(to, quantity, st.issuer);
+      }
+
+      void retire(name owner, const asset& quantity) {
+         stats statstable(get_self(), quantity.symbol.code().raw());
+         const auto& st = statstable.get(quantity.symbol.code().raw(), "token with symbol does not exist");
+         eosio::check(quantity.is_valid() && quantity.amount > 0, "invalid quantity");
+         statstable.modify(st, eosio::same_payer, [&](auto& s) { s.supply -= quantity; });
+         sub_balance(owner, quantity);
+      }
+
+      /// returns the balance of `to`
+      asset transfer(name from, name to, const asset& quantity, const std::string& memo) {
+         eosio::check(from != to, "cannot transfer to self");
+         eosio::check(memo.size() <= 256, "memo has more than 256 bytes");
+         eosio::check(quantity.is_valid() && quantity.amount > 0, "invalid quantity");
+         sub_balance(from, quantity);
+         return add_balance(to, quantity, from);
+      }
+
+    private:
+      struct account {
+         asset balance;
+
+         uint64_t primary_key() const { return balance.symbol.code().raw(); }
+
+         EOSLIB_SERIALIZE(account, (balance))
+      };
+
+      struct currency_stats {
+         asset supply;
+         asset max_supply;
+         name  issuer;
+
+         uint64_t primary_key() const { return supply.symbol.code().raw(); }
+
+         EOSLIB_SERIALIZE(currency_stats, (supply)(max_supply)(issuer))
+      };
+
+      using accounts = eosio::multi_index<"accounts"_n, account>;
+      using stats    = eosio::multi_index<"stat"_n, currency_stats>;
+
+      void sub_balance(name owner, const asset& value) {
+         accounts    from_acnts(get_self(), owner.value);
+         const auto& from = from_acnts.get(value.symbol.code().raw(), "no balance object found");
+         eosio::check(from.balance.amount >= value.amount, "overdrawn balance");
+         from_acnts.modify(from, owner, [&](auto& a) { a.balance -= value; });
+      }
+
+      asset add_balance(name owner, const asset& value, name ram_payer) {
+         accounts to_acnts(get_self(), owner.value);
+         auto     to = to_acnts.find(value.symbol.code().raw());
+         if (to == to_acnts.end()) {
+            to_acnts.emplace(ram_payer, [&](auto& a) { a.balance = value; });
+            return value;
+         }
+         to_acnts.modify(to, eosio::same_payer, [&](auto& a) { a.balance += value; });
+         return to->balance;
+      }
+   };
+} // namespace
+
+CDT_DIFFERENTIAL_ACTION("token/create", self) {
+   token().create("alice"_n, asset(1'000'000'000'0000, sys));
+   return {};
+}
+
+CDT_DIFFERENTIAL_ACTION("token/issue", self) {
+   token().issue("alice"_n, asset(1'000'000'0000, sys), "initial supply");
+   return {};
+}
+
+CDT_DIFFERENTIAL_ACTION("token/transfer", self) {
+   return eosio::pack(token().transfer("alice"_n, "bob"_n, asset(10'0000, sys), "payment for invoice 2024-0193"));
+}
+
+// opens 100 balances in one action
+CDT_DIFFERENTIAL_ACTION("token/airdrop", self) {
+   token t;
+   asset balance;
+   for (uint64_t i = 0; i < 100; ++i)
+      balance = t.transfer("alice"_n, name("user"_n.value + (i << 4)), asset(1'0000 + i, sys), "airdrop");
+   return eosio::pack(balance);
+}
+
+CDT_DIFFERENTIAL_ACTION("token/retire", self) {
+   token().retire("alice"_n, asset(1000'0000, sys));
+   return {};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ *  Decoder targets of cdt_fuzz_decoders.
+ *
+ *  A target unpacks one type from untrusted bytes with `eosio::unpack<T>`, as the dispatcher does with
+ *  action arguments. Rejecting an input through `eosio::check` is the expected outcome for most
+ *  inputs; any other exception, crash or sanitizer report is a bug. An accepted input must survive
+ *  a round trip: packing the value and unpacking it again must give the same bytes.
+ */
+namespace cdt_fuzz {
+
+   using bytes = std::vector<char>;
+
+   /// Thrown by the harness' `eosio_assert*` intrinsics: the decoder rejected the input
+   struct decode_error : std::runtime_error {
+      using std::runtime_error::runtime_error;
+   };
+
+   /// Deterministic xorshift generator so every run builds the same inputs
+   struct rng {
+      uint64_t state = 0x9e3779b97f4a7c15;
+
+      uint64_t operator()() {
+         state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         return state;
+      }
+   };
+
+   /**
+    *  Adversarial inputs that grow with `scale`. Some grow in size (more nesting, longer strings),
+    *  others keep their size and only claim more elements in a length prefix. The decode cost of
+    *  either must not grow faster than the input does.
+    */
+   struct family {
+      std::string                          name;
+      uint32_t                             min_scale;
+      uint32_t                             max_scale;
+      std::function<bytes(uint32_t scale)> make;
+   };
+
+   struct target {
+      std::string name;
+
+      /// Unpacks the input; false if the decoder rejected it
+      std::function<bool(const char* data, size_t size)> decode;
+
+      /// `decode`, then the round trip check; aborts when the round trip changes the encoding
+      std::function<bool(const char* data, size_t size)> check;
+
+      /// A valid encoding of a random value
+      std::function<bytes(rng& next)> sample;
+
+      std::vector<family> families;
+   };
+
+   /// All targets. The fuzzer entry point picks one with the first byte of its input.
+   const std::vector<target>& targets();
+
+   /// Keeps the decoded value from being optimized away
+   inline const volatile void* sink;
+
+} // namespace cdt_fuzz
@@ -0,0 +1,372 @@
+#include "fuzz.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+using namespace cdt_fuzz;
+
+// The intrinsics decoding reaches. Rejected inputs surface as decode_error, which the targets
+// catch; every other intrinsic stays undefined, so a decoder that starts calling one fails to link.
+extern "C" {
+
+void eosio_assert(uint32_t test, const char* msg) {
+   if (test == 0)
+      throw decode_error(msg);
+}
+
+void eosio_assert_message(uint32_t test, const char* msg, uint32_t len) {
+   if (test == 0)
+      throw decode_error({ msg, len });
+}
+
+void eosio_assert_code(uint32_t test, uint64_t code) {
+   if (test == 0)
+      throw decode_error("error code " + std::to_string(code));
+}
+
+// read by the default constructor of transaction
+uint64_t current_time() { return 0; }
+
+// libFuzzer entry point: the first byte picks the target, the rest is its input
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+   if (size == 0)
+      return 0;
+   const auto& all = targets();
+   all[data[0] % all.size()].check(reinterpret_cast<const char*>(data) + 1, size - 1);
+   return 0;
+}
+
+} // extern "C"
+
+#ifndef CDT_FUZZ_LIBFUZZER
+
+namespace {
+   constexpr size_t corpus_size = 256;
+
+   uint64_t now_ns() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+   }
+
+   /// ns per call of `f`: the best of three batches that each take at least `min_time_ns`
+   template <typename F>
+   double time_per_call(F&& f, uint64_t min_time_ns) {
+      double   best       = HUGE_VAL;
+      uint64_t iterations = 1;
+      for (int batches = 0; batches < 3;) {
+         uint64_t start = now_ns();
+         for (uint64_t i = 0; i < iterations; ++i)
+            f();
+         uint64_t elapsed = now_ns() - start;
+         if (elapsed < min_time_ns && iterations < (uint64_t(1) << 30)) {
+            double scale = elapsed ? 1.4 * min_time_ns / elapsed : 100;
+            iterations   = std::max(iterations + 1, uint64_t(iterations * std::min(scale, 100.0)));
+            continue;
+         }
+         best = std::min(best, double(elapsed) / iterations);
+         ++batches;
+      }
+      return best;
+   }
+
+   std::string format_double(double value, const char* format = "%.3f") {
+      char buffer[64];
+      std::snprintf(buffer, sizeof(buffer), format, value);
+      return buffer;
+   }
+
+   std::vector<bytes> valid_corpus(const target& t) {
+      rng                next;
+      std::vector<bytes> corpus;
+      for (size_t i = 0; i < corpus_size; ++i)
+         corpus.push_back(t.sample(next));
+      return corpus;
+   }
+
+   struct throughput {
+      std::string name;
+      size_t      inputs        = 0;
+      uint64_t    bytes         = 0;
+      double      ns_per_decode = 0;
+      double      mb_per_s      = 0;
+
+      double ns_per_byte() const { return ns_per_decode * inputs / bytes; }
+   };
+
+   throughput measure_throughput(const target& t, uint64_t min_time_ns) {
+      auto     corpus = valid_corpus(t);
+      uint64_t total  = 0;
+      for (const auto& input : corpus) {
+         if (!t.check(input.data(), input.size())) {
+            std::fprintf(stderr, "%s rejects a valid encoding\n", t.name.c_str());
+            std::exit(2);
+         }
+         total += input.size();
+      }
+      double ns = time_per_call(
+            [&] {
+               for (const auto& input : corpus)
+                  t.decode(input.data(), input.size());
+            },
+            min_time_ns);
+      return { t.name, corpus.size(), total, ns / corpus.size(), total * 1e3 / ns };
+   }
+
+   struct point {
+      uint32_t scale    = 0;
+      size_t   size     = 0;
+      double   ns       = 0;
+      bool     accepted = false;
+   };
+
+   struct scaling {
+      std::string        name;
+      std::vector<point> points;
+      double             size_exponent = 0;
+      double             cost_exponent = 0;
+      bool               superlinear   = false;
+      std::string        error;
+   };
+
+   /// Least squares slope of log(y) over log(scale)
+   template <typename Y>
+   double exponent(const std::vector<point>& points, Y y) {
+      double n = points.size(), sx = 0, sy = 0, sxx = 0, sxy = 0;
+      for (const auto& p : points) {
+         double lx = std::log(double(p.scale)), ly = std::log(std::max(y(p), 1e-3));
+         sx += lx;
+         sy += ly;
+         sxx += lx * lx;
+         sxy += lx * ly;
+      }
+      double d = n * sxx - sx * sx;
+      return d > 0 ? (n * sxy - sx * sy) / d : 0;
+   }
+
+   scaling measure_scaling(const target& t, const family& f, uint64_t min_time_ns, double tolerance) {
+      scaling result;
+      result.name = t.name + "/" + f.name;
+      try {
+         for (uint64_t scale = f.min_scale; scale <= f.max_scale; scale *= 2) {
+            auto  input = f.make(scale);
+            point p{ uint32_t(scale), input.size() };
+            p.accepted = t.check(input.data(), input.size());
+            p.ns       = time_per_call([&] { t.decode(input.data(), input.size()); }, min_time_ns);
+            result.points.push_back(p);
+         }
+      } catch (const std::exception& e) {
+         result.error       = e.what();
+         result.superlinear = true;
+         return result;
+      }
+      result.size_exponent = exponent(result.points, [](const point& p) { return double(p.size); });
+      result.cost_exponent = exponent(result.points, [](const point& p) { return p.ns; });
+      result.superlinear   = result.cost_exponent > result.size_exponent + tolerance;
+      return result;
+   }
+
+   bool matches(std::string_view name, std::string_view filter) { return name.find(filter) != std::string_view::npos; }
+
+   std::string throughput_json(const std::vector<throughput>& results, uint64_t min_time_ms) {
+      std::string json = "{\"target\":\"native\",\"min_time_ms\":" + std::to_string(min_time_ms) + ",\"decoders\":[";
+      for (size_t i = 0; i < results.size(); ++i) {
+         const auto& r = results[i];
+         json += std::string(i ? "," : "") + "\n  {\"name\":\"" + r.name + "\",\"inputs\":" + std::to_string(r.inputs) +
+                 ",\"bytes\":" + std::to_string(r.bytes) + ",\"ns_per_decode\":" + format_double(r.ns_per_decode) +
+                 ",\"mb_per_s\":" + format_double(r.mb_per_s) + "}";
+      }
+      return json + "\n]}\n";
+   }
+
+   std::string scaling_json(const std::vector<scaling>& results, double tolerance) {
+      std::string json = "{\"tolerance\":" + format_double(tolerance) + ",\"families\":[";
+      for (size_t i = 0; i < results.size(); ++i) {
+         const auto& r = results[i];
+         json += std::string(i ? "," : "") + "\n  {\"name\":\"" + r.name + "\",\"size_exponent\":" +
+                 format_double(r.size_exponent) + ",\"cost_exponent\":" + format_double(r.cost_exponent) +
+                 ",\"superlinear\":" + (r.superlinear ? "true" : "false");
+         if (!r.error.empty())
+            json += ",\"error\":\"" + r.error + "\"";
+         json += ",\"points\":[";
+         for (size_t j = 0; j < r.points.size(); ++j) {
+            const auto& p = r.points[j];
+            json += std::string(j ? "," : "") + "{\"scale\":" + std::to_string(p.scale) +
+                    ",\"bytes\":" + std::to_string(p.size) + ",\"ns\":" + format_double(p.ns, "%.1f") +
+                    ",\"accepted\":" + (p.accepted ? "true" : "false") + "}";
+         }
+         json += "]}";
+      }
+      return json + "\n]}\n";
+   }
+
+   bool write_file(const std::string& filename, const std::string& contents) {
+      std::ofstream out(filename, std::ios::binary);
+      out << contents;
+      return bool(out);
+   }
+
+   bytes read_file(const std::filesystem::path& path) {
+      std::ifstream in(path, std::ios::binary);
+      return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+   }
+
+   int run_throughput(std::string_view filter, uint64_t min_time_ms, const std::string& out) {
+      std::vector<throughput> results;
+      for (const auto& t : targets()) {
+         if (!matches(t.name, filter))
+            continue;
+         results.push_back(measure_throughput(t, min_time_ms * 1'000'000));
+         const auto& r = results.back();
+         std::printf("%-20s %10.1f MB/s %12.1f ns/decode %8zu inputs %10llu bytes\n", r.name.c_str(), r.mb_per_s,
+                     r.ns_per_decode, r.inputs, (unsigned long long)r.bytes);
+      }
+      if (!out.empty() && !write_file(out, throughput_json(results, min_time_ms)))
+         return 2;
+      return 0;
+   }
+
+   int run_scaling(std::string_view filter, uint64_t min_time_ms, double tolerance, const std::string& out) {
+      std::vector<scaling> results;
+      bool                 flagged = false;
+      for (const auto& t : targets()) {
+         for (const auto& f : t.families) {
+            if (!matches(t.name + "/" + f.name, filter))
+               continue;
+            results.push_back(measure_scaling(t, f, min_time_ms * 1'000'000, tolerance));
+            const auto& r = results.back();
+            flagged |= r.superlinear;
+            if (!r.error.empty())
+               std::printf("%-40s error: %s\n", r.name.c_str(), r.error.c_str());
+            else
+               std::printf("%-40s bytes ~ scale^%.2f  cost ~ scale^%.2f%s\n", r.name.c_str(), r.size_exponent,
+                           r.cost_exponent, r.superlinear ? "  SUPERLINEAR" : "");
+         }
+      }
+      if (!out.empty() && !write_file(out, scaling_json(results, tolerance)))
+         return 2;
+      return flagged;
+   }
+
+   int write_corpus(const std::filesystem::path& dir) {
+      std::filesystem::create_directories(dir);
+      const auto& all = targets();
+      for (size_t i = 0; i < all.size(); ++i) {
+         auto corpus = valid_corpus(all[i]);
+         for (size_t j = 0; j < corpus.size(); ++j) {
+            std::string contents(1, char(i));
+            contents.append(corpus[j].begin(), corpus[j].end());
+            if (!write_file(dir / (all[i].name + "-" + std::to_string(j)), contents))
+               return 2;
+         }
+      }
+      return 0;
+   }
+
+   // Replays fuzzer inputs, e.g. the crash-*, timeout-* and slow-unit-* files libFuzzer leaves
+   // behind. Each one is compared with the cost per byte of its target's valid corpus.
+   int replay(const std::vector<std::filesystem::path>& paths, double max_cost_ratio) {
+      std::vector<std::filesystem::path> files;
+      for (const auto& path : paths) {
+         if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+               if (entry.is_regular_file())
+                  files.push_back(entry.path());
+         } else {
+            files.push_back(path);
+         }
+      }
+      std::sort(files.begin(), files.end());
+
+      const auto&                            all = targets();
+      std::vector<std::optional<throughput>> baselines(all.size());
+      int                                    result = 0;
+      for (const auto& file : files) {
+         auto input = read_file(file);
+         if (input.empty())
+            continue;
+         size_t      index = uint8_t(input[0]) % all.size();
+         const auto& t     = all[index];
+         const char* data  = input.data() + 1;
+         size_t      size  = input.size() - 1;
+         try {
+            bool   accepted = t.check(data, size);
+            double ns       = time_per_call([&] { t.decode(data, size); }, 10'000'000);
+            if (!baselines[index])
+               baselines[index] = measure_throughput(t, 50'000'000);
+            const auto& b     = *baselines[index];
+            double      ratio = ns / (b.ns_per_byte() * std::max<double>(size, double(b.bytes) / b.inputs));
+            bool        slow  = ratio > max_cost_ratio;
+            std::printf("%s: %s, %zu bytes, %s, %.1f ns, %.1fx the valid corpus%s\n", file.c_str(), t.name.c_str(),
+                        size, accepted ? "accepted" : "rejected", ns, ratio, slow ? "  SLOW" : "");
+            if (slow)
+               result = 1;
+         } catch (const std::exception& e) {
+            std::printf("%s: %s, %zu bytes, error: %s\n", file.c_str(), t.name.c_str(), size, e.what());
+            result = 1;
+         }
+      }
+      return result;
+   }
+
+   int usage() {
+      std::fprintf(stderr,
+                   "usage: cdt_fuzz_decoders --throughput [--filter <substring>] [--min-time-ms <n>] [--out <file.json>]\n"
+                   "       cdt_fuzz_decoders --scaling [--filter <substring>] [--min-time-ms <n>] [--tolerance <x>] [--out <file.json>]\n"
+                   "       cdt_fuzz_decoders --write-corpus <dir>\n"
+                   "       cdt_fuzz_decoders [--max-cost-ratio <x>] <file or dir>...\n");
+      return 2;
+   }
+} // namespace
+
+int main(int argc, char** argv) {
+   enum { replay_inputs, throughput_mode, scaling_mode, corpus_mode } mode = replay_inputs;
+   std::string                        filter, out, corpus_dir;
+   uint64_t                           min_time_ms    = 0;
+   double                             tolerance      = 0.3;
+   double                             max_cost_ratio = 20;
+   std::vector<std::filesystem::path> paths;
+   for (int i = 1; i < argc; ++i) {
+      std::string_view arg  = argv[i];
+      bool             more = i + 1 < argc;
+      if (arg == "--throughput")
+         mode = throughput_mode;
+      else if (arg == "--scaling")
+         mode = scaling_mode;
+      else if (arg == "--write-corpus" && more)
+         mode = corpus_mode, corpus_dir = argv[++i];
+      else if (arg == "--filter" && more)
+         filter = argv[++i];
+      else if (arg == "--min-time-ms" && more)
+         min_time_ms = std::strtoull(argv[++i], nullptr, 10);
+      else if (arg == "--tolerance" && more)
+         tolerance = std::strtod(argv[++i], nullptr);
+      else if (arg == "--max-cost-ratio" && more)
+         max_cost_ratio = std::strtod(argv[++i], nullptr);
+      else if (arg == "--out" && more)
+         out = argv[++i];
+      else if (arg.substr(0, 2) == "--")
+         return usage();
+      else
+         paths.push_back(argv[i]);
+   }
+
+   switch (mode) {
+      case throughput_mode: return run_throughput(filter, min_time_ms ? min_time_ms : 200, out);
+      case scaling_mode: return run_scaling(filter, min_time_ms ? min_time_ms : 20, tolerance, out);
+      case corpus_mode: return write_corpus(corpus_dir);
+      default: return paths.empty() ? usage() : replay(paths, max_cost_ratio);
+   }
+}
+
+#endif
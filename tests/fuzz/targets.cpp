@@ -0,0 +1,363 @@
+#include "fuzz.hpp"
+
+#include <eosio/action.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/symbol.hpp>
+#include <eosio/transaction.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace cdt_fuzz;
+using eosio::asset;
+using eosio::name;
+using eosio::symbol;
+
+namespace {
+   // an argument that takes one of several types
+   using flat_variant = std::variant<uint64_t, std::string, name, asset, std::vector<uint8_t>>;
+
+   // a recursive variant: each level of nesting costs two bytes of input
+   struct node;
+   using node_value = std::variant<uint64_t, std::string, std::vector<node>>;
+
+   struct node {
+      node_value value;
+
+      EOSLIB_SERIALIZE(node, (value))
+   };
+
+   // action arguments that were extended twice after the first release
+   struct extended_args {
+      name                                       account;
+      asset                                      quantity;
+      eosio::binary_extension<std::string>       memo;
+      eosio::binary_extension<std::vector<name>> cosigners;
+
+      EOSLIB_SERIALIZE(extended_args, (account)(quantity)(memo)(cosigners))
+   };
+
+   // fields 1 to 5 of a protobuf message
+   struct pb_message {
+      uint64_t              id;
+      std::string           memo;
+      std::vector<uint64_t> amounts;
+      std::vector<char>     payload;
+      bool                  flag;
+   };
+
+   template <typename T>
+   bool decode(const char* data, size_t size) {
+      try {
+         auto value = eosio::unpack<T>(data, size);
+         sink       = &value;
+         return true;
+      } catch (const decode_error&) {
+         return false;
+      }
+   }
+
+   template <typename T>
+   bool check(const char* data, size_t size) {
+      T value;
+      try {
+         eosio::unpack(value, data, size);
+      } catch (const decode_error&) {
+         return false;
+      }
+      auto first = eosio::pack(value);
+      try {
+         auto second = eosio::pack(eosio::unpack<T>(first));
+         if (first == second)
+            return true;
+         std::fprintf(stderr, "round trip changed the encoding: %zu bytes packed into %zu, then %zu\n", size,
+                      first.size(), second.size());
+      } catch (const decode_error& e) {
+         std::fprintf(stderr, "round trip rejected its own encoding: %s\n", e.what());
+      }
+      std::abort();
+   }
+
+   template <typename T>
+   target make_target(std::string name, std::function<bytes(rng&)> sample, std::vector<family> families = {}) {
+      return { std::move(name), decode<T>, check<T>, std::move(sample), std::move(families) };
+   }
+
+   void put_varuint32(bytes& out, uint32_t value) {
+      do {
+         uint8_t b = value & 0x7f;
+         value >>= 7;
+         b |= (value > 0) << 7;
+         out.push_back(char(b));
+      } while (value);
+   }
+
+   void append(bytes& out, const bytes& tail) { out.insert(out.end(), tail.begin(), tail.end()); }
+
+   std::vector<char> random_bytes(rng& next, size_t size) {
+      std::vector<char> result(size);
+      for (auto& c : result)
+         c = char(next());
+      return result;
+   }
+
+   std::string random_string(rng& next, size_t size) {
+      std::string result(size, ' ');
+      for (auto& c : result)
+         c = char(' ' + next() % 95);
+      return result;
+   }
+
+   symbol random_symbol(rng& next) {
+      std::string code(1 + next() % 7, 'A');
+      for (auto& c : code)
+         c = char('A' + next() % 26);
+      return symbol(code, next() % 19);
+   }
+
+   asset random_asset(rng& next) {
+      return asset(int64_t(next() >> 3) - (int64_t(1) << 60), random_symbol(next));
+   }
+
+   eosio::action random_action(rng& next) {
+      eosio::action a;
+      a.account = name(next());
+      a.name    = name(next());
+      for (auto i = next() % 4; i > 0; --i)
+         a.authorization.push_back({ name(next()), name(next()) });
+      a.data = random_bytes(next, next() % 256);
+      return a;
+   }
+
+   eosio::transaction random_transaction(rng& next) {
+      eosio::transaction trx(eosio::time_point_sec(uint32_t(next())));
+      trx.ref_block_num       = uint16_t(next());
+      trx.ref_block_prefix    = uint32_t(next());
+      trx.max_net_usage_words = uint32_t(next() % 100000);
+      trx.max_cpu_usage_ms    = uint8_t(next());
+      trx.delay_sec           = uint32_t(next() % 3600);
+      for (auto i = next() % 2; i > 0; --i)
+         trx.context_free_actions.push_back(random_action(next));
+      for (auto i = 1 + next() % 4; i > 0; --i)
+         trx.actions.push_back(random_action(next));
+      if (next() % 4 == 0)
+         trx.transaction_extensions.emplace_back(uint16_t(next()), random_bytes(next, next() % 32));
+      return trx;
+   }
+
+   flat_variant random_flat_variant(rng& next) {
+      switch (next() % 5) {
+         case 0: return next();
+         case 1: return random_string(next, next() % 64);
+         case 2: return name(next());
+         case 3: return random_asset(next);
+         default: {
+            auto b = random_bytes(next, next() % 64);
+            return std::vector<uint8_t>(b.begin(), b.end());
+         }
+      }
+   }
+
+   node random_node(rng& next, int depth) {
+      if (depth == 0 || next() % 3 == 0) {
+         if (next() % 2)
+            return { next() };
+         return { random_string(next, next() % 16) };
+      }
+      std::vector<node> children;
+      for (auto i = 1 + next() % 3; i > 0; --i)
+         children.push_back(random_node(next, depth - 1));
+      return { std::move(children) };
+   }
+
+   extended_args random_extended_args(rng& next) {
+      extended_args args{ name(next()), random_asset(next) };
+      auto          extensions = next() % 3;
+      if (extensions >= 1)
+         args.memo.emplace(random_string(next, next() % 64));
+      if (extensions >= 2) {
+         std::vector<name> cosigners(next() % 4);
+         for (auto& n : cosigners)
+            n = name(next());
+         args.cosigners.emplace(std::move(cosigners));
+      }
+      return args;
+   }
+
+   pb_message random_pb_message(rng& next) {
+      pb_message message{ next(), random_string(next, next() % 32), {}, random_bytes(next, next() % 64), bool(next() % 2) };
+      for (auto i = next() % 8; i > 0; --i)
+         message.amounts.push_back(next() >> (next() % 64));
+      return message;
+   }
+
+   // the fields of a transaction before its action lists
+   bytes transaction_header() {
+      eosio::transaction trx(eosio::time_point_sec(1));
+      auto               packed = eosio::pack(trx);
+      packed.resize(packed.size() - 3); // the three empty lists
+      return packed;
+   }
+
+   std::vector<target> make_targets() {
+      std::vector<target> result;
+
+      result.push_back(make_target<name>("name", [](rng& next) { return eosio::pack(name(next())); }));
+      result.push_back(make_target<symbol>("symbol", [](rng& next) { return eosio::pack(random_symbol(next)); }));
+      result.push_back(make_target<asset>("asset", [](rng& next) { return eosio::pack(random_asset(next)); }));
+
+      result.push_back(make_target<eosio::action>(
+            "action", [](rng& next) { return eosio::pack(random_action(next)); },
+            { { "authorizations", 1 << 4, 1 << 14,
+                [](uint32_t scale) {
+                   eosio::action a;
+                   a.authorization.assign(scale, { "alice"_n, "active"_n });
+                   return eosio::pack(a);
+                } },
+              { "data", 1 << 10, 1 << 20,
+                [](uint32_t scale) {
+                   eosio::action a;
+                   a.data.assign(scale, 'x');
+                   return eosio::pack(a);
+                } },
+              { "claimed_authorizations", 1 << 8, 1 << 20,
+                [](uint32_t scale) {
+                   bytes input(16, 0);
+                   put_varuint32(input, scale);
+                   input.resize(input.size() + 16, 0);
+                   return input;
+                } },
+              { "claimed_data", 1 << 8, 1 << 24, [](uint32_t scale) {
+                   bytes input(16, 0);
+                   put_varuint32(input, 0);
+                   put_varuint32(input, scale);
+                   input.resize(input.size() + 8, 0);
+                   return input;
+                } } }));
+
+      result.push_back(make_target<eosio::transaction>(
+            "transaction", [](rng& next) { return eosio::pack(random_transaction(next)); },
+            { { "actions", 1 << 4, 1 << 12,
+                [](uint32_t scale) {
+                   eosio::transaction trx(eosio::time_point_sec(1));
+                   trx.actions.assign(scale, eosio::action({ "alice"_n, "active"_n }, "eosio.token"_n, "transfer"_n,
+                                                           std::string(16, 'x')));
+                   return eosio::pack(trx);
+                } },
+              { "claimed_actions", 1 << 8, 1 << 20,
+                [](uint32_t scale) {
+                   auto input = transaction_header();
+                   put_varuint32(input, 0);
+                   put_varuint32(input, scale);
+                   input.resize(input.size() + 32, 0);
+                   return input;
+                } },
+              { "claimed_extensions", 1 << 8, 1 << 20, [](uint32_t scale) {
+                   auto input = transaction_header();
+                   put_varuint32(input, 0);
+                   put_varuint32(input, 0);
+                   put_varuint32(input, scale);
+                   input.resize(input.size() + 8, 0);
+                   return input;
+                } } }));
+
+      result.push_back(make_target<flat_variant>(
+            "variant", [](rng& next) { return eosio::pack(random_flat_variant(next)); },
+            { { "string", 1 << 10, 1 << 20,
+                [](uint32_t scale) { return eosio::pack(flat_variant(std::string(scale, 'x'))); } },
+              { "claimed_string", 1 << 10, 1 << 24, [](uint32_t scale) {
+                   bytes input;
+                   put_varuint32(input, 1);
+                   put_varuint32(input, scale);
+                   input.resize(input.size() + 8, 'x');
+                   return input;
+                } } }));
+
+      // depth stays below what the native stack holds; the fuzzer bounds it with -max_len
+      result.push_back(make_target<node>(
+            "nested_variant", [](rng& next) { return eosio::pack(random_node(next, 4)); },
+            { { "depth", 1 << 4, 1 << 12,
+                [](uint32_t scale) {
+                   bytes input;
+                   for (uint32_t i = 0; i < scale; ++i) {
+                      put_varuint32(input, 2);
+                      put_varuint32(input, 1);
+                   }
+                   put_varuint32(input, 0);
+                   input.resize(input.size() + 8, 0);
+                   return input;
+                } },
+              { "width", 1 << 6, 1 << 16,
+                [](uint32_t scale) {
+                   node root{ std::vector<node>(scale, node{ uint64_t(42) }) };
+                   return eosio::pack(root);
+                } },
+              { "claimed_width", 1 << 8, 1 << 20, [](uint32_t scale) {
+                   bytes input;
+                   put_varuint32(input, 2);
+                   put_varuint32(input, scale);
+                   put_varuint32(input, 0);
+                   input.resize(input.size() + 8, 0);
+                   return input;
+                } } }));
+
+      result.push_back(make_target<extended_args>(
+            "binary_extension", [](rng& next) { return eosio::pack(random_extended_args(next)); },
+            { { "memo", 1 << 10, 1 << 20,
+                [](uint32_t scale) {
+                   extended_args args{ "alice"_n, asset(1, symbol("TOK", 4)) };
+                   args.memo.emplace(std::string(scale, 'x'));
+                   return eosio::pack(args);
+                } },
+              { "claimed_cosigners", 1 << 8, 1 << 24, [](uint32_t scale) {
+                   extended_args args{ "alice"_n, asset(1, symbol("TOK", 4)) };
+                   args.memo.emplace();
+                   auto input = eosio::pack(args);
+                   put_varuint32(input, scale);
+                   input.resize(input.size() + 8, 0);
+                   return input;
+                } } }));
+
+      result.push_back(make_target<eosio::pb<pb_message>>(
+            "pb", [](rng& next) { return eosio::pack(eosio::to_pb(random_pb_message(next))); },
+            { { "payload", 1 << 10, 1 << 20,
+                [](uint32_t scale) {
+                   pb_message message{};
+                   message.payload.assign(scale, 'x');
+                   return eosio::pack(eosio::to_pb(message));
+                } },
+              { "amounts", 1 << 6, 1 << 16,
+                [](uint32_t scale) {
+                   pb_message message{};
+                   message.amounts.assign(scale, uint64_t(-1));
+                   return eosio::pack(eosio::to_pb(message));
+                } },
+              // field 4 (payload), wire type 2, claiming `scale` bytes
+              { "claimed_payload", 1 << 10, 1 << 24, [](uint32_t scale) {
+                   bytes body{ char(4 << 3 | 2) };
+                   put_varuint32(body, scale);
+                   body.resize(body.size() + 8, 'x');
+                   bytes input;
+                   put_varuint32(input, body.size());
+                   append(input, body);
+                   return input;
+                } } }));
+
+      return result;
+   }
+} // namespace
+
+namespace cdt_fuzz {
+
+   const std::vector<target>& targets() {
+      static const std::vector<target> all = make_targets();
+      return all;
+   }
+
+} // namespace cdt_fuzz
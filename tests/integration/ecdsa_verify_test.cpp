@@ -126,6 +126,32 @@ TEST_CASE("ECDSA verify tests", "[ecdsa_verify]" ) {
    test_happy_path_verify(tester, message, signature_base64, pubkey);
 }
 
+TEST_CASE("ECDSA batch verify tests", "[ecdsa_verify_batch]" ) {
+   eosio::test_chain tester;
+   ecdsa_test_setup(tester);
+
+   const string message = "message to sign"s;
+   const string signature_base64 = "MEYCIQCi5byy/JAvLvFWjMP8ls7z0ttP8E9UApmw69OBzFWJ3gIhANFE2l3jO3L8c/kwEfuWMnh8q1BcrjYx3m368Xc/7QJU"s;
+   const string corrupt_signature_base64 = "MEYCIQCi5byy/JAvLvFWjMP8ls7z0ttP8E9UApmw69OBzFWJ3gIhANFE2l3jO3L8c/kwEfuWMnh8q1BcrjYx3m368Xc/7QJf"s;
+   const string pubkey =
+      "-----BEGIN PUBLIC KEY-----\n"
+      "MFkwEwYHKoZIzj0CAQYIKoZIzj0DAQcDQgAEzjca5ANoUF+XT+4gIZj2/X3V2UuT\n"
+      "E9MTw3sQVcJzjyC/p7KeaXommTC/7n501p4Gd1TiTiH+YM6fw/YYJUPSPg==\n"
+      "-----END PUBLIC KEY-----"s;
+
+   const std::vector<string> messages(3, message);
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifybatch"_n,
+                    std::tuple(messages, std::vector<string>(3, signature_base64), pubkey))} );
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifybatch"_n,
+                    std::tuple(std::vector<string>{}, std::vector<string>{}, pubkey))} );
+   tester.finish_block();
+
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifybatch"_n,
+                    std::tuple(messages, std::vector<string>{signature_base64, corrupt_signature_base64, signature_base64}, pubkey))},
+                    "verify_ecdsa_sigs() failed" );
+   tester.finish_block();
+}
+
 TEST_CASE("ECDSA invalid signature tests", "[ecdsa_invalid_sig]" ) {
    eosio::test_chain tester;
    ecdsa_test_setup(tester);
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+#include <eosio/merkle.hpp>
+#include <eosio/tester.hpp>
+
+#include <contracts.hpp>
+
+#include <bit>
+#include <cstring>
+
+using namespace eosio;
+using eosio::testing::contracts;
+
+namespace {
+
+std::vector<checksum256> make_leaves(uint32_t n) {
+   std::vector<checksum256> leaves;
+   for (uint32_t i = 0; i < n; ++i) {
+      leaves.push_back(sha256(reinterpret_cast<const char*>(&i), sizeof(i)));
+   }
+   return leaves;
+}
+
+void setup(test_chain& tester) {
+   tester.create_code_account( "merkle"_n );
+   tester.finish_block();
+   tester.set_code( "merkle"_n, contracts::merkle_tests_wasm() );
+   tester.finish_block();
+}
+
+checksum256 query_root(test_chain& tester, name act, const std::vector<checksum256>& leaves, int64_t& elapsed) {
+   auto trace = tester.transact({action({"merkle"_n, "active"_n}, "merkle"_n, act, std::tuple(leaves))});
+   elapsed += trace.action_traces[0].elapsed;
+   checksum256 root;
+   datastream<const char*> ds(trace.action_traces[0].return_value.data(), trace.action_traces[0].return_value.size());
+   ds >> root;
+   return root;
+}
+
+} // namespace
+
+TEST_CASE("merkle root shape", "[merkle]") {
+   auto leaves = make_leaves(3);
+   std::vector<checksum256> hashed;
+   for (const auto& leaf : leaves)
+      hashed.push_back(merkle_hash_leaf(leaf));
+
+   char leaf_bytes[33] = {0x00};
+   auto bytes = leaves[0].extract_as_byte_array();
+   std::memcpy(leaf_bytes + 1, bytes.data(), 32);
+   CHECK(hashed[0] == sha256(leaf_bytes, sizeof(leaf_bytes)));
+   CHECK(hashed[0] != leaves[0]);
+
+   CHECK(merkle_root(std::span<const checksum256>{}) == checksum256());
+   CHECK(merkle_root(std::span(leaves.data(), 1)) == hashed[0]);
+   CHECK(merkle_root(std::span(leaves.data(), 2)) == merkle_hash_pair(hashed[0], hashed[1]));
+   CHECK(merkle_root(leaves) == merkle_hash_pair(merkle_hash_pair(hashed[0], hashed[1]), hashed[2]));
+}
+
+TEST_CASE("an internal node does not verify as a leaf", "[merkle]") {
+   const auto leaves = make_leaves(4);
+   const auto root = merkle_root(leaves);
+   const auto left = merkle_hash_pair(merkle_hash_leaf(leaves[0]), merkle_hash_leaf(leaves[1]));
+   const auto right = merkle_hash_pair(merkle_hash_leaf(leaves[2]), merkle_hash_leaf(leaves[3]));
+   CHECK(merkle_hash_pair(left, right) == root);
+   // without domain separation, `left` would be leaf 0 of a tree of two leaves with the same root
+   const std::vector<checksum256> proof{ right };
+   CHECK(!verify_merkle_proof(left, 0, 2, proof, root));
+}
+
+TEST_CASE("merkle accumulator and proofs agree with merkle_root", "[merkle]") {
+   const auto leaves = make_leaves(40);
+   incremental_merkle acc;
+   CHECK(acc.root() == checksum256());
+
+   for (uint32_t n = 1; n <= leaves.size(); ++n) {
+      acc.append(leaves[n - 1]);
+      std::span<const checksum256> prefix(leaves.data(), n);
+      const auto root = merkle_root(prefix);
+      CHECK(acc.count == n);
+      CHECK(acc.root() == root);
+      CHECK(acc.peaks.size() == std::popcount(n));
+
+      for (uint32_t i = 0; i < n; ++i) {
+         auto proof = merkle_proof(prefix, i);
+         CHECK(verify_merkle_proof(leaves[i], i, n, proof, root));
+         auto longer = proof;
+         longer.push_back(root);
+         CHECK(!verify_merkle_proof(leaves[i], i, n, longer, root));
+         if (!proof.empty())
+            CHECK(!verify_merkle_proof(leaves[i], i, n, std::span(proof).first(proof.size() - 1), root));
+         if (n > 1) {
+            CHECK(!verify_merkle_proof(leaves[i], i ^ 1, n, proof, root));
+            proof.back() = leaves[i];
+            CHECK(!verify_merkle_proof(leaves[i], i, n, proof, root));
+         }
+      }
+   }
+}
+
+TEST_CASE("incremental_merkle stored in a singleton", "[merkle]") {
+   test_chain tester;
+   setup(tester);
+
+   const auto leaves = make_leaves(21);
+   const std::vector<checksum256> first(leaves.begin(), leaves.begin() + 8);
+   const std::vector<checksum256> second(leaves.begin() + 8, leaves.end());
+
+   tester.transact({action({"merkle"_n, "active"_n}, "merkle"_n, "append"_n, std::tuple(first))});
+   tester.transact({action({"merkle"_n, "active"_n}, "merkle"_n, "checkroot"_n, std::tuple(uint64_t{8}, merkle_root(first)))});
+   tester.transact({action({"merkle"_n, "active"_n}, "merkle"_n, "append"_n, std::tuple(second))});
+   tester.transact({action({"merkle"_n, "active"_n}, "merkle"_n, "checkroot"_n, std::tuple(uint64_t{21}, merkle_root(leaves)))});
+   tester.transact({action({"merkle"_n, "active"_n}, "merkle"_n, "checkroot"_n, std::tuple(uint64_t{21}, merkle_root(first)))},
+                   "incremental_merkle root mismatch");
+   tester.finish_block();
+}
+
+TEST_CASE("merkle root throughput", "[merkle][benchmark]") {
+   constexpr uint32_t iterations = 10;
+
+   test_chain tester;
+   setup(tester);
+   for (uint32_t n : {64u, 1024u}) {
+      const auto leaves = make_leaves(n);
+      const auto expected = merkle_root(leaves);
+      for (auto act : {"naiveroot"_n, "batchroot"_n}) {
+         int64_t elapsed = 0;
+         for (uint32_t i = 0; i < iterations; ++i) {
+            CHECK(query_root(tester, act, leaves, elapsed) == expected);
+            tester.finish_block();
+         }
+         eosio::print(act, ": ", n, " leaves, ", elapsed / iterations, " us/root\n");
+      }
+   }
+}
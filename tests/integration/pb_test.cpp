@@ -55,4 +55,15 @@ TEST_CASE_METHOD( test_chain, "protobuf tests", "[proto]" ) {
       CHECK(!res.opt_bytes_value.has_value());
       finish_block();
    }
+
+   SECTION("count.b action", "Every message of a batch is dispatched") {
+      std::vector<eosio::pb<test::ActData>> items;
+      for (int32_t id = 1; id <= 3; ++id)
+         items.push_back(test::ActData{ id, 2, "abc", 4 });
+      auto trace = transact({action({"test"_n, "active"_n}, "test"_n, "count.b"_n, items)});
+
+      REQUIRE(trace.action_traces.size() == 1);
+      CHECK(trace.action_traces[0].return_value == eosio::pack(std::vector<int32_t>{ 1, 2, 3 }));
+      finish_block();
+   }
 }
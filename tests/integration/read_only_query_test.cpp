@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+#include <eosio/tester.hpp>
+
+#include <contracts.hpp>
+
+using namespace eosio;
+using eosio::testing::contracts;
+
+namespace {
+
+// Manages resources used by the kv-store
+class [[eosio::contract]] kv_bios : eosio::contract {
+ public:
+   using contract::contract;
+   [[eosio::action]] void ramkvlimits(uint32_t k, uint32_t v, uint32_t i);
+   using ramkvlimits_action = action_wrapper<"ramkvlimits"_n, &kv_bios::ramkvlimits, "eosio"_n>;
+};
+
+void setup(test_chain& tester) {
+   tester.set_code( "eosio"_n, contracts::boot_wasm() );
+   tester.transact({action({"eosio"_n, "active"_n}, "eosio"_n, "activate"_n,
+                           tester.make_checksum256("825ee6288fb1373eab1b5187ec2f04f6eacb39cb3a97f356a07c91622dd61d16"))});
+   tester.finish_block();
+
+   tester.create_code_account( "roqtest"_n );
+   tester.finish_block();
+   tester.set_code( "roqtest"_n, contracts::read_only_query_tests_wasm() );
+   tester.finish_block();
+
+   tester.set_code("eosio"_n, contracts::kv_bios_wasm());
+   tester.as("roqtest"_n).act<kv_bios::ramkvlimits_action>(1024, 2046*1024, 256);
+   tester.finish_block();
+}
+
+std::vector<char> query(test_chain& tester, name act, int64_t& elapsed) {
+   auto trace = tester.transact({action({"roqtest"_n, "active"_n}, "roqtest"_n, act, std::tuple())});
+   elapsed += trace.action_traces[0].elapsed;
+   return trace.action_traces[0].return_value;
+}
+
+uint32_t row_count(const std::vector<char>& packed) {
+   unsigned_int count;
+   datastream<const char*> ds(packed.data(), packed.size());
+   ds >> count;
+   return count.value;
+}
+
+} // namespace
+
+TEST_CASE("result_stream returns the same packed result as std::vector", "[read_only_query]") {
+   test_chain tester;
+   setup(tester);
+   tester.transact({action({"roqtest"_n, "active"_n}, "roqtest"_n, "fill"_n, std::tuple(uint32_t{100}, uint32_t{50}))});
+   tester.finish_block();
+
+   int64_t elapsed = 0;
+   auto from_vector = query(tester, "getvec"_n, elapsed);
+   auto from_stream = query(tester, "getstream"_n, elapsed);
+   CHECK(row_count(from_vector) == 50);
+   CHECK(from_vector == from_stream);
+}
+
+TEST_CASE("read-only query throughput", "[read_only_query][benchmark]") {
+   constexpr uint32_t rows       = 1000;
+   constexpr uint32_t iterations = 20;
+
+   test_chain tester;
+   setup(tester);
+   for (uint32_t first = 0; first < rows; first += 100) {
+      tester.transact({action({"roqtest"_n, "active"_n}, "roqtest"_n, "fill"_n, std::tuple(first, uint32_t{100}))});
+   }
+   tester.finish_block();
+
+   for (auto act : {"getvec"_n, "getstream"_n}) {
+      int64_t elapsed = 0;
+      for (uint32_t i = 0; i < iterations; ++i) {
+         CHECK(row_count(query(tester, act, elapsed)) == rows);
+         tester.finish_block();
+      }
+      eosio::print(act, ": ", rows, " rows, ", elapsed / iterations, " us/query\n");
+   }
+}
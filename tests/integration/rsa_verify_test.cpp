@@ -28,6 +28,14 @@ void test_happy_path(test_chain& tester, const string& message, const string& si
 
    tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verify2"_n, std::tuple(message, signature_base64, pubkey))} );
    tester.finish_block();
+
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "setkey"_n, std::tuple(pubkey))} );
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifykey"_n, std::tuple(message, signature_base64))} );
+   tester.finish_block();
+
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifybatch"_n,
+                    std::tuple(std::vector<string>(3, message), std::vector<string>(3, signature_base64), pubkey))} );
+   tester.finish_block();
 }
 
 void test_incorrect_signature(test_chain& tester, const string& message, const string& corrupt_signature, const string& exponent, const string& modulus, const string& corrupt_signature_base64, const string& pubkey) {
@@ -38,6 +46,16 @@ void test_incorrect_signature(test_chain& tester, const string& message, const s
    tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verify2"_n, std::tuple(message, corrupt_signature_base64, pubkey))},
                     "verify_rsa_sha256_sig() failed" );
    tester.finish_block();
+
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "setkey"_n, std::tuple(pubkey))} );
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifykey"_n, std::tuple(message, corrupt_signature_base64))},
+                    "verify_rsa_sha256_sig() failed" );
+   tester.finish_block();
+
+   tester.transact( {eosio::action({"test"_n, "active"_n},  "test"_n, "verifybatch"_n,
+                    std::tuple(std::vector<string>(2, message), std::vector<string>(2, corrupt_signature_base64), pubkey))},
+                    "verify_rsa_sha256_sig() failed" );
+   tester.finish_block();
 }
 
 TEST_CASE("RSA verify tests 1024 bit", "[rsa_verify_1024]" ) {
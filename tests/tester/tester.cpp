@@ -1,4 +1,8 @@
 #include <eosio/tester.hpp>
+#include <eosio/test_chain_pool.hpp>
+#include <eosio/crypto.hpp>
+#include <atomic>
+#include <span>
 #include <string_view>
 #include "../unit/test_contracts/tester_tests.hpp"
 #define CATCH_CONFIG_MAIN
@@ -129,6 +133,78 @@ TEST_CASE_METHOD(eosio::test_chain, "MultiIndex API", "[multi_index]") {
    }
 }
 
+TEST_CASE_METHOD(eosio::test_chain, "push_transactions", "[push_transactions]") {
+   eosio::action empty{ { { "eosio"_n, "active"_n } }, "eosio"_n, eosio::name(), std::tuple() };
+   eosio::action unauthorized{ { { "nobody"_n, "active"_n } }, "eosio"_n, eosio::name(), std::tuple() };
+
+   std::vector<eosio::transaction> trxs;
+   for (uint32_t i = 0; i < 3; ++i) {
+      trxs.push_back(make_transaction({ i == 1 ? unauthorized : empty }));
+      fill_tapos(trxs.back(), 1 + i);
+   }
+
+   auto results = push_transactions(trxs);
+   REQUIRE(results.size() == 3);
+   CHECK(results[0].status == eosio::transaction_status::executed);
+   CHECK(results[0].id == sha256(trxs[0]));
+   CHECK(results[0].cpu_usage_us == 2000);
+   CHECK(!results[0].trace);
+   CHECK(results[1].status != eosio::transaction_status::executed);
+   REQUIRE(results[1].trace);
+   CHECK(results[1].trace->except);
+   CHECK(results[2].status == eosio::transaction_status::executed);
+
+   for (auto& trx : trxs)
+      fill_tapos(trx, 10 + (&trx - trxs.data()));
+   results = push_transactions(trxs, eosio::trace_mode::full);
+   CHECK(results[0].trace);
+   CHECK(results[0].trace->action_traces.size() == 1);
+   CHECK(results[0].elapsed == results[0].trace->elapsed);
+
+   results = push_transactions(std::span(trxs).first(1), eosio::trace_mode::status);
+   CHECK(results[0].status != eosio::transaction_status::executed); // duplicate of the batch above
+   CHECK(!results[0].trace);
+}
+
+eosio::test_chain_fixture tester_tests_fixture("tester_tests", { "../unit/test_contracts/tester_tests.wasm" },
+                                               [](eosio::test_chain& t) {
+                                                  t.create_account("test"_n);
+                                                  t.set_code("test"_n, "../unit/test_contracts/tester_tests.wasm");
+                                               },
+                                               TEST_CHAIN_FIXTURE_DIR);
+
+struct tester_tests_chain : eosio::test_chain {
+   tester_tests_chain() : eosio::test_chain(tester_tests_fixture.snapshot().c_str()) {}
+};
+
+TEST_CASE_METHOD(tester_tests_chain, "test_chain_fixture", "[test_chain_fixture]") {
+   eosio::action act{{ "test"_n, "active"_n }, "test"_n, "putdb"_n, std::make_tuple(3, 4)};
+   eosio::expect(push_transaction(make_transaction({ act })));
+
+   tester_tests::table t("test"_n, 0);
+   CHECK(t.get(3).value == 4);
+}
+
+TEST_CASE("test_chain_fixture runs the setup once per snapshot", "[test_chain_fixture]") {
+   const std::string cache_dir = TEST_CHAIN_FIXTURE_DIR "/setup_count";
+   eosio::execute("rm -rf '" + cache_dir + "'");
+
+   int  setups = 0;
+   auto setup  = [&](eosio::test_chain& t) {
+      ++setups;
+      t.create_account("test"_n);
+   };
+   eosio::test_chain_fixture first("counted", { "../unit/test_contracts/tester_tests.wasm" }, setup, cache_dir);
+   eosio::test_chain_fixture second("counted", { "../unit/test_contracts/tester_tests.wasm" }, setup, cache_dir);
+   const std::string snapshot = first.snapshot();
+   CHECK(setups == 1);
+   // a fixture with the same name and inputs finds the snapshot the first one wrote
+   CHECK(second.snapshot() == snapshot);
+   CHECK(setups == 1);
+
+   eosio::execute("rm -rf '" + cache_dir + "'");
+}
+
 TEST_CASE_METHOD(eosio::test_chain, "Creating signatures", "[sign]") {
    create_account("test"_n);
    set_code("test"_n, "../unit/test_contracts/tester_tests.wasm");
@@ -161,3 +237,107 @@ TEST_CASE("Runtime library 128-bit integer operations") {
    CHECK((au << bu) == 400);
    CHECK((au >> bu) == 25);
 }
+
+#ifndef __wasm__
+TEST_CASE("test_chain_pool", "[test_chain_pool]") {
+   eosio::test_chain_pool pool(4);
+   eosio::action empty{ { { "eosio"_n, "active"_n } }, "eosio"_n, eosio::name(), std::tuple() };
+
+   std::vector<std::future<eosio::transaction_trace>> traces;
+   for (int i = 0; i < 8; ++i) {
+      traces.push_back(pool.run([&](eosio::test_chain& t) {
+         t.create_account("test"_n);
+         t.finish_block();
+         return t.push_transaction(t.make_transaction({ empty }));
+      }));
+   }
+   // every scenario starts from genesis on a chain of its own, so they all see the same sequence
+   std::vector<eosio::transaction_trace> results;
+   for (auto& trace : traces)
+      results.push_back(trace.get());
+   for (auto& trace : results) {
+      CHECK(trace.status == eosio::transaction_status::executed);
+      CHECK(trace.action_traces[0].receipt->global_sequence == results[0].action_traces[0].receipt->global_sequence);
+   }
+
+   // work queued on one chain runs in order
+   auto chain    = pool.create_chain();
+   auto first    = chain.transact({ empty });
+   auto finished = chain.finish_block();
+   auto head     = chain.post([](eosio::test_chain& t) { return t.get_head_block_info().block_num; });
+   CHECK(first.get().status == eosio::transaction_status::executed);
+   finished.get();
+   CHECK(head.get() == 2);
+}
+
+// Guards the pool's requirement that the host keeps concurrently driven chains apart. Every
+// scenario writes the same row on its own chain: each write must create the row and bill RAM for
+// it, which only one of them would do if the chains shared their state.
+TEST_CASE("test_chain_pool keeps chains isolated", "[test_chain_pool]") {
+   constexpr int          scenarios = 8;
+   eosio::test_chain_pool pool(scenarios);
+
+   std::vector<std::future<std::vector<int64_t>>> deltas;
+   for (int i = 0; i < scenarios; ++i) {
+      deltas.push_back(pool.run([i](eosio::test_chain& t) {
+         t.create_account("test"_n);
+         t.set_code("test"_n, "../unit/test_contracts/tester_tests.wasm");
+         std::vector<int64_t> result;
+         for (int block = 0; block < 3; ++block) {
+            t.finish_block();
+            auto trace = t.as("test"_n).act<tester_tests::putdb_action>(block, i);
+            int64_t ram = 0;
+            for (const auto& delta : trace.action_traces[0].account_ram_deltas)
+               ram += delta.delta;
+            result.push_back(ram);
+         }
+         return result;
+      }));
+   }
+   std::vector<std::vector<int64_t>> results;
+   for (auto& d : deltas)
+      results.push_back(d.get());
+   for (const auto& r : results) {
+      CHECK(r.size() == 3);
+      CHECK(r[0] > 0);
+      CHECK(r == results[0]);
+   }
+}
+
+TEST_CASE("verify_ecdsa_sigs on the native thread pool", "[verify_sigs]") {
+   const std::string message   = "message to sign";
+   const std::string signature = "MEYCIQCi5byy/JAvLvFWjMP8ls7z0ttP8E9UApmw69OBzFWJ3gIhANFE2l3jO3L8c/kwEfuWMnh8q1BcrjYx3m368Xc/7QJU";
+   const std::string corrupt   = "MEYCIQCi5byy/JAvLvFWjMP8ls7z0ttP8E9UApmw69OBzFWJ3gIhANFE2l3jO3L8c/kwEfuWMnh8q1BcrjYx3m368Xc/7QJf";
+   const std::string pubkey =
+      "-----BEGIN PUBLIC KEY-----\n"
+      "MFkwEwYHKoZIzj0CAQYIKoZIzj0DAQcDQgAEzjca5ANoUF+XT+4gIZj2/X3V2UuT\n"
+      "E9MTw3sQVcJzjyC/p7KeaXommTC/7n501p4Gd1TiTiH+YM6fw/YYJUPSPg==\n"
+      "-----END PUBLIC KEY-----";
+
+   constexpr uint32_t n = 64;
+   std::vector<eosio::ecdsa_sig_item> items;
+   for (uint32_t i = 0; i < n; ++i)
+      items.push_back({ message, i % 3 ? signature : corrupt, pubkey });
+
+   bool results[n];
+   CHECK(!eosio::verify_ecdsa_sigs(items, results));
+   for (uint32_t i = 0; i < n; ++i)
+      CHECK(results[i] == (i % 3 != 0));
+   CHECK(eosio::verify_ecdsa_sigs(std::span(items).subspan(1, 2)));
+
+   // batches started from pool chunks run inline rather than waiting for the busy pool
+   struct nested_ctx {
+      std::span<const eosio::ecdsa_sig_item> items;
+      std::atomic<uint32_t>                  passed = 0;
+   } ctx{ items };
+   eosio::internal_use_do_not_use::parallel_for(n, [](void* p, uint32_t begin, uint32_t end) {
+      auto& c = *static_cast<nested_ctx*>(p);
+      for (uint32_t i = begin; i < end; ++i) {
+         bool ok[1];
+         if (eosio::verify_ecdsa_sigs(c.items.subspan(i, 1), ok) == ok[0] && ok[0])
+            ++c.passed;
+      }
+   }, &ctx);
+   CHECK(ctx.passed == n - (n + 2) / 3);
+}
+#endif
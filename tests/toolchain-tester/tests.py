@@ -9,9 +9,11 @@ import json
 import os
 import subprocess
 import re
+import shutil
 from pprint import pprint
 from printer import Printer as P
 from errors import TestFailure
+import wasm
 
 if TYPE_CHECKING:
     from testsuite import TestSuite
@@ -68,6 +70,17 @@ class Test(ABC):
 
         self._run(eosio_cpp, args)
 
+    def run_tool(self, command: List[str]) -> subprocess.CompletedProcess:
+        res = subprocess.run(command, capture_output=True)
+        P.print(res.stdout.decode("utf-8").strip(), verbose=True)
+        if res.returncode != 0:
+            self.fail(f"{os.path.basename(command[0])} failed with the following stderr {res.stderr.decode('utf-8').strip()}")
+        return res
+
+    def fail(self, message: str):
+        self.success = False
+        raise TestFailure(message, failing_test=self)
+
     def handle_test_result(self, res: subprocess.CompletedProcess, expected_pass=True):
         stdout = res.stdout.decode("utf-8").strip()
         stderr = res.stderr.decode("utf-8").strip()
@@ -226,3 +239,197 @@ class AbigenFailTest(Test):
         self.handle_test_result(res, expected_pass=False)
 
         return res
+
+
+class PostpassPassTest(Test):
+    """
+    Assembles the test's .wat file, runs eosio-pp over it with and without --no-optimize and
+    checks that the optimized module behaves like its input: the same exports, start function,
+    tables and element segments (compared up to renumbering and merging of identical
+    functions, but exported and table functions that were distinct must stay distinct) and the
+    same initial memory contents.
+
+    Expected output, all optional:
+    - "functions", "function-imports", "data-segments": counts in the optimized module
+    - "baseline": true if no pass applies, so the optimized module must equal the --no-optimize one
+    """
+
+    def _run(self, eosio_cpp, args):
+        wat2wasm = os.path.join(self.test_suite.cdt_path, "wat2wasm")
+        eosio_pp = os.path.join(self.test_suite.cdt_path, "eosio-pp")
+        in_wasm = f"{self.name}.wasm"
+        baseline_wasm = f"{self.name}.baseline.wasm"
+        out_wasm = f"{self.name}.pp.wasm"
+
+        self.run_tool([wat2wasm, self.cpp_file, "-o", in_wasm])
+        self.run_tool([eosio_pp, in_wasm, "-o", baseline_wasm, "--no-optimize", *args])
+        res = self.run_tool([eosio_pp, in_wasm, "-o", out_wasm, *args])
+
+        modules = []
+        for f in (in_wasm, baseline_wasm, out_wasm):
+            with open(f, "rb") as wf:
+                modules.append(wf.read())
+        try:
+            self.check_module(*map(wasm.Module, modules), modules[1] == modules[2])
+        except wasm.WasmError as e:
+            self.fail(f"cannot read the output of eosio-pp: {e}")
+
+        self.success = True
+        return res
+
+    def check_module(self, inp: wasm.Module, baseline: wasm.Module, out: wasm.Module, same_as_baseline: bool):
+        expected = self.test_json.get("expected", {})
+
+        if expected.get("baseline") and not same_as_baseline:
+            self.fail("expected the same module as eosio-pp --no-optimize")
+
+        in_classes, out_classes = wasm.function_classes(inp, out)
+
+        def same_func(in_index, out_index):
+            if in_index is None or out_index is None:
+                return in_index == out_index
+            return in_classes[in_index] == out_classes[out_index]
+
+        if [e[:2] for e in out.exports] != [e[:2] for e in baseline.exports]:
+            self.fail(f"exports {out.exports} differ from {baseline.exports}")
+        in_funcs = {name: index for name, kind, index in inp.exports if kind == 0}
+        for name, kind, index in out.exports:
+            if kind == 0 and not same_func(in_funcs[name], index):
+                self.fail(f"export {name} no longer refers to the same function")
+
+        if not same_func(inp.start, out.start):
+            self.fail("start function changed")
+
+        if out.tables != inp.tables:
+            self.fail(f"tables {out.tables} differ from {inp.tables}")
+        if len(out.elems) != len(inp.elems):
+            self.fail(f"{len(out.elems)} element segments instead of {len(inp.elems)}")
+        for i, (a, b) in enumerate(zip(inp.elems, out.elems)):
+            if a[:3] != b[:3] or len(a.funcs) != len(b.funcs):
+                self.fail(f"element segment {i} changed from {a} to {b}")
+            for j, (fa, fb) in enumerate(zip(a.funcs, b.funcs)):
+                if not same_func(fa, fb):
+                    self.fail(f"element {j} of segment {i} no longer refers to the same function")
+
+        # functions whose address is observable keep it: two of them that differed before must
+        # still differ, even when their bodies are identical
+        def addresses(m: wasm.Module):
+            refs = {("export", name): index for name, kind, index in m.exports if kind == 0}
+            for i, seg in enumerate(m.elems):
+                for j, f in enumerate(seg.funcs):
+                    if f is not None:
+                        refs[("elem", i, j)] = f
+            return refs
+
+        in_addresses, out_addresses = addresses(inp), addresses(out)
+        pairs = {(in_addresses[k], out_addresses[k]) for k in out_addresses if k in in_addresses}
+        if len(pairs) != len({a for a, _ in pairs}) or len(pairs) != len({b for _, b in pairs}):
+            self.fail("functions whose address is observable were merged")
+
+        # eosio-pp stores the heap base in the first word of memory
+        in_image, out_image = inp.memory_image(), out.memory_image()
+        heap_base = int.from_bytes(bytes(out_image[:4]).ljust(4, b"\0"), "little")
+        out_image[:4] = bytes(min(4, len(out_image)))
+        if in_image.rstrip(b"\0") != out_image.rstrip(b"\0"):
+            self.fail("initial memory contents changed")
+        if [d.data for d in inp.data if d.mode == "passive"] != [d.data for d in out.data if d.mode == "passive"]:
+            self.fail("passive data segments changed")
+
+        if inp.memories and not any(i.kind == 2 for i in inp.imports):
+            initial, maximum = inp.memories[0]
+            end = max(heap_base, len(out.memory_image()))
+            pages = min(initial, max(1, (end + wasm.PAGE_SIZE - 1) // wasm.PAGE_SIZE))
+            if out.memories[0] != (pages, maximum):
+                self.fail(f"memory limits {out.memories[0]}, expected {(pages, maximum)}")
+
+        counts = {
+            "functions": out.num_defined_funcs,
+            "function-imports": out.num_func_imports,
+            "data-segments": len(out.data),
+        }
+        for key, actual in counts.items():
+            if key in expected and expected[key] != actual:
+                self.fail(f"expected {expected[key]} {key} but got {actual}")
+
+
+class TraceDecodeTest(Test):
+    """
+    Builds the test's contract with --smart-contract-trace-format=binary, records a trace that
+    passes every checkpoint of the generated tracemap once and checks that eosio-trace-decode
+    turns it back into the text trace those checkpoints stand for. The contract is copied to a
+    file name with a space first, so that the map has to carry spaces in locations too.
+
+    Expected output, all optional:
+    - "names": function and variable names that must be in the map, e.g. "operator bool"
+    """
+
+    def _run(self, eosio_cpp, args):
+        trace_decode = os.path.join(self.test_suite.cdt_path, "eosio-trace-decode")
+        source = os.path.abspath(f"{self.name} trace.cpp")
+        map_file = f"{source}.tracemap"
+        if os.path.exists(map_file):
+            os.remove(map_file)
+        shutil.copyfile(self.cpp_file, source)
+
+        self.run_tool([eosio_cpp, source, "--contract", self._name, "--smart-contract-trace-format=binary", *args])
+        with open(map_file) as mf:
+            entries = [line.rstrip("\n").split("\t") for line in mf if line.strip()]
+        if not entries or any(len(e) != 4 for e in entries):
+            self.fail(f"malformed trace map {map_file}")
+
+        names = {e[3] for e in entries}
+        for name in self.test_json.get("expected", {}).get("names", []):
+            if name not in names:
+                self.fail(f"trace map has no checkpoint for {name}")
+
+        # the cdt.trace event layout of eosio/binary_trace.hpp: records are a varuint32 of
+        # id << 3 | kind, followed by a 64 bit value unless the kind is 0
+        def varuint(v):
+            out = bytearray()
+            while True:
+                out.append((v & 0x7F) | (0x80 if v > 0x7F else 0))
+                v >>= 7
+                if not v:
+                    return bytes(out)
+
+        def name_value(text):
+            charmap = ".12345abcdefghijklmnopqrstuvwxyz"
+            value = 0
+            for i, c in enumerate(text[:12]):
+                value |= charmap.index(c) << (64 - 5 * (i + 1))
+            return value
+
+        event = bytearray(4) + varuint(len(entries))
+        expected = ""
+        in_enter = False
+        for id, kind, location, name in entries:
+            if in_enter and kind != "var":
+                expected += ")@"
+                in_enter = False
+            if kind == "var":
+                # alternate unsigned and name values to cover both decodings
+                if int(id) % 2:
+                    event += varuint(int(id) << 3 | 4) + name_value("alice").to_bytes(8, "little")
+                    expected += f",{name}=alice"
+                else:
+                    event += varuint(int(id) << 3 | 2) + int(id).to_bytes(8, "little")
+                    expected += f",{name}={id}"
+                continue
+            event += varuint(int(id) << 3)
+            if kind == "enter":
+                expected += f"@{location}(@{name}"
+                in_enter = True
+            elif kind == "exit":
+                expected += f"@{location.split(':')[0]}(~{name})@"
+            else:
+                expected += f"@{location}" + (f"(@{name})" if name else "") + "@"
+        if in_enter:
+            expected += ")@"
+
+        res = self.run_tool([trace_decode, "--map", map_file, event.hex()])
+        actual = res.stdout.decode("utf-8").strip()
+        if actual != expected:
+            self.fail(f"decoded trace\n{actual}\ndiffers from\n{expected}")
+
+        self.success = True
+        return res
@@ -14,6 +14,8 @@ class TestType(Enum):
     BUILD_PASS = 4
     ABIGEN_PASS = 5
     ABIGEN_FAIL = 6
+    POSTPASS_PASS = 7
+    TRACE_DECODE = 8
 
     @staticmethod
     def from_str(s):
@@ -38,19 +40,22 @@ class TestSuite:
 
         test_files = []
 
+        # postpass tests start from a hand written module rather than from C++
+        source_ext = ".wat" if self.test_type == TestType.POSTPASS_PASS else ".cpp"
+
         for f in os.listdir(self.directory):
             abs_f = os.path.join(self.directory, f)
 
             file_name = abs_f.split("/")[-1]
             name = file_name.split(".")[0]
 
-            if ".cpp" in file_name:
+            if source_ext in file_name:
                 if not os.path.isfile(os.path.join(self.directory, f"{name}.json")):
                     raise MissingJsonError(f"{file_name} is missing the test json file")
 
             if ".json" in file_name:
-                if not os.path.isfile(os.path.join(self.directory, f"{name}.cpp")):
-                    raise MissingCppError(f"{file_name} is missing the test cpp file")
+                if not os.path.isfile(os.path.join(self.directory, f"{name}{source_ext}")):
+                    raise MissingCppError(f"{file_name} is missing the test {source_ext[1:]} file")
                 test_files.append(abs_f)
 
         for tf in test_files:
@@ -59,7 +64,7 @@ class TestSuite:
 
             name = tf.split("/")[-1].split(".")[0]
             for i, t in enumerate(test_json["tests"]):
-                cpp_file = os.path.join(self.directory, f"{name}.cpp")
+                cpp_file = os.path.join(self.directory, f"{name}{source_ext}")
 
                 args = [cpp_file, t, i, self]
 
@@ -75,6 +80,10 @@ class TestSuite:
                     self.tests.append(tests.AbigenPassTest(*args))
                 elif self.test_type == TestType.ABIGEN_FAIL:
                     self.tests.append(tests.AbigenFailTest(*args))
+                elif self.test_type == TestType.POSTPASS_PASS:
+                    self.tests.append(tests.PostpassPassTest(*args))
+                elif self.test_type == TestType.TRACE_DECODE:
+                    self.tests.append(tests.TraceDecodeTest(*args))
 
     def _get_test_type(self) -> TestType:
         return TestType.from_str(self.directory.split("/")[-1])
@@ -0,0 +1,341 @@
+"""
+A minimal WebAssembly binary reader for checking the output of eosio-pp.
+
+Only what the postpass tests compare is decoded: function signatures and bodies, imports,
+exports, the start function, tables, element segments, memories and data segments. Function
+bodies are split into their bytes with every function index taken out (call, return_call and
+ref.func), so that functions from two modules can be compared after renumbering.
+"""
+
+from typing import Dict, List, NamedTuple, Optional, Tuple
+
+PAGE_SIZE = 65536
+
+
+class WasmError(Exception):
+    pass
+
+
+class Import(NamedTuple):
+    module: str
+    field: str
+    kind: int
+    type_index: Optional[int]
+
+
+class Func(NamedTuple):
+    signature: Tuple[bytes, bytes]
+    import_name: Optional[str]
+    template: bytes
+    refs: List[int]
+
+
+class ElemSegment(NamedTuple):
+    mode: str
+    table: int
+    offset: Optional[int]
+    funcs: List[Optional[int]]
+
+
+class DataSegment(NamedTuple):
+    mode: str
+    memory: int
+    offset: Optional[int]
+    data: bytes
+
+
+class Reader:
+    def __init__(self, data: bytes, pos: int = 0, end: Optional[int] = None):
+        self.data = data
+        self.pos = pos
+        self.end = len(data) if end is None else end
+
+    def done(self) -> bool:
+        return self.pos >= self.end
+
+    def byte(self) -> int:
+        if self.pos >= self.end:
+            raise WasmError("unexpected end of input")
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def bytes(self, n: int) -> bytes:
+        if self.pos + n > self.end:
+            raise WasmError("unexpected end of input")
+        b = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return b
+
+    def uleb(self) -> int:
+        result, shift = 0, 0
+        while True:
+            b = self.byte()
+            result |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return result
+
+    def sleb(self) -> int:
+        result, shift = 0, 0
+        while True:
+            b = self.byte()
+            result |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                if b & 0x40:
+                    result -= 1 << shift
+                return result
+
+    def name(self) -> str:
+        return self.bytes(self.uleb()).decode("utf-8")
+
+
+VALTYPES = (0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x70, 0x6F)
+
+
+def read_const_expr(r: Reader) -> Tuple[Optional[int], Optional[int]]:
+    """Returns (i32 value, function index) of a constant expression, either may be None."""
+    value, func = None, None
+    while True:
+        op = r.byte()
+        if op == 0x0B:
+            return value, func
+        if op == 0x41:
+            value = r.sleb() & 0xFFFFFFFF
+        elif op == 0x42:
+            r.sleb()
+        elif op == 0x43:
+            r.bytes(4)
+        elif op == 0x44:
+            r.bytes(8)
+        elif op == 0x23:
+            r.uleb()
+        elif op == 0xD0:
+            r.byte()
+        elif op == 0xD2:
+            func = r.uleb()
+        else:
+            raise WasmError(f"unsupported opcode 0x{op:02x} in constant expression")
+
+
+def split_body(body: bytes) -> Tuple[bytes, List[int]]:
+    """Splits a function body into its bytes without function indices and those indices, in order."""
+    r = Reader(body)
+    template = bytearray()
+    refs: List[int] = []
+    start = 0
+
+    def take_ref():
+        nonlocal start
+        template.extend(body[start : r.pos])
+        refs.append(r.uleb())
+        start = r.pos
+
+    for _ in range(r.uleb()):
+        r.uleb()
+        r.byte()
+    while not r.done():
+        op = r.byte()
+        if op in (0x02, 0x03, 0x04):
+            if r.data[r.pos] in VALTYPES or r.data[r.pos] == 0x40:
+                r.byte()
+            else:
+                r.sleb()
+        elif op in (0x0C, 0x0D) or 0x20 <= op <= 0x26:
+            r.uleb()
+        elif op == 0x0E:
+            for _ in range(r.uleb() + 1):
+                r.uleb()
+        elif op in (0x10, 0x12, 0xD2):
+            take_ref()
+        elif op in (0x11, 0x13):
+            r.uleb()
+            r.uleb()
+        elif op == 0x1C:
+            for _ in range(r.uleb()):
+                r.byte()
+        elif 0x28 <= op <= 0x3E:
+            r.uleb()
+            r.uleb()
+        elif op in (0x3F, 0x40, 0xD0):
+            r.byte()
+        elif op == 0x41 or op == 0x42:
+            r.sleb()
+        elif op == 0x43:
+            r.bytes(4)
+        elif op == 0x44:
+            r.bytes(8)
+        elif op == 0xFC:
+            sub = r.uleb()
+            if sub == 8:
+                r.uleb()
+                r.byte()
+            elif sub in (9, 13, 15, 16, 17):
+                r.uleb()
+            elif sub == 10:
+                r.byte()
+                r.byte()
+            elif sub == 11:
+                r.byte()
+            elif sub in (12, 14):
+                r.uleb()
+                r.uleb()
+            elif sub > 7:
+                raise WasmError(f"unsupported opcode 0xfc {sub}")
+        elif op in (0x05, 0x06, 0x07, 0x08, 0x09, 0x18, 0x19, 0xFD, 0xFE):
+            raise WasmError(f"unsupported opcode 0x{op:02x}")
+    template.extend(body[start:])
+    return bytes(template), refs
+
+
+class Module:
+    def __init__(self, data: bytes):
+        if data[:8] != b"\0asm\1\0\0\0":
+            raise WasmError("not a wasm module")
+        self.types: List[Tuple[bytes, bytes]] = []
+        self.imports: List[Import] = []
+        self.funcs: List[Func] = []
+        self.tables: List[Tuple[int, Optional[int]]] = []
+        self.memories: List[Tuple[int, Optional[int]]] = []
+        self.exports: List[Tuple[str, int, int]] = []
+        self.start: Optional[int] = None
+        self.elems: List[ElemSegment] = []
+        self.data: List[DataSegment] = []
+        self.num_func_imports = 0
+
+        func_types: List[int] = []
+        r = Reader(data, 8)
+        while not r.done():
+            section_id = r.byte()
+            size = r.uleb()
+            s = Reader(data, r.pos, r.pos + size)
+            r.pos += size
+            if section_id == 1:
+                for _ in range(s.uleb()):
+                    if s.byte() != 0x60:
+                        raise WasmError("unsupported type form")
+                    params = s.bytes(s.uleb())
+                    results = s.bytes(s.uleb())
+                    self.types.append((params, results))
+            elif section_id == 2:
+                for _ in range(s.uleb()):
+                    module, field, kind = s.name(), s.name(), s.byte()
+                    type_index = None
+                    if kind == 0:
+                        type_index = s.uleb()
+                        self.funcs.append(Func(self.types[type_index], f"{module}.{field}", b"", []))
+                        self.num_func_imports += 1
+                    elif kind == 1:
+                        s.byte()
+                        self._limits(s)
+                    elif kind == 2:
+                        self._limits(s)
+                    elif kind == 3:
+                        s.byte()
+                        s.byte()
+                    self.imports.append(Import(module, field, kind, type_index))
+            elif section_id == 3:
+                func_types = [s.uleb() for _ in range(s.uleb())]
+            elif section_id == 4:
+                for _ in range(s.uleb()):
+                    s.byte()
+                    self.tables.append(self._limits(s))
+            elif section_id == 5:
+                for _ in range(s.uleb()):
+                    self.memories.append(self._limits(s))
+            elif section_id == 7:
+                for _ in range(s.uleb()):
+                    self.exports.append((s.name(), s.byte(), s.uleb()))
+            elif section_id == 8:
+                self.start = s.uleb()
+            elif section_id == 9:
+                for _ in range(s.uleb()):
+                    self.elems.append(self._elem(s))
+            elif section_id == 10:
+                count = s.uleb()
+                if count != len(func_types):
+                    raise WasmError("function and code section sizes differ")
+                for type_index in func_types:
+                    body_size = s.uleb()
+                    template, refs = split_body(s.bytes(body_size))
+                    self.funcs.append(Func(self.types[type_index], None, template, refs))
+            elif section_id == 11:
+                for _ in range(s.uleb()):
+                    self.data.append(self._data(s))
+
+    @staticmethod
+    def _limits(s: Reader) -> Tuple[int, Optional[int]]:
+        flags = s.byte()
+        initial = s.uleb()
+        return initial, s.uleb() if flags & 1 else None
+
+    @staticmethod
+    def _elem(s: Reader) -> ElemSegment:
+        flags = s.uleb()
+        mode = "declarative" if flags & 3 == 3 else "passive" if flags & 1 else "active"
+        table, offset = 0, None
+        if flags & 2 and not flags & 1:
+            table = s.uleb()
+        if mode == "active":
+            offset, _ = read_const_expr(s)
+        if flags & 3:
+            s.byte()  # elemkind or reftype
+        funcs: List[Optional[int]] = []
+        for _ in range(s.uleb()):
+            if flags & 4:
+                funcs.append(read_const_expr(s)[1])
+            else:
+                funcs.append(s.uleb())
+        return ElemSegment(mode, table, offset, funcs)
+
+    @staticmethod
+    def _data(s: Reader) -> DataSegment:
+        flags = s.uleb()
+        if flags == 1:
+            return DataSegment("passive", 0, None, s.bytes(s.uleb()))
+        memory = s.uleb() if flags == 2 else 0
+        offset, _ = read_const_expr(s)
+        return DataSegment("active", memory, offset, s.bytes(s.uleb()))
+
+    @property
+    def num_defined_funcs(self) -> int:
+        return len(self.funcs) - self.num_func_imports
+
+    def memory_image(self) -> bytearray:
+        """The initial contents of memory 0, up to the last byte written by a data segment."""
+        image = bytearray()
+        for seg in self.data:
+            if seg.mode != "active" or seg.memory != 0:
+                continue
+            end = seg.offset + len(seg.data)
+            if end > len(image):
+                image.extend(bytes(end - len(image)))
+            image[seg.offset : end] = seg.data
+        return image
+
+
+def function_classes(*modules: Module) -> List[List[int]]:
+    """
+    Partitions the functions of all modules into classes of functions that behave the same:
+    imports with the same name and signature, and defined functions with the same signature
+    and body whose called functions are pairwise in the same class. Returns, for each module,
+    the class of each of its functions.
+    """
+    keys = []
+    for m in modules:
+        keys.append([(f.signature, f.import_name, f.template, len(f.refs)) for f in m.funcs])
+    ids: Dict = {}
+    classes = [[ids.setdefault(k, len(ids)) for k in ks] for ks in keys]
+    while True:
+        ids = {}
+        refined = [
+            [
+                ids.setdefault((c[i], tuple(c[j] for j in m.funcs[i].refs)), len(ids))
+                for i in range(len(m.funcs))
+            ]
+            for m, c in zip(modules, classes)
+        ]
+        if len(ids) == len(set(x for c in classes for x in c)):
+            return refined
+        classes = refined
@@ -0,0 +1,14 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] batch_action : public contract {
+   public:
+   using contract::contract;
+
+   [[eosio::action, eosio::batch]]
+   void transfer(name from, name to, uint64_t amount) {}
+
+   [[eosio::action, eosio::batch("quotes")]]
+   uint64_t quote(name user) { return 42; }
+};
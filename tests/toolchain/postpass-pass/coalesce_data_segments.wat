@@ -0,0 +1,13 @@
+;; Data segments are sorted by address, a segment that only rewrites bytes an earlier segment
+;; already writes is dropped and segments that are back to back in memory are merged. "llo" is
+;; dropped, "world" is appended to "hello, " and "apart" stays on its own past the gap. The third
+;; segment in the output is the heap base eosio-pp stores at address 0.
+(module
+  (memory (export "memory") 1)
+  (global $__stack_pointer (mut i32) (i32.const 65536))
+  (global $__heap_base i32 (i32.const 4096))
+  (data (i32.const 2048) "apart")
+  (data (i32.const 1031) "world")
+  (data (i32.const 1024) "hello, ")
+  (data (i32.const 1026) "llo")
+  (func (export "apply") (param i64 i64 i64)))
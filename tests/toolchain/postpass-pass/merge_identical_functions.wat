@@ -0,0 +1,28 @@
+;; Functions whose bodies and signatures are byte-for-byte identical are merged when they are only
+;; called directly: every call to a duplicate is redirected to the first copy and the duplicate is
+;; removed. $inc_c duplicates $inc_a and $twice_b duplicates $twice_a. A function whose address can be
+;; observed keeps it, so that distinct function pointers keep comparing unequal: $inc_b is in the
+;; table and $inc_export is exported, both are kept although they duplicate $inc_a. $inc_i64 has the
+;; same body shape with another signature and is kept.
+(module
+  (type $i32_i32 (func (param i32) (result i32)))
+  (import "env" "prints" (func $prints (param i32)))
+  (memory (export "memory") 1)
+  (global $__stack_pointer (mut i32) (i32.const 65536))
+  (global $__heap_base i32 (i32.const 1024))
+  (table 4 4 funcref)
+  (elem (i32.const 1) $inc_a $inc_b)
+  (func $inc_a (type $i32_i32) local.get 0 i32.const 1 i32.add)
+  (func $inc_b (type $i32_i32) local.get 0 i32.const 1 i32.add)
+  (func $inc_c (type $i32_i32) local.get 0 i32.const 1 i32.add)
+  (func $inc_export (export "inc") (type $i32_i32) local.get 0 i32.const 1 i32.add)
+  (func $inc_i64 (param i64) (result i64) local.get 0 i64.const 1 i64.add)
+  (func $twice_a (type $i32_i32) local.get 0 call $inc_a call $inc_a)
+  (func $twice_b (type $i32_i32) local.get 0 call $inc_a call $inc_a)
+  (func $print (param i32) local.get 0 call $prints)
+  (func (export "apply") (param i64 i64 i64)
+    i32.const 1 call $twice_a drop
+    i32.const 2 call $twice_b drop
+    i64.const 3 call $inc_i64 drop
+    i32.const 4 i32.const 2 call_indirect (type $i32_i32) call $print)
+  (func (export "other") (type $i32_i32) local.get 0 call $inc_c))
@@ -0,0 +1,16 @@
+;; When no function is duplicated or unreachable and no data segments touch, the optimizing passes
+;; must leave the module exactly as eosio-pp --no-optimize writes it.
+(module
+  (type $i32_i32 (func (param i32) (result i32)))
+  (import "env" "prints" (func $prints (param i32)))
+  (memory (export "memory") 1)
+  (global $__stack_pointer (mut i32) (i32.const 65536))
+  (global $__heap_base i32 (i32.const 4096))
+  (table 2 2 funcref)
+  (elem (i32.const 1) $inc)
+  (data (i32.const 1024) "first")
+  (data (i32.const 2048) "second")
+  (func $inc (type $i32_i32) local.get 0 i32.const 1 i32.add)
+  (func $print (param i32) local.get 0 call $prints)
+  (func (export "apply") (param i64 i64 i64)
+    i32.const 1024 i32.const 1 call_indirect (type $i32_i32) call $print))
@@ -0,0 +1,11 @@
+;; The initial memory is lowered to the pages covered by the data segments and the heap base,
+;; and the maximum is left alone. The data here ends in the second page, so without a heap base
+;; past it 2 of the 16 initial pages remain. The suite checks the page count against the heap base
+;; that eosio-pp stores at address 0.
+(module
+  (memory (export "memory") 16 32)
+  (global $__stack_pointer (mut i32) (i32.const 65536))
+  (global $__heap_base i32 (i32.const 8192))
+  (data (i32.const 1024) "first page")
+  (data (i32.const 70000) "second page")
+  (func (export "apply") (param i64 i64 i64)))
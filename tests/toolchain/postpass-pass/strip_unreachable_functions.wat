@@ -0,0 +1,23 @@
+;; Functions and function imports that cannot be reached from an export, the start function or the
+;; table are removed and every remaining function index is renumbered. $dead, $dead_callee and the
+;; prints import that only they use go away. $by_table is only reachable through the table and
+;; $init only as the start function, so both stay.
+(module
+  (type $i64_void (func (param i64)))
+  (import "env" "eosio_assert" (func $eosio_assert (param i32 i32)))
+  (import "env" "prints" (func $prints (param i32)))
+  (import "env" "printi" (func $printi (param i64)))
+  (memory (export "memory") 1)
+  (global $__stack_pointer (mut i32) (i32.const 65536))
+  (global $__heap_base i32 (i32.const 1024))
+  (table 2 2 funcref)
+  (elem (i32.const 1) $by_table)
+  (start $init)
+  (func $init i32.const 1 i32.const 0 call $eosio_assert)
+  (func $dead_callee (param i32) local.get 0 call $prints)
+  (func $dead (param i32) local.get 0 call $dead_callee)
+  (func $by_table (type $i64_void) local.get 0 call $printi)
+  (func $by_apply (type $i64_void) local.get 0 i64.const 1 i64.add call $printi)
+  (func (export "apply") (param i64 i64 i64)
+    local.get 0 call $by_apply
+    local.get 1 i32.const 1 call_indirect (type $i64_void)))
@@ -0,0 +1,14 @@
+;; Data segments lose their leading and trailing zeros and are split around runs of 16 or more
+;; zeros, while shorter zero runs stay inline. A segment holding only zeros is dropped. Memory starts
+;; zeroed, so the initial memory contents must not change. "abc\00\00\00def" and "ghi" are kept,
+;; plus the heap base eosio-pp stores at address 0.
+(module
+  (memory (export "memory") 1)
+  (global $__stack_pointer (mut i32) (i32.const 65536))
+  (global $__heap_base i32 (i32.const 8192))
+  (data (i32.const 1024)
+    "\00\00\00\00abc\00\00\00def"
+    "\00\00\00\00\00\00\00\00\00\00\00\00\00\00\00\00\00\00\00\00"
+    "ghi\00\00")
+  (data (i32.const 4096) "\00\00\00\00\00\00\00\00")
+  (func (export "apply") (param i64 i64 i64)))
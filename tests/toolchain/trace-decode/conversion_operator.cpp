@@ -0,0 +1,26 @@
+// The binary trace map used to be read with operator>>, so a function name with a space in it,
+// like a conversion operator, shifted every later field and broke decoding of the whole map.
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+struct balance {
+   int64_t amount;
+
+   operator bool() const {
+      bool positive = amount > 0;
+      return positive;
+   }
+};
+
+class [[eosio::contract]] conversion_operator : public contract {
+   public:
+   using contract::contract;
+
+   [[eosio::action]]
+   void check(int64_t amount) {
+      balance b{amount};
+      if (b)
+         print("positive");
+   }
+};
@@ -3,7 +3,9 @@
  *  @copyright defined in eosio.cdt/LICENSE.txt
  */
 
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "legacy_tester.hpp"
 #include <eosio/asset.hpp>
@@ -533,6 +535,94 @@ EOSIO_TEST_BEGIN(extended_asset_type_test)
    )
 EOSIO_TEST_END
 
+// Definitions in `eosio.cdt/libraries/eosio/decimal.hpp`
+EOSIO_TEST_BEGIN(decimal_format_test)
+   auto unsigned_str = [](auto v) { char buf[40]; return string(buf, eosio::write_unsigned(buf, v)); };
+   auto signed_str   = [](auto v) { char buf[40]; return string(buf, eosio::write_signed(buf, v)); };
+   auto fixed_str    = [](int64_t v, uint8_t d) { char buf[300]; return string(buf, eosio::write_fixed(buf, v, d)); };
+
+   // write_unsigned / write_signed, across every digit count boundary
+   uint64_t p = 1;
+   for (int i = 0; i < 20; ++i, p *= 10) {
+      CHECK_EQUAL( unsigned_str(p), std::to_string(p) )
+      CHECK_EQUAL( unsigned_str(p - 1), std::to_string(p - 1) )
+      CHECK_EQUAL( signed_str(-int64_t(p / 2)), std::to_string(-int64_t(p / 2)) )
+   }
+   CHECK_EQUAL( unsigned_str(uint8_t{255}), "255" )
+   CHECK_EQUAL( unsigned_str(std::numeric_limits<uint64_t>::max()), "18446744073709551615" )
+   CHECK_EQUAL( signed_str(std::numeric_limits<int64_t>::min()), "-9223372036854775808" )
+   CHECK_EQUAL( signed_str(int8_t{-128}), "-128" )
+   CHECK_EQUAL( unsigned_str(std::numeric_limits<unsigned __int128>::max()), "340282366920938463463374607431768211455" )
+   CHECK_EQUAL( unsigned_str((unsigned __int128)std::numeric_limits<uint64_t>::max() + 1), "18446744073709551616" )
+   CHECK_EQUAL( unsigned_str((unsigned __int128)10000000000000000000ULL * 10000000000000000000ULL), "100000000000000000000000000000000000000" )
+   CHECK_EQUAL( signed_str(std::numeric_limits<__int128>::min()), "-170141183460469231731687303715884105728" )
+
+   // write_fixed and fixed_decimal_size
+   CHECK_EQUAL( fixed_str(0, 0), "0" )
+   CHECK_EQUAL( fixed_str(0, 4), "0.0000" )
+   CHECK_EQUAL( fixed_str(5, 3), "0.005" )
+   CHECK_EQUAL( fixed_str(-5, 3), "-0.005" )
+   CHECK_EQUAL( fixed_str(12345, 4), "1.2345" )
+   CHECK_EQUAL( fixed_str(1230000, 4), "123.0000" )
+   CHECK_EQUAL( fixed_str(std::numeric_limits<int64_t>::min(), 18), "-9.223372036854775808" )
+   CHECK_EQUAL( fixed_str(std::numeric_limits<int64_t>::max(), 19), "0.9223372036854775807" )
+   CHECK_EQUAL( fixed_str(1, 255), "0." + string(254, '0') + "1" )
+   for (uint64_t v : {0ULL, 7ULL, 99ULL, 100ULL, 123456789ULL, 18446744073709551615ULL})
+      for (uint8_t d : {0, 1, 2, 8, 19, 20, 255})
+         for (bool neg : {false, true}) {
+            char buf[300];
+            CHECK_EQUAL( uint32_t(eosio::write_fixed(buf, v, d, neg) - buf), eosio::fixed_decimal_size(v, d, neg) )
+         }
+
+   // write_asset, write_extended_asset and write_symbol match to_string
+   for (int64_t amount : std::initializer_list<int64_t>{0, 1, -1, 10, -99, 1000000, asset_min, asset_max})
+      for (uint8_t precision : {0, 1, 4, 8, 18, 19, 63}) {
+         asset a{amount, symbol{"SYMBOLL", precision}};
+         char  buf[eosio::max_extended_asset_chars];
+         CHECK_EQUAL( string(buf, eosio::write_asset(buf, a)), a.to_string() )
+         CHECK_EQUAL( string(buf, eosio::write_symbol(buf, a.symbol)), a.symbol.to_string() )
+         extended_asset e{a, name{"eosio.token"}};
+         CHECK_EQUAL( string(buf, eosio::write_extended_asset(buf, e)), e.to_string() )
+      }
+   char buf[eosio::max_extended_asset_chars];
+   extended_asset widest{asset{-1LL, symbol{"ZZZZZZZ", 255}}, name{"zzzzzzzzzzzzj"}};
+   CHECK_EQUAL( uint32_t(eosio::write_extended_asset(buf, widest) - buf), eosio::max_extended_asset_chars )
+   CHECK_EQUAL( string(buf, eosio::write_name(buf, name{"a.b.c"})), "a.b.c" )
+   CHECK_EQUAL( string(buf, eosio::write_name(buf, name{})), "" )
+EOSIO_TEST_END
+
+namespace {
+   constexpr uint32_t format_iterations = 100000;
+
+   void decimal_benchmark() {
+      std::vector<asset> assets;
+      for (uint32_t i = 0; i < format_iterations; ++i)
+         assets.push_back(asset{int64_t(i) * 7919 - 50000, symbol{"EOS", 4}});
+
+      size_t total = 0;
+      std::cout << "decimal formatting benchmark, " << format_iterations << " values (cycles)\n";
+      std::cout << "asset::to_string:  " << count_cycles([&] {
+         for (const auto& a : assets)
+            total += a.to_string().size();
+      }) << "\n";
+      std::cout << "write_asset:       " << count_cycles([&] {
+         char buf[eosio::max_asset_chars];
+         for (const auto& a : assets)
+            total += eosio::write_asset(buf, a) - buf;
+      }) << "\n";
+      std::cout << "std::to_string:    " << count_cycles([&] {
+         for (const auto& a : assets)
+            total += std::to_string(a.amount).size();
+      }) << "\n";
+      std::cout << "write_signed:      " << count_cycles([&] {
+         char buf[eosio::max_decimal_chars<int64_t>];
+         for (const auto& a : assets)
+            total += eosio::write_signed(buf, a.amount) - buf;
+      }) << "\n";
+      std::cout << "(" << total << " characters)\n";
+   }
+}
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -542,5 +632,9 @@ int main(int argc, char* argv[]) {
 
    EOSIO_TEST(asset_type_test);
    EOSIO_TEST(extended_asset_type_test);
+   EOSIO_TEST(decimal_format_test);
+   if (verbose) {
+      decimal_benchmark();
+   }
    return has_failed();
 }
@@ -0,0 +1,339 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include "legacy_tester.hpp"
+#include <eosio/chaindb.hpp>
+#include <eosio/intrinsic_stats.hpp>
+#include <eosio/map.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/singleton.hpp>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+using eosio::name;
+namespace chaindb = eosio::chaindb;
+
+namespace {
+   constexpr name self = "chaindbtest"_n;
+
+   struct account_row {
+      uint64_t id;
+      uint64_t owner;
+      int64_t  balance;
+
+      uint64_t primary_key() const { return id; }
+      uint64_t by_owner() const { return owner; }
+
+      EOSLIB_SERIALIZE( account_row, (id)(owner)(balance) )
+   };
+
+   using accounts_table = eosio::multi_index<"accounts"_n, account_row,
+      eosio::indexed_by<"byowner"_n, eosio::const_mem_fun<account_row, uint64_t, &account_row::by_owner>>>;
+
+   struct config_row {
+      uint32_t    version;
+      std::string label;
+
+      EOSLIB_SERIALIZE( config_row, (version)(label) )
+   };
+
+   using config_singleton = eosio::singleton<"config"_n, config_row>;
+   using balances_map     = eosio::kv::map<"balances"_n, uint64_t, int64_t>;
+}
+
+// Definitions in `eosio.cdt/libraries/eosiolib/chaindb/eosio/chaindb.hpp`
+EOSIO_TEST_BEGIN(db_iterator_test)
+   using namespace eosio::internal_use_do_not_use;
+   chaindb::reset();
+   chaindb::start_session();
+   chaindb::set_receiver(self);
+
+   CHECK_EQUAL( db_end_i64(self.value, 1, 2), -1 )
+   int32_t first  = db_store_i64(1, 2, self.value, 10, "a", 1);
+   int32_t second = db_store_i64(1, 2, self.value, 20, "bb", 2);
+   db_store_i64(1, 3, self.value, 15, "c", 1); // neighbouring table
+   int32_t end = db_end_i64(self.value, 1, 2);
+   CHECK_EQUAL( end, -2 )
+   CHECK_EQUAL( db_find_i64(self.value, 1, 2, 10), first )
+   CHECK_EQUAL( db_find_i64(self.value, 1, 2, 11), end )
+   CHECK_EQUAL( db_lowerbound_i64(self.value, 1, 2, 11), second )
+   CHECK_EQUAL( db_upperbound_i64(self.value, 1, 2, 20), end )
+
+   uint64_t primary = 0;
+   CHECK_EQUAL( db_next_i64(first, &primary), second )
+   CHECK_EQUAL( primary, 20u )
+   CHECK_EQUAL( db_next_i64(second, &primary), end )
+   CHECK_EQUAL( db_next_i64(end, &primary), -1 )
+   CHECK_EQUAL( db_previous_i64(end, &primary), second )
+   CHECK_EQUAL( db_previous_i64(first, &primary), -1 )
+
+   char buf[4];
+   CHECK_EQUAL( db_get_i64(second, buf, 0), 2 )
+   CHECK_EQUAL( db_get_i64(second, buf, 1), 1 )
+   CHECK_ASSERT( "could not insert object, most likely a uniqueness constraint was violated",
+                 [] { db_store_i64(1, 2, self.value, 10, "x", 1); } )
+   CHECK_ASSERT( "must specify a valid account to pay for new record", [] { db_store_i64(1, 2, 0, 11, "x", 1); } )
+
+   db_remove_i64(first);
+   CHECK_ASSERT( "dereference of deleted object", [&] { db_get_i64(first, buf, 0); } )
+
+   chaindb::set_receiver("other"_n);
+   CHECK_ASSERT( "db access violation", [&] { db_remove_i64(second); } )
+   chaindb::set_receiver(self);
+
+   uint64_t secondary = 7;
+   int32_t  idx = db_idx64_store(1, 4, self.value, 10, &secondary);
+   secondary    = 5;
+   CHECK_EQUAL( db_idx64_lowerbound(self.value, 1, 4, &secondary, &primary), idx )
+   CHECK_EQUAL( secondary, 7u )
+   CHECK_EQUAL( db_idx64_find_primary(self.value, 1, 4, &secondary, 10), idx )
+   CHECK_EQUAL( db_idx64_next(idx, &primary), db_idx64_end(self.value, 1, 4) )
+
+   uint32_t kv_value_size = 0;
+   CHECK_EQUAL( kv_set(self.value, "\x01k", 2, "value", 5, self.value), 7 )
+   CHECK_EQUAL( kv_get(self.value, "\x01k", 2, kv_value_size), true )
+   CHECK_EQUAL( kv_value_size, 5u )
+   uint32_t kv_it = kv_it_create(self.value, "\x01", 1);
+   CHECK_EQUAL( kv_it_status(kv_it), -2 )
+   CHECK_EQUAL( kv_it_next(kv_it), 0 )
+   CHECK_EQUAL( kv_it_key_compare(kv_it, "\x01k", 2), 0 )
+   CHECK_EQUAL( kv_it_next(kv_it), -2 )
+   CHECK_EQUAL( kv_it_prev(kv_it), 0 )
+   kv_erase(self.value, "\x01k", 2);
+   CHECK_EQUAL( kv_it_status(kv_it), -1 )
+   CHECK_ASSERT( "iterator to erased element", [&] { kv_it_next(kv_it); } )
+   kv_it_destroy(kv_it);
+
+   chaindb::undo_session();
+   CHECK_EQUAL( chaindb::get_usage().tables, 0u )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(multi_index_test)
+   chaindb::reset();
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      for (uint64_t i = 0; i < 10; ++i)
+         accounts.emplace(self, [&](auto& a) {
+            a.id      = i;
+            a.owner   = 100 - i;
+            a.balance = i * 10;
+         });
+   });
+
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      auto           by_owner = accounts.get_index<"byowner"_n>();
+      CHECK_EQUAL( accounts.get(3).balance, 30 )
+      CHECK_EQUAL( by_owner.begin()->id, 9u )
+      CHECK_EQUAL( by_owner.lower_bound(95)->id, 5u )
+
+      accounts.modify(accounts.find(4), self, [](auto& a) { a.owner = 1; });
+      CHECK_EQUAL( by_owner.begin()->id, 4u )
+
+      accounts.erase(accounts.find(0));
+      CHECK_EQUAL( std::distance(accounts.begin(), accounts.end()), 9 )
+      CHECK_EQUAL( std::distance(by_owner.begin(), by_owner.end()), 9 )
+   });
+
+   CHECK_ASSERT( "cannot create objects in table of another contract", [] {
+      chaindb::apply("other"_n, [] {
+         accounts_table accounts(self, self.value);
+         accounts.emplace("other"_n, [](auto& a) { a.id = 100; });
+      });
+   })
+
+   auto usage = chaindb::get_usage();
+   CHECK_EQUAL( usage.rows, 9u )
+   CHECK_EQUAL( usage.secondary_rows, 9u )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(kv_map_test)
+   chaindb::reset();
+   chaindb::apply(self, [] {
+      balances_map balances(self);
+      for (uint64_t i = 0; i < 5; ++i)
+         balances[i] = int64_t(i) * 3;
+      balances.erase(4);
+
+      int64_t total = 0;
+      for (const auto& e : balances)
+         total += e.second();
+      CHECK_EQUAL( total, 18 )
+      CHECK_EQUAL( balances.contains(4), false )
+      CHECK_EQUAL( int64_t(balances.at(3)), 9 )
+   });
+   CHECK_EQUAL( chaindb::get_usage().kv_rows, 4u )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(rollback_test)
+   chaindb::reset();
+   chaindb::apply(self, [] {
+      config_singleton(self, self.value).set({1, "first"}, self);
+   });
+
+   CHECK_ASSERT( "abort action", [] {
+      chaindb::apply(self, [] {
+         config_singleton(self, self.value).set({2, "second"}, self);
+         balances_map(self)[1] = 5;
+         accounts_table(self, self.value).emplace(self, [](auto& a) { a.id = 1; });
+         eosio::check(false, "abort action");
+      });
+   })
+   CHECK_EQUAL( chaindb::session_depth(), 0u )
+
+   chaindb::apply(self, [] {
+      CHECK_EQUAL( config_singleton(self, self.value).get().version, 1u )
+      CHECK_EQUAL( balances_map(self).contains(1), false )
+      CHECK_EQUAL( accounts_table(self, self.value).begin() == accounts_table(self, self.value).end(), true )
+   });
+
+   // an inner session can be undone without losing the writes of the outer one
+   chaindb::start_session();
+   config_singleton(self, self.value).set({3, "outer"}, self);
+   chaindb::start_session();
+   config_singleton(self, self.value).set({4, "inner"}, self);
+   chaindb::undo_session();
+   CHECK_EQUAL( config_singleton(self, self.value).get().label, "outer" )
+   chaindb::undo_session();
+   CHECK_EQUAL( config_singleton(self, self.value).get().label, "first" )
+
+   auto usage = chaindb::get_usage();
+   CHECK_EQUAL( usage.tables, 1u )
+   CHECK_EQUAL( usage.rows, 1u )
+   CHECK_EQUAL( usage.kv_rows, 0u )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(state_digest_test)
+   chaindb::reset();
+   const auto empty = chaindb::state_digest();
+   auto write = [](std::vector<uint64_t> ids) {
+      chaindb::apply(self, [&] {
+         accounts_table accounts(self, self.value);
+         for (auto id : ids)
+            accounts.emplace(self, [&](auto& a) { a.id = id; a.owner = id * 7; a.balance = 1; });
+         balances_map(self)[1] = 5;
+      });
+   };
+   write({1, 2, 3});
+   const auto digest = chaindb::state_digest();
+   CHECK_EQUAL( digest != empty, true )
+
+   // the same rows, written in another order
+   chaindb::reset();
+   write({3, 1, 2});
+   CHECK_EQUAL( chaindb::state_digest(), digest )
+
+   chaindb::start_session();
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      accounts.modify(accounts.get(2), self, [](auto& a) { a.owner = 0; });
+   });
+   CHECK_EQUAL( chaindb::state_digest() != digest, true )
+   chaindb::undo_session();
+   CHECK_EQUAL( chaindb::state_digest(), digest )
+
+   chaindb::reset();
+   CHECK_EQUAL( chaindb::state_digest(), empty )
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosiolib/core/eosio/intrinsic_stats.hpp`
+EOSIO_TEST_BEGIN(intrinsic_stats_test)
+   using eosio::native::intrinsic_stats;
+   chaindb::reset();
+   intrinsic_stats::enable();
+   intrinsic_stats::reset();
+
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      accounts.emplace(self, [](auto& a) { a.id = 1; a.owner = 2; a.balance = 3; });
+      balances_map(self)[1] = 5;
+      eosio::print("abc");
+      eosio::print(uint64_t{42});
+   });
+   chaindb::apply(self, [] {
+      CHECK_EQUAL( accounts_table(self, self.value).get(1).balance, 3 )
+   });
+   intrinsic_stats::enable(false);
+   chaindb::apply(self, [] { accounts_table(self, self.value).get(1); });
+
+   auto store = intrinsic_stats::get("db_store_i64");
+   CHECK_EQUAL( store.calls, 1u )
+   CHECK_EQUAL( store.bytes_in, 24u )
+   CHECK_EQUAL( intrinsic_stats::get("db_idx64_store").calls, 1u )
+   CHECK_EQUAL( intrinsic_stats::get("db_find_i64").calls, 1u )
+   CHECK_EQUAL( intrinsic_stats::get("db_get_i64").bytes_out, 24u )
+   CHECK_EQUAL( intrinsic_stats::get("kv_set").calls, 1u )
+   // each print counts once, under the intrinsic that was called
+   CHECK_EQUAL( intrinsic_stats::get("prints_l").calls, 1u )
+   CHECK_EQUAL( intrinsic_stats::get("prints_l").bytes_in, 3u )
+   CHECK_EQUAL( intrinsic_stats::get("printui").calls, 1u )
+   CHECK_EQUAL( intrinsic_stats::get("db_update_i64").calls, 0u )
+
+   auto json = intrinsic_stats::to_json();
+   CHECK_EQUAL( json.find("\"db_store_i64\":{\"calls\":1,\"bytes_in\":24,") != std::string::npos, true )
+   intrinsic_stats::reset();
+   CHECK_EQUAL( intrinsic_stats::snapshot().empty(), true )
+EOSIO_TEST_END
+
+namespace {
+   void chaindb_benchmark() {
+      constexpr uint64_t rows = 100000;
+      chaindb::reset();
+      std::cout << "chaindb benchmark, " << rows << " rows (cycles)\n";
+      std::cout << "multi_index emplace: " << count_cycles([&] {
+         chaindb::apply(self, [&] {
+            accounts_table accounts(self, self.value);
+            for (uint64_t i = 0; i < rows; ++i)
+               accounts.emplace(self, [&](auto& a) { a.id = i; a.owner = rows - i; a.balance = i; });
+         });
+      }) << "\n";
+      std::cout << "multi_index find:    " << count_cycles([&] {
+         chaindb::apply(self, [&] {
+            accounts_table accounts(self, self.value);
+            for (uint64_t i = 0; i < rows; ++i)
+               accounts.find(i);
+         });
+      }) << "\n";
+      std::cout << "kv::map set:         " << count_cycles([&] {
+         chaindb::apply(self, [&] {
+            balances_map balances(self);
+            for (uint64_t i = 0; i < rows; ++i)
+               balances[i] = int64_t(i);
+         });
+      }) << "\n";
+      std::cout << "rolled back action:  " << count_cycles([&] {
+         try {
+            chaindb::apply(self, [&] {
+               accounts_table accounts(self, self.value);
+               for (uint64_t i = 0; i < rows; ++i)
+                  accounts.modify(accounts.find(i), self, [](auto& a) { ++a.balance; });
+               eosio::check(false, "rollback");
+            });
+         } catch (const std::runtime_error&) {
+         }
+      }) << "\n";
+   }
+}
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(db_iterator_test);
+   EOSIO_TEST(multi_index_test);
+   EOSIO_TEST(kv_map_test);
+   EOSIO_TEST(rollback_test);
+   EOSIO_TEST(state_digest_test);
+   EOSIO_TEST(intrinsic_stats_test);
+   if (verbose) {
+      chaindb_benchmark();
+   }
+   return has_failed();
+}
@@ -0,0 +1,124 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include "legacy_tester.hpp"
+#include <eosio/chaindb.hpp>
+#include <eosio/contract_memory.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/system.hpp>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+using eosio::name;
+using eosio::native::contract_memory;
+namespace chaindb = eosio::chaindb;
+
+namespace {
+   constexpr name self = "memorytest"_n;
+
+   struct account_row {
+      uint64_t id;
+      int64_t  balance;
+
+      uint64_t primary_key() const { return id; }
+
+      EOSLIB_SERIALIZE( account_row, (id)(balance) )
+   };
+
+   using accounts_table = eosio::multi_index<"accounts"_n, account_row>;
+
+   char* volatile escape; // keeps the compiler from eliding the allocations
+
+   // `count` allocations of 1000 bytes, each freed before the next
+   void churn( int count ) {
+      for ( int i = 0; i < count; ++i ) {
+         auto buffer = std::make_unique<char[]>( 1000 );
+         escape      = buffer.get();
+      }
+   }
+}
+
+// Definitions in `eosio.cdt/libraries/eosiolib/contract_memory/eosio/contract_memory.hpp`
+EOSIO_TEST_BEGIN(contract_memory_test)
+   chaindb::reset();
+   contract_memory::enable();
+   contract_memory::reset();
+
+   // rows are the host's and outlive the memory of the action that wrote them
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      for (uint64_t i = 0; i < 100; ++i)
+         accounts.emplace(self, [&](auto& a) { a.id = i; a.balance = 1; });
+   });
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      CHECK_EQUAL( std::distance(accounts.begin(), accounts.end()), 100 )
+   });
+   auto reports = contract_memory::reports();
+   CHECK_EQUAL( reports.size(), 2u )
+   CHECK_EQUAL( reports[0].receiver, self )
+   CHECK_EQUAL( reports[0].completed, true )
+   CHECK_EQUAL( reports[0].allocations > 0, true )
+   CHECK_EQUAL( reports[0].heap_bytes >= reports[0].peak_live_bytes, true )
+
+   // freed memory is only reused after malloc_enable_free; blocks are 1000 bytes rounded up with the header
+   contract_memory::reset();
+   chaindb::apply(self, [] { churn(100); });
+   chaindb::apply(self, [] {
+      eosio::malloc_enable_free();
+      churn(100);
+   });
+   reports = contract_memory::reports();
+   CHECK_EQUAL( reports[0].heap_bytes, 102400u )
+   CHECK_EQUAL( reports[0].peak_live_bytes, 1000u )
+   CHECK_EQUAL( reports[0].live_bytes, 0u )
+   CHECK_EQUAL( reports[0].allocations, 100u )
+   CHECK_EQUAL( reports[0].frees, 100u )
+   CHECK_EQUAL( reports[0].pages, 2u )
+   CHECK_EQUAL( reports[0].page_grows, 1u )
+   CHECK_EQUAL( reports[0].fragmentation > 0.99, true )
+   CHECK_EQUAL( reports[1].heap_bytes, 1024u )
+   CHECK_EQUAL( reports[1].pages, 1u )
+
+   // an action over budget fails and is rolled back
+   contract_memory::set_budget({ .heap_bytes = 64 * 1024 });
+   CHECK_ASSERT( [](std::string msg) { return msg.rfind("memory budget exceeded by memorytest: heap ", 0) == 0; }, [] {
+      chaindb::apply(self, [] {
+         accounts_table(self, self.value).emplace(self, [](auto& a) { a.id = 100; });
+         churn(100);
+      });
+   } )
+   CHECK_EQUAL( contract_memory::reports().back().completed, false )
+   chaindb::apply(self, [] {
+      accounts_table accounts(self, self.value);
+      CHECK_EQUAL( accounts.find(100) == accounts.end(), true )
+   });
+   contract_memory::set_budget({});
+
+   // more than the chain's linear memory
+   CHECK_ASSERT( "failed to allocate pages", [] {
+      chaindb::apply(self, [] {
+         std::vector<char> buffer(contract_memory::chain_max_pages * contract_memory::page_size);
+         escape = buffer.data();
+      });
+   } )
+   CHECK_EQUAL( contract_memory::reports().back().completed, false )
+
+   contract_memory::enable(false);
+   contract_memory::reset();
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(contract_memory_test);
+   return has_failed();
+}
@@ -5,6 +5,10 @@
 
 #include "legacy_tester.hpp"
 #include <eosio/crypto.hpp>
+#include <eosio/crypto_utils.hpp>
+
+#include <string>
+#include <vector>
 
 using eosio::public_key;
 using eosio::signature;
@@ -35,6 +39,163 @@ EOSIO_TEST_BEGIN(signature_type_test)
    CHECK_EQUAL( (signature(std::in_place_index<0>, std::array<char, 65>{})  != signature(std::in_place_index<0>, std::array<char, 65>{})), false )
 EOSIO_TEST_END
 
+namespace {
+   std::string encode_hex( std::string_view in ) {
+      std::string out( eosio::hex_encoded_size(in.size()), '\0' );
+      eosio::hex_encode( {in.data(), in.size()}, {out.data(), out.size()} );
+      return out;
+   }
+
+   std::string encode_base64( std::string_view in ) {
+      std::string out( eosio::base64_encoded_size(in.size()), '\0' );
+      out.resize( eosio::base64_encode( {in.data(), in.size()}, {out.data(), out.size()} ) );
+      return out;
+   }
+
+   int32_t decode_hex( std::string_view in, std::string& out ) {
+      out.assign( in.size() / 2, '\0' );
+      return eosio::hex_decode( in, {out.data(), out.size()} );
+   }
+
+   int32_t decode_base64( std::string_view in, std::string& out ) {
+      out.assign( eosio::base64_decoded_max_size(in.size()), '\0' );
+      int32_t len = eosio::base64_decode( in, {out.data(), out.size()} );
+      out.resize( len < 0 ? 0 : len );
+      return len;
+   }
+
+   std::string pseudo_random_bytes( uint32_t size ) {
+      std::string r( size, '\0' );
+      uint32_t x = 0x9e3779b9;
+      for( auto& c : r ) {
+         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+         c = char(x);
+      }
+      return r;
+   }
+
+   // the codecs as they were before the table driven versions, used as the benchmark baseline
+   namespace baseline {
+      std::string base64_decode( std::string_view encoded_string ) {
+         int in_len = encoded_string.size();
+         int i = 0;
+         int in_ = 0;
+         unsigned char char_array_4[4], char_array_3[3];
+         std::string ret;
+         while( in_len-- && encoded_string[in_] != '=' ) {
+            if( !(isalnum(encoded_string[in_]) || encoded_string[in_] == '+' || encoded_string[in_] == '/') ) {
+               return "";
+            }
+            char_array_4[i++] = encoded_string[in_]; in_++;
+            if( i == 4 ) {
+               for( i = 0; i < 4; i++ ) {
+                  char_array_4[i] = eosio::detail::base64_lookup[char_array_4[i]];
+               }
+               char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
+               char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
+               char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+               for( i = 0; i < 3; i++ ) {
+                  ret += char_array_3[i];
+               }
+               i = 0;
+            }
+         }
+         if( i ) {
+            for( int j = i; j < 4; j++ ) {
+               char_array_4[j] = 0;
+            }
+            for( int j = 0; j < 4; j++ ) {
+               char_array_4[j] = eosio::detail::base64_lookup[char_array_4[j]];
+            }
+            char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
+            char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
+            for( int j = 0; j < i - 1; j++ ) {
+               ret += char_array_3[j];
+            }
+         }
+         return ret;
+      }
+
+      std::string to_hex( const char* d, uint32_t s ) {
+         std::string r;
+         const char* to_hex = "0123456789abcdef";
+         uint8_t* c = (uint8_t*)d;
+         for( uint32_t i = 0; i < s; ++i ) {
+            (r += to_hex[(c[i]>>4)]) += to_hex[(c[i] &0x0f)];
+         }
+         return r;
+      }
+   }
+
+   template <typename F>
+   uint64_t cycles_per_kb( uint32_t size, F&& f ) {
+      const uint32_t rounds = size >= 256*1024 ? 4 : 64;
+      return count_cycles( f, rounds ) / rounds / (size / 1024);
+   }
+
+   void codec_benchmark() {
+      std::cout << "codec benchmark (cycles per KiB of raw data): size, hex_encode, to_hex, base64_decode(span), base64_decode(string)\n";
+      for( uint32_t size = 1024; size <= 1024*1024; size *= 4 ) {
+         const std::string raw = pseudo_random_bytes( size );
+         const std::string b64 = encode_base64( raw );
+         std::string hex( eosio::hex_encoded_size(size), '\0' );
+         std::string bin( eosio::base64_decoded_max_size(b64.size()), '\0' );
+
+         uint64_t hex_new = cycles_per_kb( size, [&] { eosio::hex_encode( {raw.data(), raw.size()}, {hex.data(), hex.size()} ); } );
+         uint64_t hex_old = cycles_per_kb( size, [&] { hex = baseline::to_hex( raw.data(), raw.size() ); } );
+         uint64_t b64_new = cycles_per_kb( size, [&] { eosio::base64_decode( b64, {bin.data(), bin.size()} ); } );
+         uint64_t b64_old = cycles_per_kb( size, [&] { bin = baseline::base64_decode( b64 ); } );
+         std::cout << size << ", " << hex_new << ", " << hex_old << ", " << b64_new << ", " << b64_old << "\n";
+      }
+   }
+}
+
+// Definitions in `eosio.cdt/libraries/eosio/crypto_utils.hpp`
+EOSIO_TEST_BEGIN(codec_test)
+   // RFC 4648 test vectors
+   CHECK_EQUAL( encode_base64(""), "" )
+   CHECK_EQUAL( encode_base64("f"), "Zg==" )
+   CHECK_EQUAL( encode_base64("fo"), "Zm8=" )
+   CHECK_EQUAL( encode_base64("foo"), "Zm9v" )
+   CHECK_EQUAL( encode_base64("foob"), "Zm9vYg==" )
+   CHECK_EQUAL( encode_base64("fooba"), "Zm9vYmE=" )
+   CHECK_EQUAL( encode_base64("foobar"), "Zm9vYmFy" )
+   CHECK_EQUAL( encode_hex("foobar"), "666f6f626172" )
+
+   std::string out;
+   CHECK_EQUAL( decode_base64("Zm9vYg==", out), 4 )
+   CHECK_EQUAL( out, "foob" )
+   CHECK_EQUAL( decode_base64("Zm9vYmE", out), 5 )
+   CHECK_EQUAL( out, "fooba" )
+   CHECK_EQUAL( decode_base64("Zm9vYmFy", out), 6 )
+   CHECK_EQUAL( out, "foobar" )
+   CHECK_EQUAL( decode_hex("666F6f626172", out), 6 )
+   CHECK_EQUAL( out, "foobar" )
+
+   // malformed input
+   CHECK_EQUAL( decode_base64("Zm9vY", out), -1 )
+   CHECK_EQUAL( decode_base64("Zm9v?mFy", out), -1 )
+   CHECK_EQUAL( decode_base64("Zm=vYmFy", out), -1 )
+   CHECK_EQUAL( decode_base64("Zm9vYmF\x80", out), -1 )
+   CHECK_EQUAL( decode_hex("666f6", out), -1 )
+   CHECK_EQUAL( decode_hex("666f6g", out), -1 )
+   CHECK_EQUAL( decode_hex("66\xb0" "f6f", out), -1 )
+   CHECK_EQUAL( eosio::base64_decode(std::string_view("Zm9v?mFy")), "" )
+
+   // round trips across block boundaries, checked against the previous implementations
+   for( uint32_t size = 0; size < 70; ++size ) {
+      const std::string raw = pseudo_random_bytes( size );
+      const std::string b64 = encode_base64( raw );
+      const std::string hex = encode_hex( raw );
+      CHECK_EQUAL( hex, baseline::to_hex(raw.data(), raw.size()) )
+      CHECK_EQUAL( baseline::base64_decode(b64), raw )
+      CHECK_EQUAL( decode_base64(b64, out), int32_t(size) )
+      CHECK_EQUAL( out, raw )
+      CHECK_EQUAL( decode_hex(hex, out), int32_t(size) )
+      CHECK_EQUAL( out, raw )
+   }
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -44,5 +205,9 @@ int main(int argc, char* argv[]) {
 
    EOSIO_TEST(public_key_type_test)
    EOSIO_TEST(signature_type_test)
+   EOSIO_TEST(codec_test)
+   if( verbose ) {
+      codec_benchmark();
+   }
    return has_failed();
 }
@@ -1,9 +1,19 @@
 #include "legacy_tester.hpp"
+#include <eosio/intrinsic_stats.hpp>
 #include <exception>
 #include <inttypes.h>
 
 eosio::cdt::output_stream std_out;
 
+extern "C" bool ___disable_output;
+
+// shared by the print intrinsics, so that each print is counted once in the intrinsic stats
+static void put_output(const char* cs, uint32_t l) {
+    std_out.put({cs, l});
+    if (!___disable_output)
+        std::cout << std::string_view(cs, l);
+}
+
 extern "C" {
 
 bool ___disable_output;
@@ -11,19 +21,25 @@ bool ___has_failed;
 bool ___earlier_unit_test_has_failed;
 
 void eosio_assert(uint32_t test, const char* msg) {
+   EOSIO_INTRINSIC_STATS("eosio_assert", 4);
    if (test == 0) {
+      eosio::flush_print();
       throw std::runtime_error(msg);
    }
 }
 
 void eosio_assert_message(uint32_t test, const char* msg, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("eosio_assert_message", 4 + len);
    if (test == 0) {
+      eosio::flush_print();
       throw std::runtime_error({msg, len});
    }
 }
 
 void eosio_assert_code(uint32_t test, uint64_t code) {
+   EOSIO_INTRINSIC_STATS("eosio_assert_code", 12);
    if (test == 0) {
+      eosio::flush_print();
       char buff[32];
       snprintf(buff, 32, "%" PRIu64, code);
       throw std::runtime_error(buff);
@@ -32,45 +48,53 @@ void eosio_assert_code(uint32_t test, uint64_t code) {
 
 // preset the print functions
 void prints_l(const char* cs, uint32_t l) { 
-    std_out.put({cs, l});
-    if (!___disable_output)
-        std::cout << std::string_view(cs, l);
+    EOSIO_INTRINSIC_STATS("prints_l", l);
+    put_output(cs, l);
 }
 
-void prints(const char* cs) { prints_l(cs, strlen(cs)); }
+void prints(const char* cs) {
+   EOSIO_INTRINSIC_STATS("prints", strlen(cs));
+   put_output(cs, strlen(cs));
+}
 
 void printi(int64_t v) {
+   EOSIO_INTRINSIC_STATS("printi", 8);
    char buf[32];
    int  l = sprintf(buf, "%" PRId64, v);
-   prints_l(buf, l);
+   put_output(buf, l);
 }
 
 void printui(uint64_t v) {
+   EOSIO_INTRINSIC_STATS("printui", 8);
    char buf[32];
    int  l = sprintf(buf, "%" PRIu64, v);
-   prints_l(buf, l);
+   put_output(buf, l);
 };
 
 void printi128(const int128_t* v) {
+   EOSIO_INTRINSIC_STATS("printi128", 16);
    char buf[128];
    int* tmp = (int*)v;
    int  l   = sprintf(buf, "0x%04x%04x%04x%04x", tmp[0], tmp[1], tmp[2], tmp[3]);
-   prints_l(buf, l);
+   put_output(buf, l);
 }
 
 void printui128(const uint128_t* v) {
+   EOSIO_INTRINSIC_STATS("printui128", 16);
    char buf[128];
    int* tmp = (int*)v;
    int  l   = sprintf(buf, "0x%04x%04x%04x%04x", tmp[0], tmp[1], tmp[2], tmp[3]);
-   prints_l(buf, l);
+   put_output(buf, l);
 }
 
 void  printn(uint64_t nm) {
+   EOSIO_INTRINSIC_STATS("printn", 8);
    std::string s = eosio::name(nm).to_string();
-   prints_l(s.c_str(), s.length());
+   put_output(s.c_str(), s.length());
 }
 
 void printhex(const void* data, uint32_t len) {
+   EOSIO_INTRINSIC_STATS("printhex", len);
    constexpr static uint32_t max_stack_buffer_size = 512;
    const char*               hex_characters        = "0123456789abcdef";
 
@@ -89,7 +113,7 @@ void printhex(const void* data, uint32_t len) {
       ++b;
    }
 
-   prints_l(reinterpret_cast<const char*>(buffer), buffer_size);
+   put_output(reinterpret_cast<const char*>(buffer), buffer_size);
 
    if (max_stack_buffer_size < buffer_size)
       free(buffer);
@@ -14,6 +14,15 @@ inline bool has_failed() {
    return ___has_failed;
 }
 
+// Cycles taken by `rounds` calls of `f`, for the benchmarks the unit tests print when run with -v.
+template <typename F>
+inline uint64_t count_cycles(F&& f, uint32_t rounds = 1) {
+   uint64_t start = __builtin_readcyclecounter();
+   for (uint32_t i = 0; i < rounds; ++i)
+      f();
+   return __builtin_readcyclecounter() - start;
+}
+
 namespace eosio { namespace cdt {
    struct output_stream {
       char output[1024*2];
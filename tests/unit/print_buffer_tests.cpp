@@ -0,0 +1,59 @@
+#define EOSIO_BUFFERED_PRINT
+#include "legacy_tester.hpp"
+#include <eosio/tester.hpp>
+
+template <typename... Args>
+void print_and_flush(Args&&... args) {
+   eosio::print(std::forward<Args>(args)...);
+   eosio::flush_print();
+}
+
+EOSIO_TEST_BEGIN(print_buffer_test)
+   CHECK_PRINT("held27xyz", [](){
+      eosio::print("held", 27, std::string_view{"xyz"});
+      CHECK_EQUAL(std_out.index, 0u);
+      eosio::flush_print();
+   });
+   CHECK_PRINT("27", [](){ print_and_flush((uint8_t)27); });
+   CHECK_PRINT("-202", [](){ print_and_flush((int)-202); });
+   CHECK_PRINT("18446744073709551615", [](){ print_and_flush(std::numeric_limits<uint64_t>::max()); });
+   CHECK_PRINT("-9223372036854775808", [](){ print_and_flush(std::numeric_limits<int64_t>::min()); });
+   CHECK_PRINT("102", [](){ print_and_flush((uint128_t)102); });
+   CHECK_PRINT("-102", [](){ print_and_flush((int128_t)-102); });
+   CHECK_PRINT("truefalse", [](){ print_and_flush(true, false); });
+   CHECK_PRINT("a", [](){ print_and_flush('a'); });
+   CHECK_PRINT("1.5", [](){ print_and_flush(1.5); });
+   CHECK_PRINT("eosio.token", [](){ print_and_flush("eosio.token"_n); });
+   CHECK_PRINT("", [](){ print_and_flush(eosio::name{}); });
+   CHECK_PRINT("00ff10", [](){ const unsigned char data[] = {0x00, 0xff, 0x10}; eosio::printhex(data, sizeof(data)); eosio::flush_print(); });
+   CHECK_PRINT("id=7 owner=alice done", [](){ eosio::print_f("id=% owner=% done", 7, "alice"_n); eosio::flush_print(); });
+   CHECK_PRINT("hello 1 2 3", [](){ print_and_flush("hello ", 1, " ", 2, " ", 3); });
+
+   // output larger than the buffer is flushed as it fills and nothing is lost
+   CHECK_PRINT([](std::string){ return std_out.index == 1500 && std_out.to_string().find_first_not_of('x') == std::string::npos; },
+               [](){ for (int i = 0; i < 150; ++i) eosio::print("xxxxxxxxxx"); eosio::flush_print(); });
+   CHECK_PRINT([](std::string){ return std_out.index == 1500; },
+               [](){ eosio::print(std::string(1500, 'y')); });
+
+   // pending output reaches the console before an assertion aborts the action
+   CHECK_PRINT("assert", [](){
+      CHECK_ASSERT("failed", [](){ eosio::print("assert"); eosio::check(false, "failed"); });
+   });
+   CHECK_PRINT("assert_message", [](){
+      CHECK_ASSERT("failed", [](){ eosio::print("assert_message"); eosio::check(false, std::string("failed")); });
+   });
+   CHECK_PRINT("assert_code", [](){
+      CHECK_ASSERT("7", [](){ eosio::print("assert_code"); eosio::check(false, uint64_t(7)); });
+   });
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(print_buffer_test);
+   return has_failed();
+}
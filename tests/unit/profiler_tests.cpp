@@ -0,0 +1,99 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include "legacy_tester.hpp"
+#include <eosio/profiler.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using eosio::name;
+namespace profiler = eosio::native::profiler;
+
+extern "C" void eosio_profile_action_begin(uint64_t receiver, uint64_t code, uint64_t action);
+extern "C" void eosio_profile_action_end();
+
+// External linkage, so the functions are exported and the profile can name them
+namespace profiled {
+   volatile uint64_t sink = 0;
+
+   __attribute__((noinline)) void add_balance(int n) {
+      for (int i = 0; i < n; ++i)
+         sink = sink + i;
+   }
+
+   __attribute__((noinline)) void fail_transfer() {
+      add_balance(10);
+      throw std::runtime_error("overdrawn balance");
+   }
+
+   __attribute__((noinline)) void settle() { add_balance(100); }
+
+   __attribute__((noinline)) void transfer() {
+      add_balance(100);
+      try {
+         fail_transfer();
+      } catch (...) {
+      }
+      settle();
+   }
+} // namespace profiled
+
+namespace {
+   bool has_line(const std::string& folded, const std::string& stack) {
+      return ("\n" + folded).find("\n" + stack + " ") != std::string::npos;
+   }
+
+   bool contains(const std::string& s, const std::string& part) { return s.find(part) != std::string::npos; }
+}
+
+// Definitions in `eosio.cdt/libraries/eosiolib/profiler/eosio/profiler.hpp`
+EOSIO_TEST_BEGIN(profiler_test)
+   profiler::enable();
+   profiler::reset();
+   for (int i = 0; i < 3; ++i) {
+      profiler::action_scope scope("transfer"_n);
+      profiled::transfer();
+   }
+   eosio_profile_action_begin("bob"_n.value, "eosio.token"_n.value, "transfer"_n.value);
+   profiled::add_balance(5);
+   eosio_profile_action_end();
+   profiler::enable(false);
+   profiled::add_balance(5);
+
+   std::string unit = profiler::counter_unit();
+   CHECK_EQUAL( unit == "instructions" || unit == "ns", true )
+
+   // the exception thrown by fail_transfer skips its exit hook; the frame is closed when settle is entered
+   auto folded = profiler::to_folded();
+   CHECK_EQUAL( has_line(folded, "transfer;profiled::transfer();profiled::add_balance(int)"), true )
+   CHECK_EQUAL( has_line(folded, "transfer;profiled::transfer();profiled::fail_transfer();profiled::add_balance(int)"), true )
+   CHECK_EQUAL( has_line(folded, "transfer;profiled::transfer();profiled::settle();profiled::add_balance(int)"), true )
+   CHECK_EQUAL( contains(folded, "fail_transfer();profiled::settle()"), false )
+   CHECK_EQUAL( has_line(folded, "eosio.token::transfer;profiled::add_balance(int)"), true )
+   CHECK_EQUAL( contains(folded, "fail_transfer();profiled::add_balance(int);"), false )
+
+   auto json = profiler::to_json();
+   CHECK_EQUAL( contains(json, "\"transfer\":{\"calls\":3,"), true )
+   CHECK_EQUAL( contains(json, "\"eosio.token::transfer\":{\"calls\":1,"), true )
+   CHECK_EQUAL( contains(json, "{\"name\":\"profiled::transfer()\",\"calls\":3,"), true )
+   CHECK_EQUAL( contains(json, "{\"name\":\"profiled::fail_transfer()\",\"calls\":3,"), true )
+   CHECK_EQUAL( contains(json, "{\"name\":\"profiled::settle()\",\"calls\":3,"), true )
+   CHECK_EQUAL( contains(json, "{\"name\":\"profiled::add_balance(int)\",\"calls\":9,"), true )
+
+   profiler::reset();
+   CHECK_EQUAL( profiler::to_folded(), "" )
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(profiler_test);
+   return has_failed();
+}
@@ -7,6 +7,7 @@
 #include <eosio/rope.hpp>
 #include <eosio/tester.hpp>
 #include <string>
+#include <vector>
 
 EOSIO_TEST_BEGIN(rope_test)
    eosio::rope r("test string 0");
@@ -63,6 +64,115 @@ EOSIO_TEST_BEGIN(rope_test)
    }
 EOSIO_TEST_END
 
+namespace {
+   constexpr uint32_t json_rows = 100000 / 4;   // four fragments per row, 100k fragments in total
+
+   std::vector<std::string> make_ids() {
+      std::vector<std::string> ids;
+      for (uint32_t i = 0; i < json_rows; ++i)
+         ids.push_back(std::to_string(i));
+      return ids;
+   }
+
+   std::string json_with_string(const std::vector<std::string>& ids) {
+      std::string out = "{\"rows\":[";
+      for (const auto& id : ids) {
+         out += "{\"id\":";
+         out += id;
+         out += ",\"name\":\"benchmark row\"}";
+         out += ",";
+      }
+      out += "]}";
+      return out;
+   }
+
+   std::string json_with_rope(const std::vector<std::string>& ids) {
+      eosio::rope r("{\"rows\":[");
+      for (const auto& id : ids) {
+         r += "{\"id\":";
+         r += id.c_str();
+         r += ",\"name\":\"benchmark row\"}";
+         r += ",";
+      }
+      r += "]}";
+      char* flat = r.c_str();
+      std::string out(flat, r.length());
+      delete[] flat;
+      return out;
+   }
+
+   std::string json_with_builder(const std::vector<std::string>& ids) {
+      eosio::rope_builder b;
+      b += "{\"rows\":[";
+      for (const auto& id : ids) {
+         b += "{\"id\":";
+         b += id;
+         b += ",\"name\":\"benchmark row\"}";
+         b += ",";
+      }
+      b += "]}";
+      return b.str();
+   }
+
+   void rope_benchmark() {
+      const auto ids = make_ids();
+      std::cout << "rope benchmark, " << json_rows * 4 << " fragment JSON response (cycles)\n";
+      std::cout << "std::string:  " << count_cycles([&] { json_with_string(ids); }) << "\n";
+      std::cout << "rope:         " << count_cycles([&] { json_with_rope(ids); }) << "\n";
+      std::cout << "rope_builder: " << count_cycles([&] { json_with_builder(ids); }) << "\n";
+   }
+}
+
+EOSIO_TEST_BEGIN(rope_builder_test)
+   eosio::rope_builder b;
+   REQUIRE_EQUAL(b.length(), 0);
+   REQUIRE_EQUAL(b.str(), std::string());
+
+   // an empty copy on a builder without copy chunks yet adds nothing
+   b.append_copy("");
+   REQUIRE_EQUAL(b.length(), 0);
+   REQUIRE_EQUAL(b.fragments(), 0);
+
+   std::string expected;
+   for (int i = 0; i < 1000; ++i) {
+      b += "fragment ";
+      b.append_copy(std::to_string(i));
+      b += std::string_view(", ", 2);
+      expected += "fragment " + std::to_string(i) + ", ";
+   }
+   b += "";
+   REQUIRE_EQUAL(b.length(), expected.size());
+   REQUIRE_EQUAL(b.fragments(), 3000);
+   REQUIRE_EQUAL(b.str(), expected);
+
+   // flattening leaves the builder untouched, so it can be flattened again or appended to
+   std::string flat(b.length(), '\0');
+   b.flatten(flat.data());
+   REQUIRE_EQUAL(flat, expected);
+   b += "end";
+   REQUIRE_EQUAL(b.str(), expected + "end");
+
+   eosio::rope_builder moved(std::move(b));
+   REQUIRE_EQUAL(moved.str(), expected + "end");
+   REQUIRE_EQUAL(b.length(), 0);
+
+   // a large copy gets a chunk of its own
+   std::string large(3 * eosio::rope_builder::copy_chunk_size, 'x');
+   eosio::rope_builder c;
+   c.append_copy("a").append_copy(large).append_copy("b");
+   REQUIRE_EQUAL(c.str(), "a" + large + "b");
+
+   const auto ids = make_ids();
+   REQUIRE_EQUAL(json_with_builder(ids), json_with_string(ids));
+   REQUIRE_EQUAL(json_with_rope(ids), json_with_string(ids));
+
+   // string literal appends exclude the terminator
+   eosio::rope r("ab");
+   r.append("cd");
+   REQUIRE_EQUAL(r.length(), 4);
+   REQUIRE_EQUAL(std::string(r.c_str()), "abcd");
+EOSIO_TEST_END
+
 int main(int argc, char** argv) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -71,5 +181,9 @@ int main(int argc, char** argv) {
    silence_output(!verbose);
 
    EOSIO_TEST(rope_test);
+   EOSIO_TEST(rope_builder_test);
+   if (verbose) {
+      rope_benchmark();
+   }
    return has_failed();
 }
@@ -1,6 +1,9 @@
 #include <eosio/eosio.hpp>
 #include <eosio/crypto.hpp>
 
+#include <memory>
+#include <vector>
+
 class [[eosio::contract]] ecdsa_verify_test : public eosio::contract {
 public:
    using eosio::contract::contract;
@@ -24,4 +27,23 @@ public:
       res = eosio::verify_ecdsa_sig(msg, sig, pubkey);
       eosio::check(res, "verify_ecdsa_sig() failed for string input");
    }
+
+   [[eosio::action]]
+   void verifybatch(const std::vector<std::string>& msgs, const std::vector<std::string>& sigs, const std::string& pubkey)
+   {
+      eosio::check(msgs.size() == sigs.size(), "msgs and sigs differ in size");
+      std::vector<eosio::ecdsa_sig_item> items;
+      for (size_t i = 0; i < msgs.size(); ++i) {
+         items.push_back({msgs[i], sigs[i], pubkey});
+      }
+
+      auto results = std::make_unique<bool[]>(items.size());
+      bool all = eosio::verify_ecdsa_sigs(items, {results.get(), items.size()});
+      for (size_t i = 0; i < items.size(); ++i) {
+         eosio::check(results[i] == eosio::verify_ecdsa_sig(msgs[i], sigs[i], pubkey), "verify_ecdsa_sigs() result mismatch");
+      }
+
+      eosio::check(eosio::verify_ecdsa_sigs(items) == all, "verify_ecdsa_sigs() result mismatch");
+      eosio::check(all, "verify_ecdsa_sigs() failed");
+   }
 };
@@ -0,0 +1,68 @@
+#include <eosio/eosio.hpp>
+#include <eosio/merkle.hpp>
+#include <eosio/singleton.hpp>
+
+class [[eosio::contract]] merkle_tests : public eosio::contract {
+public:
+   using eosio::contract::contract;
+
+   [[eosio::action]]
+   void append(const std::vector<eosio::checksum256>& leaves)
+   {
+      accumulator_table acc(get_self(), get_self().value);
+      auto state = acc.get_or_default();
+      for (const auto& leaf : leaves) {
+         state.append(leaf);
+      }
+      acc.set(state, get_self());
+   }
+
+   [[eosio::action]]
+   void checkroot(uint64_t count, const eosio::checksum256& root)
+   {
+      accumulator_table acc(get_self(), get_self().value);
+      auto state = acc.get_or_default();
+      eosio::check(state.count == count, "incremental_merkle count mismatch");
+      eosio::check(state.root() == root, "incremental_merkle root mismatch");
+   }
+
+   [[eosio::action]]
+   eosio::checksum256 batchroot(const std::vector<eosio::checksum256>& leaves)
+   {
+      return eosio::merkle_root(leaves);
+   }
+
+   // the hand-rolled pattern merkle_root replaces, kept as the benchmark baseline
+   [[eosio::action]]
+   eosio::checksum256 naiveroot(const std::vector<eosio::checksum256>& leaves)
+   {
+      if (leaves.empty()) {
+         return {};
+      }
+      std::vector<eosio::checksum256> level;
+      for (const auto& leaf : leaves) {
+         std::vector<char> prefixed{0x00};
+         auto bytes = leaf.extract_as_byte_array();
+         prefixed.insert(prefixed.end(), bytes.begin(), bytes.end());
+         level.push_back(eosio::sha256(prefixed.data(), prefixed.size()));
+      }
+      while (level.size() > 1) {
+         std::vector<eosio::checksum256> next;
+         for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            std::vector<char> pair{0x01};
+            auto left = level[i].extract_as_byte_array();
+            auto right = level[i + 1].extract_as_byte_array();
+            pair.insert(pair.end(), left.begin(), left.end());
+            pair.insert(pair.end(), right.begin(), right.end());
+            next.push_back(eosio::sha256(pair.data(), pair.size()));
+         }
+         if (level.size() % 2) {
+            next.push_back(level.back());
+         }
+         level = std::move(next);
+      }
+      return level[0];
+   }
+
+   using accumulator_table = eosio::singleton<"merkle"_n, eosio::incremental_merkle>;
+};
@@ -25,6 +25,11 @@ class [[eosio::contract]] pb_msg_test : public eosio::contract {
       return {};
    }
 
+   [[eosio::action, eosio::batch]] int32_t count(const eosio::pb<ActData>& msg) {
+      eosio::check(msg.note == "abc", "validate msg.note");
+      return msg.id;
+   }
+
 };
 } // namespace test
 
@@ -131,6 +131,40 @@ public:
      }
      return ret;
    }
+   // rows used by the query throughput benchmark
+   [[eosio::action]]
+   void fill(uint32_t first_id, uint32_t count) {
+      my_table_f tf{get_self()};
+      for (uint32_t id = first_id; id < first_id + count; ++id) {
+         tf.put({
+         .id = id,
+         .name = "Benchmark Row",
+         .gender = 0,
+         .age = id % 100
+         }, get_self());
+      }
+   }
+
+   [[eosio::action, eosio::read_only]]
+   std::vector<my_struct> getvec() {
+      my_table_f tf{get_self()};
+      std::vector<my_struct> ret;
+      for (auto itf = tf.id.begin(), itf_e = tf.id.end(); itf != itf_e; ++itf) {
+         ret.push_back(itf.value());
+      }
+      return ret;
+   }
+
+   [[eosio::action, eosio::read_only]]
+   eosio::result_stream<my_struct> getstream() {
+      my_table_f tf{get_self()};
+      eosio::result_stream<my_struct> ret;
+      for (auto itf = tf.id.begin(), itf_e = tf.id.end(); itf != itf_e; ++itf) {
+         ret.push_back(itf.value());
+      }
+      return ret;
+   }
+
    [[eosio::action]]
    // usage: cleos -v push action eosio put '{"id":10,"name":"GULU","gender":1,"age":128}' -p eosio@active
    void put(uint32_t id, std::string name, uint32_t gender, uint32_t age ) {
@@ -1,5 +1,10 @@
 #include <eosio/eosio.hpp>
 #include <eosio/crypto.hpp>
+#include <eosio/crypto_utils.hpp>
+#include <eosio/singleton.hpp>
+
+#include <memory>
+#include <vector>
 
 class [[eosio::contract]] rsa_verify_test : public eosio::contract {
 public:
@@ -34,4 +39,46 @@ public:
       res = eosio::is_supported_rsa_pubkey(pubkey.data(), pubkey.size());
       eosio::check(res, "is_supported_rsa_pubkey() failed for char array input");
    }
+
+   [[eosio::action]]
+   void setkey(const std::string& pubkey)
+   {
+      pubkey_table keys(get_self(), get_self().value);
+      keys.set(eosio::rsa_public_key::from_pem(pubkey), get_self());
+   }
+
+   [[eosio::action]]
+   void verifykey(const std::string& msg, const std::string& sig)
+   {
+      pubkey_table keys(get_self(), get_self().value);
+      std::string sig_bytes = eosio::base64_decode(eosio::strip_newline(sig));
+      bool res = eosio::verify_rsa_sha256_sig(msg.data(), msg.size(), sig_bytes.data(), sig_bytes.size(), keys.get());
+      eosio::check(res, "verify_rsa_sha256_sig() failed for rsa_public_key input");
+   }
+
+   [[eosio::action]]
+   void verifybatch(const std::vector<std::string>& msgs, const std::vector<std::string>& sigs, const std::string& pubkey)
+   {
+      eosio::check(msgs.size() == sigs.size(), "msgs and sigs differ in size");
+      const auto key = eosio::rsa_public_key::from_pem(pubkey);
+      std::vector<std::string> sig_bytes;
+      std::vector<eosio::rsa_sig_item> items;
+      for (const auto& sig : sigs) {
+         sig_bytes.push_back(eosio::base64_decode(eosio::strip_newline(sig)));
+      }
+      for (size_t i = 0; i < msgs.size(); ++i) {
+         items.push_back({msgs[i], sig_bytes[i], &key});
+      }
+
+      auto results = std::make_unique<bool[]>(items.size());
+      bool all = eosio::verify_rsa_sha256_sigs(items, {results.get(), items.size()});
+      for (size_t i = 0; i < items.size(); ++i) {
+         eosio::check(results[i] == eosio::verify_rsa_sha256_sig(msgs[i], sigs[i], pubkey), "verify_rsa_sha256_sigs() result mismatch");
+      }
+
+      eosio::check(eosio::verify_rsa_sha256_sigs(items) == all, "verify_rsa_sha256_sigs() result mismatch");
+      eosio::check(all, "verify_rsa_sha256_sig() failed for batch input");
+   }
+
+   using pubkey_table = eosio::singleton<"pubkey"_n, eosio::rsa_public_key>;
 };
@@ -17,4 +17,10 @@ using namespace eosio;
 
 [[eosio::action]] void tester_tests::assertsig(eosio::checksum256 digest, eosio::signature sig, eosio::public_key pub) {
    assert_recover_key(digest, sig, pub);
+
+   const auto packed_sig = eosio::pack(sig);
+   const auto packed_pub = eosio::pack(pub);
+   assert_recover_key(digest, packed_sig, packed_pub);
+   check(recover_key(digest, packed_sig) == pub, "recover_key mismatch for packed signature");
+   check(recover_key(digest, sig) == pub, "recover_key mismatch");
 }
@@ -35,6 +35,13 @@ void generate_eosio_dispatch(const std::string& output, const std::set<wasm_acti
       ofs << "extern \"C\" {\n";
       ofs << "  __attribute__((import_name(\"eosio_assert_code\"))) void eosio_assert_code(uint32_t, uint64_t);";
       ofs << "  void eosio_set_contract_name(uint64_t n);\n";
+      ofs << "  __attribute__((weak)) void eosio_print_buffer_flush();\n";
+      ofs << "  __attribute__((weak)) void eosio_binary_trace_flush();\n";
+      ofs << "  __attribute__((weak)) void eosio_profile_action_begin(uint64_t, uint64_t, uint64_t);\n";
+      ofs << "  __attribute__((weak)) void eosio_profile_action_end();\n";
+      ofs << "  __attribute__((weak)) void eosio_memory_action_begin(uint64_t, uint64_t, uint64_t);\n";
+      ofs << "  __attribute__((weak)) void eosio_memory_action_end();\n";
+      ofs << "  __attribute__((weak)) void eosio_memory_action_abort();\n";
       for (auto& wa : wasm_actions) {
          ofs << "  void " << wa.handler << "(uint64_t r, uint64_t c);\n";
       }
@@ -44,6 +51,18 @@ void generate_eosio_dispatch(const std::string& output, const std::set<wasm_acti
       ofs << "  __attribute__((export_name(\"apply\"), visibility(\"default\")))\n";
       ofs << "  void apply(uint64_t r, uint64_t c, uint64_t a) {\n";
       ofs << "    eosio_set_contract_name(r);\n";
+      // only resolved when a native contract links eosio::profiler or eosio::contract_memory; the
+      // destructor closes the action when it throws
+      ofs << "    struct action_hooks {\n"
+          << "      action_hooks(uint64_t r, uint64_t c, uint64_t a) {\n"
+          << "        if (eosio_memory_action_begin) eosio_memory_action_begin(r, c, a);\n"
+          << "        if (eosio_profile_action_begin) eosio_profile_action_begin(r, c, a);\n"
+          << "      }\n"
+          << "      ~action_hooks() {\n"
+          << "        if (eosio_profile_action_end) eosio_profile_action_end();\n"
+          << "        if (eosio_memory_action_abort) eosio_memory_action_abort();\n"
+          << "      }\n"
+          << "    } hooks(r, c, a);\n";
       ofs << "    if (c == r) {\n";
       if (wasm_actions.size()) {
          ofs << "      switch (a) {\n";
@@ -83,6 +102,11 @@ void generate_eosio_dispatch(const std::string& output, const std::set<wasm_acti
          ofs << "      }\n";
       }
       ofs << "    }\n";
+      // fails the action if it exceeded its memory budget
+      ofs << "    if (eosio_memory_action_end) eosio_memory_action_end();\n";
+      // only resolved when the contract links the buffered print sink or binary tracing
+      ofs << "    if (eosio_print_buffer_flush) eosio_print_buffer_flush();\n";
+      ofs << "    if (eosio_binary_trace_flush) eosio_binary_trace_flush();\n";
       ofs << "  }\n";
       ofs << "}\n";
       ofs.close();
@@ -121,6 +145,9 @@ bool        verbose                     = false;
 bool        suppress_ricardian_warnings = true;
 bool        is_wasm = false;
 std::string smart_contract_trace_level;
+std::string smart_contract_trace_format;
+std::vector<std::string> smart_contract_trace_functions;
+std::string smart_contract_trace_sample;
 
 
 int exec_subprogram(std::string prog, const std::vector<std::string>& options, bool show_commands) {
@@ -169,6 +196,9 @@ void parse_args(int argc, const char** argv) {
        ("D,defines", "C macros", cxxopts::value<std::string>())
        ("contract", "contract name", cxxopts::value<std::string>(contract_name))
        ("smart-contract-trace-level", "smart contract trace level", cxxopts::value<std::string>(smart_contract_trace_level))
+       ("smart-contract-trace-format", "smart contract trace format, text (default) or binary", cxxopts::value<std::string>(smart_contract_trace_format))
+       ("smart-contract-trace-functions", "only trace functions matching these comma separated globs", cxxopts::value<std::vector<std::string>>(smart_contract_trace_functions))
+       ("smart-contract-trace-sample", "trace N of every M statement checkpoints, as N/M", cxxopts::value<std::string>(smart_contract_trace_sample))
        ("output-dir", "output dirirectory", cxxopts::value<std::string>(output_dir))
        ("version", "display version")
        ("v,verbose", "verbose output", cxxopts::value<bool>(verbose)->default_value("false"))
@@ -267,6 +297,17 @@ void gen_actions(std::string input) {
    }
    if (smart_contract_trace_level.size()) {
       codegen_opts += ",smart-contract-trace-level=" + smart_contract_trace_level;
+   }
+   if (smart_contract_trace_format.size()) {
+      codegen_opts += ",smart-contract-trace-format=" + smart_contract_trace_format;
+   }
+   if (smart_contract_trace_functions.size()) {
+      codegen_opts += ",smart-contract-trace-functions=";
+      for (const auto& glob : smart_contract_trace_functions)
+         codegen_opts += glob + ";";
+   }
+   if (smart_contract_trace_sample.size()) {
+      codegen_opts += ",smart-contract-trace-sample=" + smart_contract_trace_sample;
    }      
 
    local_args.push_back("-Xclang");
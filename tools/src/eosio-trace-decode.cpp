@@ -0,0 +1,232 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cxxopts.hpp>
+
+// Decodes the `cdt.trace` events produced by contracts built with
+// `eosio-codegen --smart-contract-trace-format=binary` back into the text trace format,
+// using the <contract>.cpp.tracemap file written next to the instrumented source.
+// See libraries/eosiolib/contracts/eosio/binary_trace.hpp for the event layout.
+
+struct check_point {
+   std::string kind;
+   std::string location;
+   std::string name;
+};
+
+// Each line of the map is `id<TAB>kind<TAB>file:line:col<TAB>name`; the name is empty for
+// plain statements.
+std::map<uint32_t, check_point> read_trace_map(const std::string& filename) {
+   std::ifstream ifs(filename);
+   if (!ifs)
+      throw std::runtime_error("cannot open " + filename);
+   std::map<uint32_t, check_point> result;
+   std::string                     line;
+   for (size_t line_number = 1; std::getline(ifs, line); ++line_number) {
+      if (!line.empty() && line.back() == '\r')
+         line.pop_back();
+      if (line.empty())
+         continue;
+      auto bad_line = [&] {
+         return std::runtime_error(filename + ":" + std::to_string(line_number) + ": malformed trace map entry");
+      };
+      std::vector<std::string> fields;
+      size_t                   start = 0;
+      while (fields.size() < 3) {
+         size_t tab = line.find('\t', start);
+         if (tab == std::string::npos)
+            throw bad_line();
+         fields.push_back(line.substr(start, tab - start));
+         start = tab + 1;
+      }
+      size_t   digits = 0;
+      uint32_t id     = 0;
+      try {
+         id = std::stoul(fields[0], &digits);
+      } catch (std::exception&) {
+         throw bad_line();
+      }
+      if (digits != fields[0].size())
+         throw bad_line();
+      result[id] = check_point{fields[1], fields[2], line.substr(start)};
+   }
+   return result;
+}
+
+std::vector<uint8_t> read_trace_data(const std::string& filename) {
+   std::ifstream ifs(filename, std::ios::binary);
+   if (!ifs)
+      throw std::runtime_error("cannot open " + filename);
+   std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+   return {content.begin(), content.end()};
+}
+
+std::vector<uint8_t> from_hex(const std::string& hex) {
+   auto nibble = [](char c) -> int {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      throw std::runtime_error("invalid hex digit in trace data");
+   };
+   std::vector<uint8_t> result;
+   std::string digits;
+   for (char c : hex) {
+      if (!isspace(static_cast<unsigned char>(c)))
+         digits.push_back(c);
+   }
+   if (digits.size() % 2)
+      throw std::runtime_error("odd number of hex digits in trace data");
+   for (size_t i = 0; i < digits.size(); i += 2)
+      result.push_back(nibble(digits[i]) << 4 | nibble(digits[i + 1]));
+   return result;
+}
+
+struct trace_reader {
+   const std::vector<uint8_t>& data;
+   size_t                      pos = 0;
+
+   void need(size_t n) const {
+      if (data.size() - pos < n)
+         throw std::runtime_error("truncated trace data");
+   }
+   uint32_t read_u32() {
+      need(4);
+      uint32_t v = 0;
+      for (int i = 0; i < 4; ++i)
+         v |= uint32_t(data[pos++]) << (8 * i);
+      return v;
+   }
+   uint64_t read_u64() {
+      need(8);
+      uint64_t v = 0;
+      for (int i = 0; i < 8; ++i)
+         v |= uint64_t(data[pos++]) << (8 * i);
+      return v;
+   }
+   uint32_t read_varuint32() {
+      uint64_t v     = 0;
+      uint8_t  shift = 0;
+      uint8_t  b;
+      do {
+         need(1);
+         b = data[pos++];
+         v |= uint64_t(b & 0x7f) << shift;
+         shift += 7;
+      } while ((b & 0x80) && shift < 35);
+      return static_cast<uint32_t>(v);
+   }
+};
+
+// Same text as eosio::name::to_string, without linking the contract library.
+std::string name_to_string(uint64_t value) {
+   static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+   std::string str(13, '.');
+   uint64_t tmp = value;
+   for (uint32_t i = 0; i <= 12; ++i) {
+      char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+      str[12 - i] = c;
+      tmp >>= (i == 0 ? 4 : 5);
+   }
+   str.erase(str.find_last_not_of('.') + 1);
+   return str;
+}
+
+std::string format_value(uint32_t kind, uint64_t value) {
+   switch (kind) {
+      case 1: return std::to_string(static_cast<int64_t>(value));
+      case 2: return std::to_string(value);
+      case 3: {
+         double d;
+         memcpy(&d, &value, sizeof(d));
+         std::ostringstream ss;
+         ss << d;
+         return ss.str();
+      }
+      case 4: return name_to_string(value);
+   }
+   return "";
+}
+
+void decode(const std::vector<uint8_t>& data, const std::map<uint32_t, check_point>& map, std::ostream& out) {
+   trace_reader reader{data};
+   uint32_t dropped = reader.read_u32();
+   uint32_t count   = reader.read_varuint32();
+   if (dropped)
+      out << "@(" << dropped << " earlier checkpoints dropped)@";
+
+   bool in_enter = false;
+   for (uint32_t i = 0; i < count; ++i) {
+      uint32_t tag   = reader.read_varuint32();
+      uint32_t id    = tag >> 3;
+      uint32_t kind  = tag & 7;
+      uint64_t value = kind ? reader.read_u64() : 0;
+
+      auto it = map.find(id);
+      if (it == map.end()) {
+         out << "@unknown checkpoint " << id << "@";
+         continue;
+      }
+      const auto& cp = it->second;
+      if (in_enter && cp.kind != "var") {
+         out << ")@";
+         in_enter = false;
+      }
+      if (cp.kind == "enter") {
+         out << "@" << cp.location << "(@" << cp.name;
+         in_enter = true;
+      } else if (cp.kind == "exit") {
+         out << "@" << cp.location.substr(0, cp.location.find(':')) << "(~" << cp.name;
+         if (kind) // function trace level, number of traced calls made by the function
+            out << ":" << format_value(kind, value);
+         out << ")@";
+      } else if (cp.kind == "var") {
+         out << "," << cp.name << (kind ? "=" + format_value(kind, value) : "");
+      } else {
+         out << "@" << cp.location;
+         if (!cp.name.empty())
+            out << "(@" << cp.name << ")";
+         out << "@";
+      }
+   }
+   if (in_enter)
+      out << ")@";
+   out << "\n";
+}
+
+int main(int argc, const char** argv) {
+   cxxopts::Options options(argv[0], "Decoder for binary smart contract traces");
+   std::string              map_file;
+   std::string              data_file;
+   std::vector<std::string> hex_data;
+
+   // clang-format off
+   options.add_options()
+       ("m,map", "checkpoint map generated by eosio-codegen (<contract>.cpp.tracemap)", cxxopts::value<std::string>(map_file))
+       ("f,file", "file holding the raw bytes of a cdt.trace event", cxxopts::value<std::string>(data_file))
+       ("hex", "hex encoded data of cdt.trace events", cxxopts::value<std::vector<std::string>>(hex_data))
+       ("h,help", "Print usage");
+   // clang-format on
+   options.parse_positional("hex");
+
+   try {
+      auto result = options.parse(argc, argv);
+      if (result.count("help") || map_file.empty() || (data_file.empty() && hex_data.empty())) {
+         std::cout << options.help() << std::endl;
+         return result.count("help") ? 0 : 1;
+      }
+
+      auto map = read_trace_map(map_file);
+      if (!data_file.empty())
+         decode(read_trace_data(data_file), map, std::cout);
+      for (const auto& hex : hex_data)
+         decode(from_hex(hex), map, std::cout);
+   } catch (std::exception& e) {
+      std::cerr << e.what() << '\n';
+      return 1;
+   }
+   return 0;
+}
@@ -14,17 +14,23 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <map>
+#include <string_view>
+#include <unordered_map>
 
 #include "src/apply-names.h"
 #include "src/binary-reader.h"
+#include "src/binary-reader-nop.h"
 #include "src/binary-writer.h"
 #include "src/binary-reader-ir.h"
 #include "src/error-formatter.h"
+#include "src/expr-visitor.h"
 #include "src/feature.h"
 #include "src/generate-names.h"
 #include "src/ir.h"
@@ -44,9 +50,12 @@ static Features s_features;
 static WriteBinaryOptions s_write_binary_options;
 static std::unique_ptr<FileStream> s_log_stream;
 static std::string s_profile = "eosio";
+static bool s_optimize = true;
 
 static const char s_description[] =
 R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, and other post processing.
+  Unless --no-optimize is given, functions unreachable from the exports, the start function and the table are removed,
+  functions with identical bodies that are only called directly are merged and duplicate or adjacent data segments are coalesced.
 
   $ eosio-pp test.wasm -o test.stripped.wasm
 
@@ -73,6 +82,9 @@ static void ParseOptions(int argc, char** argv) {
       [](const char* argument) {
         s_profile = argument;
       });
+  parser.AddOption("no-optimize",
+                   "Do not remove unreachable functions, merge identical functions or coalesce data segments",
+                   []() { s_optimize = false; });
   parser.AddArgument("filename", OptionParser::ArgumentCount::One,
                      [](const char* argument) {
                        s_infile = argument;
@@ -95,18 +107,77 @@ uint32_t GetStackPtr( Module& mod, const std::vector<uint8_t>& buff ) {
    return stack_ptr;
 }
 
+bool GetDataSegmentOffset( const DataSegment& ds, uint32_t& offset ) {
+   if (ds.kind != SegmentKind::Active || ds.offset.size() != 1)
+      return false;
+   auto c = dyn_cast<ConstExpr>(&ds.offset.front());
+   if (!c || c->const_.type() != Type::I32)
+      return false;
+   offset = c->const_.u32();
+   return true;
+}
+
+// Zero runs at least this long inside a data segment are cheaper to leave to
+// the zero-initialized memory than to encode, once the extra segment header
+// (memory index, offset expression and size) is accounted for.
+static constexpr size_t s_min_zero_gap = 16;
+
+// Trims leading and trailing zeros from every data segment and splits segments
+// around long runs of zeros. Segments that are entirely zero are dropped.
+// `fix_bytes` accumulates the number of zero bytes no longer stored.
 void StripZeroedData( Module& mod, size_t& fix_bytes ) {
    std::vector<DataSegment*> ds;
    for ( auto DS : mod.data_segments ) {
-      bool isZeroed = true;
-      for ( auto datum : DS->data ) {
-         isZeroed &= datum == 0;
+      const auto& data = DS->data;
+      uint32_t offset;
+      if (!GetDataSegmentOffset(*DS, offset)) {
+         if (std::all_of(data.begin(), data.end(), [](uint8_t b) { return b == 0; })) {
+            fix_bytes += data.size();
+         } else {
+            ds.push_back(DS);
+         }
+         continue;
+      }
+
+      // collect the [begin, end) runs worth keeping
+      std::vector<std::pair<size_t, size_t>> runs;
+      for ( size_t i = 0; i < data.size(); ) {
+         if (data[i] == 0) {
+            i++;
+            continue;
+         }
+         size_t end = i + 1, zeros = 0;
+         for ( size_t j = end; j < data.size() && zeros < s_min_zero_gap; j++ ) {
+            if (data[j] == 0) {
+               zeros++;
+            } else {
+               zeros = 0;
+               end = j + 1;
+            }
+         }
+         runs.emplace_back(i, end);
+         i = end;
       }
-      if (!isZeroed) {
+
+      if (runs.size() == 1 && runs[0].first == 0 && runs[0].second == data.size()) {
          ds.push_back(DS);
-      } else {
-         fix_bytes += DS->data.size();
+         continue;
+      }
+      size_t kept = 0;
+      for ( auto [begin, end] : runs ) {
+         auto field = std::make_unique<DataSegmentModuleField>();
+         DataSegment& seg = field->data_segment;
+         Const c;
+         c.I32(offset + begin);
+         seg.kind = SegmentKind::Active;
+         seg.memory_var = DS->memory_var;
+         seg.offset.push_back(std::make_unique<ConstExpr>(c));
+         seg.data.assign(data.begin() + begin, data.begin() + end);
+         kept += end - begin;
+         ds.push_back(&seg);
+         mod.fields.push_back(std::move(field));
       }
+      fix_bytes += data.size() - kept;
    }
    mod.data_segments = ds;
 }
@@ -126,6 +197,29 @@ void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>&
    mod.data_segments.push_back(&ds);
 }
 
+// Lowers the initial memory size to the pages actually covered by the data
+// segments and the heap base. The allocator grows memory on demand starting at
+// the heap base, so any extra initial page is only instantiation cost.
+// Returns the number of pages removed.
+uint64_t ShrinkInitialMemory( Module& mod, uint32_t heap_ptr ) {
+   if (mod.memories.empty() || mod.num_memory_imports != 0)
+      return 0;
+   uint64_t end = heap_ptr;
+   for ( auto ds : mod.data_segments ) {
+      uint32_t offset;
+      if (GetDataSegmentOffset(*ds, offset))
+         end = std::max<uint64_t>(end, uint64_t(offset) + ds->data.size());
+   }
+   constexpr uint64_t wasm_page_size = 65536;
+   uint64_t pages = std::max<uint64_t>((end + wasm_page_size - 1) / wasm_page_size, 1);
+   auto& limits = mod.memories[0]->page_limits;
+   if (limits.initial <= pages)
+      return 0;
+   uint64_t removed = limits.initial - pages;
+   limits.initial = pages;
+   return removed;
+}
+
 void StripExports(Module& mod) {
    if (s_profile == "eosio") {
       std::vector<Export*> exports;
@@ -141,6 +235,227 @@ void StripExports(Module& mod) {
    }
 }
 
+// Records the byte range of every function body in the original binary so that
+// functions can be compared without walking their IR.
+class FunctionBodyReader : public BinaryReaderNop {
+ public:
+   std::unordered_map<Index, std::string_view> bodies;
+   const uint8_t* data;
+
+   explicit FunctionBodyReader(const uint8_t* data) : data(data) {}
+
+   Result BeginFunctionBody(Index index, Offset size) override {
+      bodies[index] = std::string_view(reinterpret_cast<const char*>(data + state->offset), size);
+      return Result::Ok;
+   }
+};
+
+// Calls `f` with every function reference held by an expression: direct calls,
+// tail calls and ref.func.
+template <typename F>
+class FuncRefVisitor : public ExprVisitor::DelegateNop {
+ public:
+   explicit FuncRefVisitor(F fn) : f(std::forward<F>(fn)) {}
+   Result OnCallExpr(CallExpr* expr) override { f(expr->var); return Result::Ok; }
+   Result OnReturnCallExpr(ReturnCallExpr* expr) override { f(expr->var); return Result::Ok; }
+   Result OnRefFuncExpr(RefFuncExpr* expr) override { f(expr->var); return Result::Ok; }
+ private:
+   F f;
+};
+
+template <typename F>
+void ForEachFuncRef( ExprList& exprs, F&& f ) {
+   FuncRefVisitor<F> delegate(std::forward<F>(f));
+   ExprVisitor visitor(&delegate);
+   visitor.VisitExprList(exprs);
+}
+
+// Calls `f` with every ref.func of an expression, which takes the address of a function.
+template <typename F>
+class RefFuncVisitor : public ExprVisitor::DelegateNop {
+ public:
+   explicit RefFuncVisitor(F fn) : f(std::forward<F>(fn)) {}
+   Result OnRefFuncExpr(RefFuncExpr* expr) override { f(expr->var); return Result::Ok; }
+ private:
+   F f;
+};
+
+template <typename F>
+void ForEachRefFunc( ExprList& exprs, F&& f ) {
+   RefFuncVisitor<F> delegate(std::forward<F>(f));
+   ExprVisitor visitor(&delegate);
+   visitor.VisitExprList(exprs);
+}
+
+// Calls `f` with every function reference held outside of function bodies.
+template <typename F>
+void ForEachModuleFuncRef( Module& mod, F&& f ) {
+   for ( auto exp : mod.exports ) {
+      if (exp->kind == ExternalKind::Func)
+         f(exp->var);
+   }
+   for ( auto start : mod.starts )
+      f(*start);
+   for ( auto seg : mod.elem_segments ) {
+      for ( auto& exprs : seg->elem_exprs )
+         ForEachFuncRef(exprs, f);
+   }
+   for ( auto glob : mod.globals )
+      ForEachFuncRef(glob->init_expr, f);
+}
+
+template <typename F>
+void ForEachFuncRef( Module& mod, F&& f ) {
+   ForEachModuleFuncRef(mod, f);
+   for ( Index i = mod.num_func_imports; i < mod.funcs.size(); i++ )
+      ForEachFuncRef(mod.funcs[i]->exprs, f);
+}
+
+// Redirects every call to a function whose body and signature are byte-for-byte
+// identical to an earlier function. The duplicates become unreachable and are
+// removed by StripUnreachableFunctions. A function whose address is observable,
+// through an export, the table, a global or ref.func, is never merged away:
+// pointers to two distinct functions must keep comparing unequal.
+size_t MergeIdenticalFunctions( Module& mod, const std::vector<uint8_t>& buff ) {
+   FunctionBodyReader reader(buff.data());
+   ReadBinaryOptions options(s_features, nullptr, false, true, false);
+   if (Failed(ReadBinary(buff.data(), buff.size(), &reader, options)))
+      return 0;
+
+   std::vector<bool> address_taken(mod.funcs.size());
+   auto take_address = [&](Var& var) {
+      Index index = mod.GetFuncIndex(var);
+      if (index < address_taken.size())
+         address_taken[index] = true;
+   };
+   ForEachModuleFuncRef(mod, take_address);
+   for ( Index i = mod.num_func_imports; i < mod.funcs.size(); i++ )
+      ForEachRefFunc(mod.funcs[i]->exprs, take_address);
+
+   std::map<std::pair<Index, std::string_view>, Index> canonical;
+   std::vector<Index> replacement(mod.funcs.size());
+   size_t merged = 0;
+   for ( Index i = 0; i < mod.funcs.size(); i++ ) {
+      replacement[i] = i;
+      auto body = reader.bodies.find(i);
+      if (i < mod.num_func_imports || body == reader.bodies.end())
+         continue;
+      auto [it, inserted] = canonical.emplace(std::make_pair(mod.GetFuncTypeIndex(mod.funcs[i]->decl), body->second), i);
+      if (!inserted && !address_taken[i]) {
+         replacement[i] = it->second;
+         merged++;
+      }
+   }
+
+   if (merged) {
+      ForEachFuncRef(mod, [&](Var& var) {
+         var.set_index(replacement[mod.GetFuncIndex(var)]);
+      });
+   }
+   return merged;
+}
+
+// Removes functions and function imports that cannot be reached from an
+// exported function, the start function, the indirect call table or a global
+// initializer, then renumbers every remaining reference.
+size_t StripUnreachableFunctions( Module& mod ) {
+   std::vector<bool> reachable(mod.funcs.size());
+   std::vector<Index> pending;
+   auto mark = [&](Var& var) {
+      Index index = mod.GetFuncIndex(var);
+      if (index < reachable.size() && !reachable[index]) {
+         reachable[index] = true;
+         pending.push_back(index);
+      }
+   };
+   ForEachModuleFuncRef(mod, mark);
+   while (!pending.empty()) {
+      Index index = pending.back();
+      pending.pop_back();
+      if (index >= mod.num_func_imports)
+         ForEachFuncRef(mod.funcs[index]->exprs, mark);
+   }
+
+   std::vector<Index> remap(mod.funcs.size(), kInvalidIndex);
+   std::vector<Func*> funcs;
+   Index num_func_imports = 0;
+   for ( Index i = 0; i < mod.funcs.size(); i++ ) {
+      if (!reachable[i])
+         continue;
+      remap[i] = funcs.size();
+      funcs.push_back(mod.funcs[i]);
+      if (i < mod.num_func_imports)
+         num_func_imports++;
+   }
+   size_t removed = mod.funcs.size() - funcs.size();
+   if (!removed)
+      return 0;
+
+   std::vector<Import*> imports;
+   for ( auto imp : mod.imports ) {
+      if (auto func_imp = dyn_cast<FuncImport>(imp)) {
+         if (std::find(funcs.begin(), funcs.begin() + num_func_imports, &func_imp->func) == funcs.begin() + num_func_imports)
+            continue;
+      }
+      imports.push_back(imp);
+   }
+
+   ForEachFuncRef(mod, [&](Var& var) {
+      var.set_index(remap[mod.GetFuncIndex(var)]);
+   });
+
+   mod.imports = imports;
+   mod.funcs = funcs;
+   mod.num_func_imports = num_func_imports;
+   mod.func_bindings.clear();
+   for ( Index i = 0; i < mod.funcs.size(); i++ ) {
+      if (!mod.funcs[i]->name.empty())
+         mod.func_bindings.emplace(mod.funcs[i]->name, Binding(mod.funcs[i]->loc, i));
+   }
+   return removed;
+}
+
+// Drops data segments whose bytes are already written by another segment at the
+// same address and merges segments that are back to back in memory, so that the
+// module carries fewer segment headers and instantiation performs fewer copies.
+// Segments can only be shared when they initialize the same address; identical
+// contents at different addresses are referenced by absolute address from code.
+size_t CoalesceDataSegments( Module& mod ) {
+   std::vector<std::pair<uint32_t, DataSegment*>> segs;
+   for ( auto ds : mod.data_segments ) {
+      uint32_t offset;
+      if (!GetDataSegmentOffset(*ds, offset) || ds->memory_var.index() != 0)
+         return 0; // passive segments are referenced by index, leave the layout alone
+      segs.emplace_back(offset, ds);
+   }
+   std::stable_sort(segs.begin(), segs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+   std::vector<std::pair<uint32_t, DataSegment*>> result;
+   for ( auto& [offset, ds] : segs ) {
+      if (!result.empty()) {
+         auto& [prev_offset, prev] = result.back();
+         uint64_t prev_end = uint64_t(prev_offset) + prev->data.size();
+         if (offset + ds->data.size() <= prev_end &&
+             std::equal(ds->data.begin(), ds->data.end(), prev->data.begin() + (offset - prev_offset))) {
+            continue;
+         }
+         if (offset < prev_end)
+            return 0; // overlapping writes depend on segment order, leave the layout alone
+         if (offset == prev_end) {
+            prev->data.insert(prev->data.end(), ds->data.begin(), ds->data.end());
+            continue;
+         }
+      }
+      result.emplace_back(offset, ds);
+   }
+
+   size_t removed = mod.data_segments.size() - result.size();
+   mod.data_segments.clear();
+   for ( auto& [offset, ds] : result )
+      mod.data_segments.push_back(ds);
+   return removed;
+}
+
 void WriteBufferToFile(std::string_view filename,
                        const OutputBuffer& buffer) {
   buffer.WriteToFile(filename);
@@ -170,8 +485,22 @@ int ProgramMain(int argc, char** argv) {
     if (Succeeded(result)) {
       size_t fixup = 0;
       StripZeroedData(module, fixup);
-      AddHeapPointerData(module, fixup, file_data, _hds);
       StripExports(module);
+      if (s_optimize) {
+        size_t merged = MergeIdenticalFunctions(module, file_data);
+        size_t removed = StripUnreachableFunctions(module);
+        size_t coalesced = CoalesceDataSegments(module);
+        if (s_verbose) {
+          std::cout << "merged " << merged << " identical functions, removed " << removed
+                    << " unreachable functions and imports, coalesced " << coalesced << " data segments\n";
+        }
+      }
+      AddHeapPointerData(module, fixup, file_data, _hds);
+      uint64_t pages = ShrinkInitialMemory(module, (GetHeapPtr(module, file_data) + 7) & ~7);
+      if (s_verbose) {
+        std::cout << "stripped " << fixup << " zero bytes from data segments, removed "
+                  << pages << " initial memory pages\n";
+      }
      if (Succeeded(result)) {
       MemoryStream stream(s_log_stream.get());
       result =